@@ -0,0 +1,108 @@
+// bcmld round-trip latency benchmark.
+//
+// Against a running daemon: reads the current config of a type once, then
+// reports µs/op for
+//   - sequential bcml_config_get() and bcml_config_set() (one round trip each);
+//   - the same requests pipelined in batches via bcml_client_batch().
+// Set writes back the config that was read, so the device state is unchanged.
+//
+// Usage: bench_bcmld [socket] [type] [iterations] [batch]
+
+#include "bcml_client.h"
+#include "bcml_config.h"
+#include "bcml_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define JSON_MAX (64 * 1024)
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+static void report(const char* name, int ops, double us) {
+    printf("%-22s %9d ops  %8.2f us/op  %10.0f ops/s\n", name, ops, us / ops, ops * 1e6 / us);
+}
+
+int main(int argc, char** argv) {
+    const char* type = argc > 2 ? argv[2] : "wireless";
+    int iterations = argc > 3 ? atoi(argv[3]) : 20000;
+    int batch = argc > 4 ? atoi(argv[4]) : 32;
+    static char json[JSON_MAX];
+    static char out[JSON_MAX];
+
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+    if (argc > 1 && !bcml_client_set_socket_path(argv[1])) {
+        fprintf(stderr, "bad socket path\n");
+        return 1;
+    }
+    if (iterations <= 0 || batch <= 0) {
+        fprintf(stderr, "Usage: %s [socket] [type] [iterations] [batch]\n", argv[0]);
+        return 1;
+    }
+    if (!bcml_config_get(type, json, sizeof(json))) {
+        fprintf(stderr, "initial get failed (is bcmld running?)\n");
+        return 1;
+    }
+    printf("type %s, %zu bytes JSON, batch %d\n", type, strlen(json), batch);
+
+    double t = now_us();
+    for (int i = 0; i < iterations; ++i) {
+        if (!bcml_config_get(type, out, sizeof(out))) {
+            fprintf(stderr, "get failed\n");
+            return 1;
+        }
+    }
+    report("get sequential", iterations, now_us() - t);
+
+    t = now_us();
+    for (int i = 0; i < iterations; ++i) {
+        if (!bcml_config_set(type, json)) {
+            fprintf(stderr, "set failed\n");
+            return 1;
+        }
+    }
+    report("set sequential", iterations, now_us() - t);
+
+    bcml_client_req_t* reqs = calloc((size_t)batch, sizeof(*reqs));
+    char* bufs = malloc((size_t)batch * JSON_MAX);
+    if (!reqs || !bufs)
+        return 1;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        bool set = pass == 1;
+        for (int k = 0; k < batch; ++k) {
+            reqs[k] = (bcml_client_req_t){
+                .type = type,
+                .json = set ? json : NULL,
+                .buffer = set ? NULL : bufs + (size_t)k * JSON_MAX,
+                .buffer_size = set ? 0 : JSON_MAX,
+            };
+        }
+        int ops = 0;
+        t = now_us();
+        while (ops < iterations) {
+            if (!bcml_client_batch(reqs, (size_t)batch)) {
+                fprintf(stderr, "batch failed\n");
+                return 1;
+            }
+            for (int k = 0; k < batch; ++k) {
+                if (!reqs[k].ok) {
+                    fprintf(stderr, "%s failed in batch\n", set ? "set" : "get");
+                    return 1;
+                }
+            }
+            ops += batch;
+        }
+        report(set ? "set pipelined" : "get pipelined", ops, now_us() - t);
+    }
+
+    free(bufs);
+    free(reqs);
+    bcml_client_close();
+    return 0;
+}
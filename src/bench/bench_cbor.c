@@ -0,0 +1,117 @@
+// Binary (CBOR) vs JSON northbound form of the wireless config, per document:
+//   - size of the encoded config;
+//   - set side: validate + parse of JSON vs parse_wireless_cbor() (which validates);
+//   - get side: export + validate of the output, as bcml_config_get()/_get_bin() do.
+// Run at the default size (4 radios, 4 SSIDs) and at the hard limits.
+//
+// Usage: bench_cbor [rounds]
+
+#include "validator_wireless.h"
+#include "parse_wireless_json.h"
+#include "export_wireless_json.h"
+#include "wireless_cbor.h"
+#include "wireless_codec.h"
+#include "bcml_types.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DOC_MAX (64 * 1024)
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void fill(bcml_wireless_cfg_t* cfg) {
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        bcml_wireless_radio_t* r = &cfg->radio[i];
+        r->power = 80;
+        r->channel2g = 6;
+        r->channel5g = 36 + 4 * i;
+        r->bandwidth2g = 20;
+        r->bandwidth5g = 80;
+        r->dfs = true;
+        r->bandsteering = (i & 1) != 0;
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        bcml_wireless_ssid_t* s = &cfg->ssid[i];
+        snprintf(s->ssid, sizeof(s->ssid), "Office-%02d %s", i, i & 1 ? "5G" : "2.4G");
+        snprintf(s->password, sizeof(s->password), "correct horse battery staple %d", i);
+        s->security = 3;
+        s->enable2g = true;
+        s->enable5g = (i & 1) != 0;
+    }
+}
+
+int main(int argc, char** argv) {
+    static char json[DOC_MAX];
+    static uint8_t bin[DOC_MAX];
+    int rounds = argc > 1 ? atoi(argv[1]) : 20000;
+    if (rounds <= 0) {
+        fprintf(stderr, "Usage: %s [rounds]\n", argv[0]);
+        return 1;
+    }
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+
+    static const int sizes[][2] = { { MAX_RADIO_NUM, MAX_SSID_NUM }, { BCML_RADIO_LIMIT, BCML_SSID_LIMIT } };
+    printf("%-10s %-5s %8s %10s %10s\n", "size", "form", "bytes", "set ns", "get ns");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+        bcml_wireless_cfg_t out = BCML_WIRELESS_CFG_INIT;
+        bcml_wireless_limits_t limits = { sizes[s][0], sizes[s][1] };
+        size_t bin_len = 0;
+        if (!bcml_wireless_set_limits(&limits) || !bcml_wireless_cfg_resize(&cfg, sizes[s][0], sizes[s][1]))
+            return 1;
+        fill(&cfg);
+        if (!export_wireless_json(&cfg, json, sizeof(json)) || !export_wireless_cbor(&cfg, bin, sizeof(bin), &bin_len))
+            return 1;
+
+        double t0 = now_ns();
+        for (int r = 0; r < rounds; ++r) {
+            if (!validate_wireless_json(json, NULL) || !parse_wireless_json(json, &out))
+                return 1;
+        }
+        double json_set = (now_ns() - t0) / rounds;
+        if (!wireless_cfg_equal(&cfg, &out))
+            return 1;
+
+        t0 = now_ns();
+        for (int r = 0; r < rounds; ++r) {
+            if (!parse_wireless_cbor(bin, bin_len, &out))
+                return 1;
+        }
+        double bin_set = (now_ns() - t0) / rounds;
+        if (!wireless_cfg_equal(&cfg, &out))
+            return 1;
+
+        // Get: one item changes per round, so the JSON fragment cache does its usual share
+        t0 = now_ns();
+        for (int r = 0; r < rounds; ++r) {
+            cfg.ssid[r % cfg.ssid_count].security = r & 7;
+            if (!export_wireless_json(&cfg, json, sizeof(json)) || !validate_wireless_json(json, NULL))
+                return 1;
+        }
+        double json_get = (now_ns() - t0) / rounds;
+
+        t0 = now_ns();
+        for (int r = 0; r < rounds; ++r) {
+            cfg.ssid[r % cfg.ssid_count].security = r & 7;
+            if (!export_wireless_cbor(&cfg, bin, sizeof(bin), &bin_len) || !validate_wireless_cbor(bin, bin_len))
+                return 1;
+        }
+        double bin_get = (now_ns() - t0) / rounds;
+
+        char label[32];
+        snprintf(label, sizeof(label), "%dr/%ds", sizes[s][0], sizes[s][1]);
+        printf("%-10s %-5s %8zu %10.0f %10.0f\n", label, "json", strlen(json), json_set, json_get);
+        printf("%-10s %-5s %8zu %10.0f %10.0f\n", label, "cbor", bin_len, bin_set, bin_get);
+        bcml_wireless_cfg_free(&cfg);
+        bcml_wireless_cfg_free(&out);
+    }
+    return 0;
+}
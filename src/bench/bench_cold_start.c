@@ -0,0 +1,147 @@
+// Cold-start benchmark: time from process start to the first successful get
+// and set, in fresh processes (each run re-executes this binary), for
+//   - lazy:       no bcml_init(), the first requests pay for all setup;
+//   - init:       bcml_init(0) first, counted in the time to first request;
+//   - init+warm:  bcml_init(BCML_INIT_WARM).
+// The first get is what a service restarted at boot typically does; the set
+// applies the JSON that get returned. "exit" is measured by the parent, from
+// fork() to the child's exit, so it includes exec and dynamic loading.
+//
+// Usage: bench_cold_start [runs] [backend]
+
+#include "bcml_config.h"
+#include "bcml_sb.h"
+#include "bcml_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#define JSON_MAX    (64 * 1024)
+#define CHILD_ARG   "--child"
+
+enum { T_INIT, T_GET, T_SET, T_EXIT, T_COUNT };
+
+static const char* const g_modes[] = { "lazy", "init", "init+warm" };
+static const char* const g_columns[T_COUNT] = { "init", "first get", "first set", "exit" };
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Child: one cold start, times (from main) written to fd as text
+static int child_main(int mode, const char* backend, int fd) {
+    static char json[JSON_MAX];
+    double t0 = now_us();
+    double t[T_COUNT] = { 0 };
+
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+    if (backend && !bcml_sb_select(NULL, backend))
+        return 1;
+    if (mode > 0 && !bcml_init(mode == 2 ? BCML_INIT_WARM : 0))
+        return 1;
+    t[T_INIT] = now_us() - t0;
+    if (!bcml_config_get("wireless", json, sizeof(json)))
+        return 1;
+    t[T_GET] = now_us() - t0;
+    if (!bcml_config_set("wireless", json))
+        return 1;
+    t[T_SET] = now_us() - t0;
+
+    dprintf(fd, "%f %f %f\n", t[T_INIT], t[T_GET], t[T_SET]);
+    return 0;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+static bool run_child(const char* self, int mode, const char* backend, double* t) {
+    int pfd[2];
+    if (pipe(pfd) < 0)
+        return false;
+
+    double t0 = now_us();
+    pid_t pid = fork();
+    if (pid == 0) {
+        char mode_arg[8], fd_arg[16];
+        snprintf(mode_arg, sizeof(mode_arg), "%d", mode);
+        snprintf(fd_arg, sizeof(fd_arg), "%d", pfd[1]);
+        close(pfd[0]);
+        // Backends may print to stdout
+        int null = open("/dev/null", O_WRONLY);
+        if (null >= 0)
+            dup2(null, STDOUT_FILENO);
+        execl(self, self, CHILD_ARG, mode_arg, fd_arg, backend ? backend : "", (char*)NULL);
+        _exit(127);
+    }
+    close(pfd[1]);
+    if (pid < 0) {
+        close(pfd[0]);
+        return false;
+    }
+
+    char line[256] = { 0 };
+    size_t n = 0;
+    ssize_t r;
+    while (n < sizeof(line) - 1 && (r = read(pfd[0], line + n, sizeof(line) - 1 - n)) > 0)
+        n += (size_t)r;
+    close(pfd[0]);
+    int status = 0;
+    waitpid(pid, &status, 0);
+    t[T_EXIT] = now_us() - t0;
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0 &&
+           sscanf(line, "%lf %lf %lf", &t[T_INIT], &t[T_GET], &t[T_SET]) == 3;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 5 && strcmp(argv[1], CHILD_ARG) == 0)
+        return child_main(atoi(argv[2]), argv[4][0] ? argv[4] : NULL, atoi(argv[3]));
+
+    int runs = argc > 1 ? atoi(argv[1]) : 20;
+    const char* backend = argc > 2 ? argv[2] : NULL;
+    if (runs <= 0) {
+        fprintf(stderr, "Usage: %s [runs] [backend]\n", argv[0]);
+        return 1;
+    }
+
+    // Re-exec through /proc so argv[0] need not be a path
+    char self[4096];
+    ssize_t len = readlink("/proc/self/exe", self, sizeof(self) - 1);
+    if (len <= 0)
+        return 1;
+    self[len] = '\0';
+
+    double* samples = malloc(sizeof(double) * (size_t)runs * T_COUNT);
+    if (!samples)
+        return 1;
+    printf("%-10s %12s %12s %12s %12s   (median / max, us)\n", "mode", g_columns[T_INIT], g_columns[T_GET],
+           g_columns[T_SET], g_columns[T_EXIT]);
+    for (int mode = 0; mode < (int)(sizeof(g_modes) / sizeof(g_modes[0])); ++mode) {
+        for (int r = 0; r < runs; ++r) {
+            double t[T_COUNT];
+            if (!run_child(self, mode, backend, t)) {
+                fprintf(stderr, "bench_cold_start: %s run %d failed\n", g_modes[mode], r);
+                free(samples);
+                return 1;
+            }
+            for (int c = 0; c < T_COUNT; ++c)
+                samples[c * runs + r] = t[c];
+        }
+        printf("%-10s", g_modes[mode]);
+        for (int c = 0; c < T_COUNT; ++c) {
+            double* col = samples + c * runs;
+            qsort(col, (size_t)runs, sizeof(double), cmp_double);
+            printf(" %6.0f/%-6.0f", col[runs / 2], col[runs - 1]);
+        }
+        printf("\n");
+    }
+    free(samples);
+    return 0;
+}
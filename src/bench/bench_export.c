@@ -0,0 +1,108 @@
+// Wireless export benchmark: export_wireless_json() (per-item fragment cache)
+// against export_wireless_json_full() (whole config through cJSON), for
+//   - unchanged:  the same config exported again, as a poller sees it;
+//   - 1 ssid:     one SSID edited between exports;
+//   - all:        every radio and SSID edited between exports.
+// Run at the default size (4 radios, 4 SSIDs) and at the hard limits. The
+// outputs of both exporters are compared on every round.
+//
+// Usage: bench_export [rounds]
+
+#include "export_wireless_json.h"
+#include "bcml_types.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define JSON_MAX (64 * 1024)
+
+enum { EDIT_NONE, EDIT_ONE, EDIT_ALL, EDIT_COUNT };
+
+static const char* const g_edits[EDIT_COUNT] = { "unchanged", "1 ssid", "all" };
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void fill(bcml_wireless_cfg_t* cfg) {
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        bcml_wireless_radio_t* r = &cfg->radio[i];
+        r->power = 80;
+        r->channel2g = 6;
+        r->channel5g = 36 + 4 * i;
+        r->bandwidth2g = 20;
+        r->bandwidth5g = 80;
+        r->dfs = true;
+        r->bandsteering = (i & 1) != 0;
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        bcml_wireless_ssid_t* s = &cfg->ssid[i];
+        snprintf(s->ssid, sizeof(s->ssid), "Office-%02d \"%s\"", i, i & 1 ? "5G" : "2.4G");
+        snprintf(s->password, sizeof(s->password), "correct horse battery staple %d", i);
+        s->security = 3;
+        s->enable2g = true;
+        s->enable5g = (i & 1) != 0;
+    }
+}
+
+static void edit(bcml_wireless_cfg_t* cfg, int what, int round) {
+    if (what == EDIT_ONE) {
+        cfg->ssid[round % cfg->ssid_count].security = round & 7;
+    } else if (what == EDIT_ALL) {
+        for (int i = 0; i < cfg->radio_count; ++i)
+            cfg->radio[i].power = round % 101;
+        for (int i = 0; i < cfg->ssid_count; ++i)
+            cfg->ssid[i].security = round & 7;
+    }
+}
+
+// ns per export; checks every output against the full exporter
+static double run(bcml_wireless_cfg_t* cfg, int what, int rounds, bool cached) {
+    static char out[JSON_MAX];
+    static char ref[JSON_MAX];
+    double total = 0;
+    for (int r = 0; r < rounds; ++r) {
+        edit(cfg, what, r);
+        double t0 = now_ns();
+        bool ok = cached ? export_wireless_json(cfg, out, sizeof(out)) : export_wireless_json_full(cfg, out, sizeof(out));
+        total += now_ns() - t0;
+        if (!ok || !export_wireless_json_full(cfg, ref, sizeof(ref)) || strcmp(out, ref) != 0) {
+            fprintf(stderr, "bench_export: output mismatch (%s, round %d)\n", g_edits[what], r);
+            exit(1);
+        }
+    }
+    return total / rounds;
+}
+
+int main(int argc, char** argv) {
+    int rounds = argc > 1 ? atoi(argv[1]) : 20000;
+    if (rounds <= 0) {
+        fprintf(stderr, "Usage: %s [rounds]\n", argv[0]);
+        return 1;
+    }
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+
+    static const int sizes[][2] = { { MAX_RADIO_NUM, MAX_SSID_NUM }, { BCML_RADIO_LIMIT, BCML_SSID_LIMIT } };
+    printf("%-12s %-10s %12s %12s %8s\n", "size", "edit", "full ns", "cached ns", "speedup");
+    for (size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++s) {
+        bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+        if (!bcml_wireless_cfg_resize(&cfg, sizes[s][0], sizes[s][1]))
+            return 1;
+        fill(&cfg);
+        char label[32];
+        snprintf(label, sizeof(label), "%dr/%ds", sizes[s][0], sizes[s][1]);
+        for (int what = 0; what < EDIT_COUNT; ++what) {
+            double full = run(&cfg, what, rounds, false);
+            double cached = run(&cfg, what, rounds, true);
+            printf("%-12s %-10s %12.0f %12.0f %7.1fx\n", label, g_edits[what], full, cached, full / cached);
+        }
+        bcml_wireless_cfg_free(&cfg);
+    }
+    export_wireless_json_release();
+    return 0;
+}
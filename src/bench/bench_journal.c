@@ -0,0 +1,146 @@
+// Apply journal benchmark.
+//
+// Against an in-process backend that accepts everything, reports
+//   - bcml_config_set() without and with the journal (the difference is the
+//     delta encoding plus one durable append);
+//   - raw durable appends from several threads, where group commit lets one
+//     fsync cover many records;
+//   - bcml_config_rollback() for every distance within a checkpoint interval,
+//     i.e. replaying one checkpoint plus up to BCML_JOURNAL_CHECKPOINT_EVERY-1 deltas.
+//
+// Usage: bench_journal [journal_path] [sets] [threads]
+
+#include "bcml_config.h"
+#include "bcml_journal.h"
+#include "bcml_sb.h"
+#include "bcml_log.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define JSON_MAX    (16 * 1024)
+#define BENCH_SSIDS 4
+
+static bool null_set(const sb_ops_t* self, const bcml_wireless_cfg_t* cfg) {
+    (void)self;
+    (void)cfg;
+    return true;
+}
+
+static const sb_ops_t g_null_ops = { .name = "bench-null", .set_wireless_config = null_set };
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+// Config k: mostly the same, one SSID and the radio power change per step
+static void make_json(char* out, size_t size, int k) {
+    size_t n = (size_t)snprintf(out, size,
+        "{\"wireless\":{\"radio\":[{\"power\":%d,\"channel2g\":6,\"channel5g\":36,\"bandwidth2g\":20,"
+        "\"bandwidth5g\":80,\"dfs\":true,\"atf\":false,\"bandsteering\":false,\"zerowait\":false}],\"ssid\":[",
+        k % 101);
+    for (int i = 0; i < BENCH_SSIDS; ++i) {
+        n += (size_t)snprintf(out + n, size - n,
+            "%s{\"ssid\":\"net-%d-%d\",\"hide\":false,\"security\":3,\"password\":\"secret-%d\","
+            "\"password_onscreen\":false,\"enable2g\":true,\"enable5g\":true,\"isolation\":false,\"hopping\":false}",
+            i ? "," : "", i, i == k % BENCH_SSIDS ? k : 0, i);
+    }
+    snprintf(out + n, size - n, "]}}");
+}
+
+static double run_sets(int from, int count) {
+    static char json[JSON_MAX];
+    double t = 0;
+    for (int k = from; k < from + count; ++k) {
+        make_json(json, sizeof(json), k);
+        double t0 = now_us();
+        if (!bcml_config_set("wireless", json)) {
+            fprintf(stderr, "bench_journal: set %d failed\n", k);
+            exit(1);
+        }
+        t += now_us() - t0;
+    }
+    return t;
+}
+
+typedef struct {
+    int appends;
+} appender_t;
+
+static void* appender_main(void* arg) {
+    appender_t* a = arg;
+    uint8_t rec[128];
+    memset(rec, 0x5a, sizeof(rec));
+    for (int i = 0; i < a->appends; ++i) {
+        // A tag nobody replays, so these records never disturb the wireless history
+        if (!bcml_journal_append(200, true, rec, sizeof(rec))) {
+            fprintf(stderr, "bench_journal: append failed\n");
+            exit(1);
+        }
+    }
+    return NULL;
+}
+
+int main(int argc, char** argv) {
+    const char* path = argc > 1 ? argv[1] : "bench_journal.bin";
+    int sets = argc > 2 ? atoi(argv[2]) : 2000;
+    int threads = argc > 3 ? atoi(argv[3]) : 8;
+
+    if (sets <= 0 || threads <= 0) {
+        fprintf(stderr, "Usage: %s [journal_path] [sets] [threads]\n", argv[0]);
+        return 1;
+    }
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+    if (!bcml_sb_register(&g_null_ops) || !bcml_sb_select("wireless", "bench-null"))
+        return 1;
+    unlink(path);
+
+    double t = run_sets(0, sets);
+    printf("set, no journal      %8.2f us/op\n", t / sets);
+
+    if (!bcml_journal_open(path, (unsigned int)sets))
+        return 1;
+    t = run_sets(sets, sets);
+    printf("set, journaled       %8.2f us/op  (durable)\n", t / sets);
+
+    int per_thread = sets / threads ? sets / threads : 1;
+    pthread_t tids[threads];
+    appender_t apps[threads];
+    double t0 = now_us();
+    for (int i = 0; i < threads; ++i) {
+        apps[i].appends = per_thread;
+        pthread_create(&tids[i], NULL, appender_main, &apps[i]);
+    }
+    for (int i = 0; i < threads; ++i)
+        pthread_join(tids[i], NULL);
+    t = now_us() - t0;
+    printf("append x%-2d threads   %8.2f us/op  %10.0f records/s\n", threads,
+           t / (per_thread * threads), per_thread * threads * 1e6 / t);
+
+    double worst = 0, sum = 0;
+    for (int g = 0; g < BCML_JOURNAL_CHECKPOINT_EVERY; ++g) {
+        // Undo the previous rollback first so every distance is measured from the same history
+        t0 = now_us();
+        if (!bcml_config_rollback("wireless", (unsigned int)g)) {
+            fprintf(stderr, "bench_journal: rollback %d failed\n", g);
+            return 1;
+        }
+        t = now_us() - t0;
+        sum += t;
+        if (t > worst)
+            worst = t;
+        if (!bcml_config_rollback("wireless", 1))
+            return 1;
+    }
+    printf("rollback 0..%d        %8.2f us avg  %8.2f us worst\n", BCML_JOURNAL_CHECKPOINT_EVERY - 1,
+           sum / BCML_JOURNAL_CHECKPOINT_EVERY, worst);
+
+    bcml_journal_close();
+    unlink(path);
+    return 0;
+}
@@ -0,0 +1,173 @@
+// Wireless JSON ingestion benchmark.
+//
+// Generates a corpus of realistic northbound wireless documents (1-4 radios and
+// SSIDs, UTF-8 names, escapes, compact and pretty-printed), then reports:
+//   - stage-1 structural scan throughput per implementation (scalar/SSE2/AVX2),
+//     after checking every implementation yields the same index;
+//   - validate + parse throughput, cJSON reference vs the scan path.
+//
+// Usage: bench_json_scan [documents] [rounds]
+
+#include "json_scan.h"
+#include "validator_wireless.h"
+#include "parse_wireless_json.h"
+#include "bcml_types.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define DOC_MAX 4096
+
+static const char* const ssid_names[] = {
+    "Home", "Office-5G", "Caf\xc3\xa9 Guest", "\xe5\xae\xa2\xe5\xbb\xb3 WiFi", "IoT \\\"devices\\\"",
+    "Lab\\u00e9", "Gu\xc3\xa9st-\xf0\x9f\x93\xb6", "backhaul_mesh_01",
+};
+
+static const char* const passwords[] = {
+    "12345678", "correct horse battery staple", "p\\\\ss\\/word", "\xc3\xbc\xc3\xb6\xc3\xa4-secret", "",
+};
+
+static unsigned int rng_state = 12345;
+
+static unsigned int rng(void) {
+    rng_state = rng_state * 1103515245u + 12345u;
+    return rng_state >> 8;
+}
+
+static const char* tf(void) {
+    return (rng() & 1) ? "true" : "false";
+}
+
+// One document; pretty selects newline/indent formatting
+static size_t gen_doc(char* out, size_t size, bool pretty) {
+    const char* nl = pretty ? "\n" : "";
+    const char* in1 = pretty ? "  " : "";
+    const char* in2 = pretty ? "    " : "";
+    const char* sp = pretty ? " " : "";
+    int radios = 1 + (int)(rng() % MAX_RADIO_NUM);
+    int ssids = 1 + (int)(rng() % MAX_SSID_NUM);
+    size_t n = 0;
+
+    n += (size_t)snprintf(out + n, size - n, "{%s%s\"wireless\":%s{%s%s\"radio\":%s[", nl, in1, sp, nl, in2, sp);
+    for (int i = 0; i < radios; ++i) {
+        n += (size_t)snprintf(out + n, size - n,
+            "%s{\"power\":%s%u,\"channel2g\":%s%u,\"channel5g\":%s%u,\"bandwidth2g\":%s%u,\"bandwidth5g\":%s%u,"
+            "\"dfs\":%s%s,\"atf\":%s%s,\"bandsteering\":%s%s,\"zerowait\":%s%s}",
+            i ? "," : "", sp, rng() % 101, sp, 1 + rng() % 13, sp, 36 + 4 * (rng() % 8), sp, 20u << (rng() % 2),
+            sp, 20u << (rng() % 3), sp, tf(), sp, tf(), sp, tf(), sp, tf());
+    }
+    n += (size_t)snprintf(out + n, size - n, "],%s%s\"ssid\":%s[", nl, in2, sp);
+    for (int i = 0; i < ssids; ++i) {
+        n += (size_t)snprintf(out + n, size - n,
+            "%s%s{\"ssid\":%s\"%s\",\"hide\":%s%s,\"security\":%s%u,\"password\":%s\"%s\",\"password_onscreen\":%s%s,"
+            "\"enable2g\":%s%s,\"enable5g\":%s%s,\"isolation\":%s%s,\"hopping\":%s%s}",
+            i ? "," : "", pretty ? "\n      " : "",
+            sp, ssid_names[rng() % (sizeof(ssid_names) / sizeof(ssid_names[0]))], sp, tf(), sp, rng() % 5,
+            sp, passwords[rng() % (sizeof(passwords) / sizeof(passwords[0]))], sp, tf(),
+            sp, tf(), sp, tf(), sp, tf(), sp, tf());
+    }
+    n += (size_t)snprintf(out + n, size - n, "]%s%s}%s}", nl, in1, nl);
+    return n;
+}
+
+static double now_s(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int main(int argc, char** argv) {
+    int docs = (argc > 1) ? atoi(argv[1]) : 2000;
+    int rounds = (argc > 2) ? atoi(argv[2]) : 50;
+    if (docs <= 0 || rounds <= 0)
+        return 1;
+
+    bcml_set_log_level(LOG_LEVEL_NONE);
+
+    char** corpus = calloc((size_t)docs, sizeof(char*));
+    size_t* lens = calloc((size_t)docs, sizeof(size_t));
+    size_t total = 0;
+    for (int i = 0; i < docs; ++i) {
+        corpus[i] = malloc(DOC_MAX);
+        lens[i] = gen_doc(corpus[i], DOC_MAX, (i % 4) == 0);
+        total += lens[i];
+        if (!validate_wireless_json_cjson(corpus[i], NULL) || !validate_wireless_json_scan(corpus[i], NULL)) {
+            fprintf(stderr, "bench_json_scan: generated document %d rejected:\n%s\n", i, corpus[i]);
+            return 1;
+        }
+    }
+    printf("corpus: %d documents, %zu bytes (avg %zu), best impl=%s\n",
+           docs, total, total / (size_t)docs, json_scan_impl_name(json_scan_best_impl()));
+
+    // Every implementation must produce the same index as scalar
+    const json_scan_impl_t impls[] = { JSON_SCAN_SCALAR, JSON_SCAN_SSE2, JSON_SCAN_AVX2 };
+    const size_t num_impls = sizeof(impls) / sizeof(impls[0]);
+    json_scan_t ref, scan;
+    json_scan_init(&ref);
+    json_scan_init(&scan);
+    for (int i = 0; i < docs; ++i) {
+        bool ref_ok = json_scan(&ref, corpus[i], lens[i], JSON_SCAN_SCALAR);
+        for (size_t k = 1; k < num_impls; ++k) {
+            bool ok = json_scan(&scan, corpus[i], lens[i], impls[k]);
+            if (ok != ref_ok || scan.count != ref.count ||
+                memcmp(scan.pos, ref.pos, ref.count * sizeof(ref.pos[0])) != 0) {
+                fprintf(stderr, "bench_json_scan: %s index differs from scalar on document %d\n",
+                        json_scan_impl_name(impls[k]), i);
+                return 1;
+            }
+        }
+    }
+
+    // Stage 1 only
+    for (size_t k = 0; k < num_impls; ++k) {
+        size_t tokens = 0;
+        double start = now_s();
+        for (int r = 0; r < rounds; ++r) {
+            for (int i = 0; i < docs; ++i) {
+                json_scan(&scan, corpus[i], lens[i], impls[k]);
+                tokens += scan.count;
+            }
+        }
+        double secs = now_s() - start;
+        printf("stage1 %-6s %7.3f GB/s  (%.1f ns/doc, %zu tokens)\n", json_scan_impl_name(impls[k]),
+               (double)total * rounds / secs / 1e9, secs * 1e9 / ((double)docs * rounds), tokens / (size_t)rounds);
+    }
+    json_scan_free(&ref);
+    json_scan_free(&scan);
+
+    // Full ingestion as done by bcml_config_set(): validate then parse
+    struct {
+        const char* name;
+        bool (*validate)(const char*, const char*);
+        bool (*parse)(const char*, void*);
+    } pipelines[] = {
+        { "cjson", validate_wireless_json_cjson, parse_wireless_json_cjson },
+        { "scan",  validate_wireless_json_scan,  parse_wireless_json_scan },
+    };
+    bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+    for (size_t k = 0; k < sizeof(pipelines) / sizeof(pipelines[0]); ++k) {
+        int pipe_rounds = rounds / 5 ? rounds / 5 : 1;
+        double start = now_s();
+        for (int r = 0; r < pipe_rounds; ++r) {
+            for (int i = 0; i < docs; ++i) {
+                if (!pipelines[k].validate(corpus[i], NULL) || !pipelines[k].parse(corpus[i], &cfg)) {
+                    fprintf(stderr, "bench_json_scan: %s failed on document %d\n", pipelines[k].name, i);
+                    return 1;
+                }
+            }
+        }
+        double secs = now_s() - start;
+        printf("validate+parse %-5s %7.3f GB/s  (%.2f us/doc)\n", pipelines[k].name,
+               (double)total * pipe_rounds / secs / 1e9, secs * 1e6 / ((double)docs * pipe_rounds));
+    }
+
+    bcml_wireless_cfg_free(&cfg);
+    for (int i = 0; i < docs; ++i)
+        free(corpus[i]);
+    free(corpus);
+    free(lens);
+    return 0;
+}
@@ -0,0 +1,164 @@
+// Loopback benchmark for rest_client_request().
+//
+// Built twice from this file: bench_rest_client_curl links the libcurl transport
+// (TCP 127.0.0.1), bench_rest_client_uds links the Unix domain socket transport.
+// Both talk to the same in-process keep-alive HTTP/1.1 server thread, so the
+// difference is purely client side (connection setup, URL parsing, framing).
+//
+// Usage: bench_rest_client_xxx [iterations]
+
+#define _GNU_SOURCE
+#include "rest_client.h"
+#include "bcml_log.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <pthread.h>
+#include <poll.h>
+#include <unistd.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <time.h>
+
+#define BENCH_TCP_PORT  15566
+#define BENCH_UDS_PATH  "/tmp/bcml_bench_rest.sock"
+#define BENCH_URL       "http://127.0.0.1:15566/v1/wlan/setting"
+
+static const char bench_body[] =
+    "{\"radio\":[{\"power\":80,\"channel2g\":6,\"channel5g\":36,\"bandwidth2g\":20,\"bandwidth5g\":80,"
+    "\"dfs\":true,\"atf\":false,\"bandsteering\":true,\"zerowait\":false}],"
+    "\"ssid\":[{\"ssid\":\"bench\",\"hide\":false,\"security\":3,\"password\":\"12345678\","
+    "\"password-onscreen\":false,\"enable2g\":true,\"enable5g\":true,\"isolation\":false,\"hopping\":false}]}";
+
+// Serve requests on one connection until the peer closes it.
+static void serve_conn(int fd) {
+    char buf[8192];
+    size_t len = 0;
+    for (;;) {
+        ssize_t n = recv(fd, buf + len, sizeof(buf) - len - 1, 0);
+        if (n <= 0)
+            return;
+        len += (size_t)n;
+        buf[len] = '\0';
+        char *end;
+        while ((end = strstr(buf, "\r\n\r\n")) != NULL) {
+            size_t hdr_len = (size_t)(end - buf) + 4;
+            size_t body_len = 0;
+            char *cl = strcasestr(buf, "Content-Length:");
+            if (cl && cl < end)
+                body_len = strtoul(cl + 15, NULL, 10);
+            if (len < hdr_len + body_len)
+                break;
+            char resp[1024];
+            int rlen = snprintf(resp, sizeof(resp),
+                                "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\n"
+                                "Content-Length: %zu\r\n\r\n%s", sizeof(bench_body) - 1, bench_body);
+            if (send(fd, resp, (size_t)rlen, MSG_NOSIGNAL) != rlen)
+                return;
+            memmove(buf, buf + hdr_len + body_len, len - hdr_len - body_len);
+            len -= hdr_len + body_len;
+            buf[len] = '\0';
+        }
+    }
+}
+
+static void* server_thread(void* arg) {
+    int* lfds = (int*)arg;
+    struct pollfd pfd[2] = { { lfds[0], POLLIN, 0 }, { lfds[1], POLLIN, 0 } };
+    for (;;) {
+        if (poll(pfd, 2, -1) <= 0)
+            continue;
+        for (int i = 0; i < 2; ++i) {
+            if (!(pfd[i].revents & POLLIN))
+                continue;
+            int fd = accept(pfd[i].fd, NULL, NULL);
+            if (fd < 0)
+                continue;
+            serve_conn(fd);
+            close(fd);
+        }
+    }
+    return NULL;
+}
+
+static int listen_tcp(void) {
+    int one = 1;
+    struct sockaddr_in addr = { .sin_family = AF_INET, .sin_port = htons(BENCH_TCP_PORT) };
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        perror("tcp listen");
+        exit(1);
+    }
+    return fd;
+}
+
+static int listen_uds(void) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", BENCH_UDS_PATH);
+    unlink(BENCH_UDS_PATH);
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 16) < 0) {
+        perror("uds listen");
+        exit(1);
+    }
+    return fd;
+}
+
+static double now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e6 + ts.tv_nsec / 1e3;
+}
+
+int main(int argc, char** argv) {
+    int iterations = (argc > 1) ? atoi(argv[1]) : 10000;
+    static int lfds[2];
+    pthread_t tid;
+    char response[4096];
+
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+    lfds[0] = listen_tcp();
+    lfds[1] = listen_uds();
+    pthread_create(&tid, NULL, server_thread, lfds);
+
+#ifdef BENCH_TRANSPORT_UDS
+    const char* transport = "uds";
+    rest_client_uds_set_path(BENCH_UDS_PATH);
+#else
+    const char* transport = "curl";
+#endif
+
+    // Warm-up (connection setup, lazy global init)
+    if (!rest_client_request(REST_GET, BENCH_URL, NULL, response, sizeof(response))) {
+        fprintf(stderr, "bench_rest_client: warm-up request failed\n");
+        return 1;
+    }
+
+    double get_start = now_us();
+    for (int i = 0; i < iterations; ++i) {
+        if (!rest_client_request(REST_GET, BENCH_URL, NULL, response, sizeof(response))) {
+            fprintf(stderr, "bench_rest_client: GET %d failed\n", i);
+            return 1;
+        }
+    }
+    double get_us = (now_us() - get_start) / iterations;
+
+    double patch_start = now_us();
+    for (int i = 0; i < iterations; ++i) {
+        if (!rest_client_request(REST_PATCH, BENCH_URL, bench_body, NULL, 0)) {
+            fprintf(stderr, "bench_rest_client: PATCH %d failed\n", i);
+            return 1;
+        }
+    }
+    double patch_us = (now_us() - patch_start) / iterations;
+
+    printf("transport=%s iterations=%d GET=%.2f us/req PATCH=%.2f us/req\n",
+           transport, iterations, get_us, patch_us);
+    unlink(BENCH_UDS_PATH);
+    return 0;
+}
@@ -0,0 +1,153 @@
+// Shared-memory snapshot benchmark.
+//
+// Reader threads copy the wireless snapshot in a loop, first with the
+// publisher idle, then while a publisher thread rewrites it back to back
+// (the worst case; real publishers write once per set/get). Every copy is
+// checked for tearing: the publisher stamps one counter into every field.
+//
+// Usage: bench_snapshot [readers] [seconds] [ssids]
+
+#include "bcml_snapshot.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define SHM_NAME "/bcml-bench-snapshot"
+
+static volatile int g_stop;
+static volatile int g_torn;
+static int g_ssids = MAX_SSID_NUM;
+
+typedef struct {
+    bcml_snapshot_t* snap;
+    unsigned long reads;
+    unsigned long failed;
+} reader_t;
+
+static void stamp(bcml_wireless_cfg_t* cfg, int k) {
+    bcml_wireless_cfg_resize(cfg, MAX_RADIO_NUM, g_ssids);
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        cfg->radio[i].power = k;
+        cfg->radio[i].channel5g = k;
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        memset(cfg->ssid[i].ssid, 'a' + k % 26, BCML_SSID_MAX_LEN);
+        cfg->ssid[i].security = k;
+    }
+}
+
+// Cheap enough not to dominate the read it checks
+static bool consistent(const bcml_wireless_cfg_t* cfg) {
+    if (cfg->radio_count != MAX_RADIO_NUM || cfg->ssid_count != g_ssids)
+        return false;
+    int k = cfg->radio[0].power;
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        if (cfg->radio[i].power != k || cfg->radio[i].channel5g != k)
+            return false;
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        const char* s = cfg->ssid[i].ssid;
+        if (cfg->ssid[i].security != k || s[0] != 'a' + k % 26 || s[BCML_SSID_MAX_LEN - 1] != s[0])
+            return false;
+    }
+    return true;
+}
+
+static void* reader_main(void* arg) {
+    reader_t* r = arg;
+    bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+    while (!g_stop) {
+        if (!bcml_snapshot_read_wireless(r->snap, &cfg, NULL)) {
+            ++r->failed;
+            continue;
+        }
+        if (!consistent(&cfg))
+            g_torn = 1;
+        ++r->reads;
+    }
+    bcml_wireless_cfg_free(&cfg);
+    return NULL;
+}
+
+static void* writer_main(void* arg) {
+    unsigned long* writes = arg;
+    bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+    for (int k = 1; !g_stop; ++k) {
+        stamp(&cfg, k);
+        bcml_snapshot_publish_wireless(&cfg);
+        ++*writes;
+    }
+    bcml_wireless_cfg_free(&cfg);
+    return NULL;
+}
+
+static void run(const char* name, int nreaders, int seconds, bool writer) {
+    pthread_t wt, rt[nreaders];
+    reader_t readers[nreaders];
+    unsigned long writes = 0;
+
+    g_stop = 0;
+    memset(readers, 0, sizeof(readers));
+    for (int i = 0; i < nreaders; ++i) {
+        readers[i].snap = bcml_snapshot_open(SHM_NAME);
+        if (!readers[i].snap) {
+            fprintf(stderr, "cannot open snapshot\n");
+            exit(1);
+        }
+        pthread_create(&rt[i], NULL, reader_main, &readers[i]);
+    }
+    if (writer)
+        pthread_create(&wt, NULL, writer_main, &writes);
+
+    sleep((unsigned int)seconds);
+    g_stop = 1;
+    if (writer)
+        pthread_join(wt, NULL);
+
+    unsigned long reads = 0, failed = 0;
+    for (int i = 0; i < nreaders; ++i) {
+        pthread_join(rt[i], NULL);
+        reads += readers[i].reads;
+        failed += readers[i].failed;
+        bcml_snapshot_close(readers[i].snap);
+    }
+    double per_reader = (double)reads / nreaders / seconds;
+    printf("%-10s readers=%d  %12.0f reads/s/reader  %8.1f ns/read  failed=%lu  writes/s=%.0f\n",
+           name, nreaders, per_reader, 1e9 / per_reader, failed, (double)writes / seconds);
+}
+
+int main(int argc, char** argv) {
+    int nreaders = argc > 1 ? atoi(argv[1]) : 2;
+    int seconds = argc > 2 ? atoi(argv[2]) : 2;
+    bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+
+    if (argc > 3)
+        g_ssids = atoi(argv[3]);
+    if (nreaders <= 0 || seconds <= 0 || g_ssids < 1 || g_ssids > BCML_SSID_LIMIT) {
+        fprintf(stderr, "Usage: %s [readers] [seconds] [ssids]\n", argv[0]);
+        return 1;
+    }
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+    if (!bcml_snapshot_publisher_open(SHM_NAME, 0))
+        return 1;
+    stamp(&cfg, 0);
+    bcml_snapshot_publish_wireless(&cfg);
+
+    printf("snapshot %d radios, %d ssids, %zu bytes\n", cfg.radio_count, cfg.ssid_count,
+           cfg.radio_count * sizeof(*cfg.radio) + cfg.ssid_count * sizeof(*cfg.ssid));
+    bcml_wireless_cfg_free(&cfg);
+    run("idle", nreaders, seconds, false);
+    run("contended", nreaders, seconds, true);
+
+    bcml_snapshot_publisher_close(true);
+    if (g_torn) {
+        fprintf(stderr, "FAIL: torn snapshot observed\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,172 @@
+// Fleet store benchmark: N devices built from a few profiles, most identical
+// to theirs, some with one or two SSIDs changed (per-device passwords), held as
+//   - full:     one bcml_wireless_cfg_t per device (bcml_wireless_cfg_copy());
+//   - compact:  one bcml_wireless_compact_t per device;
+//   - store:    bcml_wireless_store_t (interned items and configs).
+// Reports heap bytes per device, and the time of the fleet queries: which
+// devices differ from a profile (field compare of full copies, hash/byte
+// compare of compact ones, id compare in the store) and grouping identical
+// devices. Every device's config is read back from the store and compared,
+// and the three differ queries must agree.
+//
+// Usage: bench_store [devices] [profiles]
+
+#include "bcml_store.h"
+#include "bcml_compact.h"
+#include "wireless_codec.h"
+#include "bcml_types.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void fill_profile(bcml_wireless_cfg_t* cfg, int p) {
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        bcml_wireless_radio_t* r = &cfg->radio[i];
+        r->power = 60 + 10 * (p % 4);
+        r->channel2g = 1 + 5 * (p % 3);
+        r->channel5g = 36 + 4 * i;
+        r->bandwidth2g = 20;
+        r->bandwidth5g = 80;
+        r->dfs = true;
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        bcml_wireless_ssid_t* s = &cfg->ssid[i];
+        snprintf(s->ssid, sizeof(s->ssid), "Site%02d-%s", p, i ? "Guest" : "Corp");
+        snprintf(s->password, sizeof(s->password), "profile %d secret %d", p, i);
+        s->security = 3;
+        s->enable2g = true;
+        s->enable5g = true;
+    }
+}
+
+// 70% as the profile, 25% one SSID changed, 5% two
+static void make_device(bcml_wireless_cfg_t* cfg, const bcml_wireless_cfg_t* profile, unsigned d) {
+    bcml_wireless_cfg_copy(cfg, profile);
+    unsigned roll = (d * 2654435761u) % 100;
+    int changed = roll < 70 ? 0 : roll < 95 ? 1 : 2;
+    for (int k = 0; k < changed && k < cfg->ssid_count; ++k)
+        snprintf(cfg->ssid[k].password, sizeof(cfg->ssid[k].password), "device %u key %d", d, k);
+}
+
+int main(int argc, char** argv) {
+    unsigned n = argc > 1 ? (unsigned)atoi(argv[1]) : 10000;
+    int nprof = argc > 2 ? atoi(argv[2]) : 8;
+    if (n == 0 || nprof <= 0) {
+        fprintf(stderr, "Usage: %s [devices] [profiles]\n", argv[0]);
+        return 1;
+    }
+    bcml_set_log_level(LOG_LEVEL_ERROR);
+
+    bcml_wireless_cfg_t* profiles = calloc((size_t)nprof, sizeof(*profiles));
+    bcml_wireless_cfg_t* full = calloc(n, sizeof(*full));
+    bcml_wireless_compact_t** compact = calloc(n, sizeof(*compact));
+    unsigned* out = malloc(n * sizeof(*out));
+    bcml_wireless_diff_t* diffs = malloc(n * sizeof(*diffs));
+    bcml_wireless_store_t* store = bcml_wireless_store_new();
+    if (!profiles || !full || !compact || !out || !diffs || !store)
+        return 1;
+    for (int p = 0; p < nprof; ++p) {
+        if (!bcml_wireless_cfg_resize(&profiles[p], MAX_RADIO_NUM, MAX_SSID_NUM))
+            return 1;
+        fill_profile(&profiles[p], p);
+    }
+
+    size_t full_bytes = 0, compact_bytes = 0;
+    double t_put = 0;
+    for (unsigned d = 0; d < n; ++d) {
+        make_device(&full[d], &profiles[d % (unsigned)nprof], d);
+        full_bytes += sizeof(full[d]) + full[d].arena_size;
+        compact[d] = bcml_wireless_compact_encode(&full[d]);
+        if (!compact[d])
+            return 1;
+        compact_bytes += sizeof(compact[d]) + bcml_wireless_compact_size(compact[d]);
+        double t0 = now_ns();
+        if (!bcml_wireless_store_put(store, d, &full[d]))
+            return 1;
+        t_put += now_ns() - t0;
+    }
+    bcml_wireless_store_stats_t st;
+    bcml_wireless_store_stats(store, &st);
+
+    // Read-back check
+    bcml_wireless_cfg_t back = BCML_WIRELESS_CFG_INIT;
+    for (unsigned d = 0; d < n; ++d) {
+        if (!bcml_wireless_store_get(store, d, &back) || !wireless_cfg_equal(&back, &full[d]) ||
+            bcml_wireless_store_hash(store, d) != bcml_wireless_cfg_hash(&full[d])) {
+            fprintf(stderr, "bench_store: device %u read back wrong\n", d);
+            return 1;
+        }
+    }
+
+    printf("%u devices, %d profiles: %zu configs, %zu radios, %zu ssids interned\n", n, nprof, st.configs,
+           st.radios, st.ssids);
+    printf("%-10s %14s %12s\n", "form", "bytes", "per device");
+    printf("%-10s %14zu %12.1f\n", "full", full_bytes, (double)full_bytes / n);
+    printf("%-10s %14zu %12.1f\n", "compact", compact_bytes, (double)compact_bytes / n);
+    printf("%-10s %14zu %12.1f\n", "store", st.bytes, (double)st.bytes / n);
+    printf("store put: %.0f ns/device\n\n", t_put / n);
+
+    // Which devices differ from profile 0, each way; counts must agree
+    const int reps = 20;
+    size_t count[4] = { 0, 0, 0, 0 };
+    double t[4] = { 0, 0, 0, 0 };
+    bcml_wireless_compact_t* pc = bcml_wireless_compact_encode(&profiles[0]);
+    for (int r = 0; r < reps; ++r) {
+        double t0 = now_ns();
+        count[0] = 0;
+        for (unsigned d = 0; d < n; ++d)
+            count[0] += !wireless_cfg_equal(&full[d], &profiles[0]);
+        double t1 = now_ns();
+        count[1] = 0;
+        for (unsigned d = 0; d < n; ++d)
+            count[1] += !bcml_wireless_compact_equal(compact[d], pc);
+        double t2 = now_ns();
+        count[2] = bcml_wireless_store_differ(store, &profiles[0], out, NULL, n);
+        double t3 = now_ns();
+        count[3] = bcml_wireless_store_differ(store, &profiles[0], out, diffs, n);
+        double t4 = now_ns();
+        t[0] += t1 - t0;
+        t[1] += t2 - t1;
+        t[2] += t3 - t2;
+        t[3] += t4 - t3;
+    }
+    if (count[0] != count[1] || count[0] != count[2] || count[0] != count[3]) {
+        fprintf(stderr, "bench_store: differ counts disagree (%zu/%zu/%zu)\n", count[0], count[1], count[2]);
+        return 1;
+    }
+    printf("differ from profile 0 (%zu devices): full %.0f us, compact %.0f us, store %.0f us (%.0f us with diffs)\n",
+           count[2], t[0] / reps / 1e3, t[1] / reps / 1e3, t[2] / reps / 1e3, t[3] / reps / 1e3);
+
+    bcml_wireless_group_t top[4];
+    double t0 = now_ns();
+    size_t ngroups = bcml_wireless_store_groups(store, top, 4);
+    printf("groups: %zu in %.0f us, largest:", ngroups, (now_ns() - t0) / 1e3);
+    for (size_t i = 0; i < ngroups && i < 4; ++i)
+        printf(" %u", top[i].devices);
+    printf("\n");
+
+    bcml_wireless_compact_free(pc);
+    bcml_wireless_cfg_free(&back);
+    for (unsigned d = 0; d < n; ++d) {
+        bcml_wireless_cfg_free(&full[d]);
+        bcml_wireless_compact_free(compact[d]);
+    }
+    for (int p = 0; p < nprof; ++p)
+        bcml_wireless_cfg_free(&profiles[p]);
+    bcml_wireless_store_free(store);
+    free(profiles);
+    free(full);
+    free(compact);
+    free(out);
+    free(diffs);
+    return 0;
+}
@@ -0,0 +1,705 @@
+// bcml-bulk: validate and convert wireless configs for many devices at once.
+//
+// Input is NDJSON, one record per line:
+//   {"device":"<id>","wireless":{"radio":[...],"ssid":[...]}}
+// Each record is validated against the wireless schema, decoded into
+// bcml_wireless_cfg_t and written back in canonical form (northbound or REST
+// keys), or replaced by an error record:
+//   {"line":<n>,"device":"<id>","error":"<reason>"}
+// Output order always matches input order.
+//
+// The input is streamed in fixed-size chunks of whole lines. Chunks are spread
+// over per-worker deques; idle workers steal from the others. A writer thread
+// emits finished chunks in sequence, and at most <window> chunks are in flight,
+// so memory stays bounded whatever the file size.
+//
+// Exit status: 0 all records valid, 1 some records rejected, 2 usage or I/O error.
+
+#define _GNU_SOURCE
+#include "json_scan.h"
+#include "wireless_codec.h"
+#include "bcml_types.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <cjson/cJSON.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define BULK_DEFAULT_CHUNK_KB   1024
+#define BULK_DEFAULT_MAX_LINE   (16u * 1024 * 1024)
+#define BULK_DEVICE_MAX         256
+
+typedef struct {
+    char* data;
+    size_t len;
+    size_t cap;
+} bulk_buf_t;
+
+typedef struct {
+    unsigned long seq;
+    unsigned long first_line;   // 1-based number of the first line in the chunk
+    bulk_buf_t in;
+    bulk_buf_t out;
+    unsigned long records;
+    unsigned long errors;
+    bool oversized;             // Chunk stands for one line longer than max_line
+    bool done;
+} bulk_chunk_t;
+
+// Per-worker queue. The owner takes the oldest chunk (keeps output flowing in
+// order), thieves take the newest (least likely to be contended).
+typedef struct {
+    pthread_mutex_t lock;
+    bulk_chunk_t** items;
+    size_t cap;
+    size_t head;
+    size_t count;
+} bulk_deque_t;
+
+typedef struct {
+    // Options
+    int workers;
+    size_t chunk_size;
+    size_t max_line;
+    unsigned window;
+    wireless_keyset_t keys;
+    bool errors_only;
+    int in_fd;
+    int out_fd;
+
+    bulk_chunk_t* slots;        // slot = seq % window
+    bulk_deque_t* deques;
+
+    pthread_mutex_t lock;       // Protects everything below
+    pthread_cond_t work_cond;   // queued > 0 or eof
+    pthread_cond_t done_cond;   // A chunk finished, or eof
+    pthread_cond_t free_cond;   // written advanced
+    unsigned long queued;
+    unsigned long submitted;
+    unsigned long written;
+    bool eof;
+    bool write_failed;
+
+    unsigned long total_records;
+    unsigned long total_errors;
+} bulk_ctx_t;
+
+typedef struct {
+    bulk_ctx_t* ctx;
+    int id;
+    json_scan_t scan;
+    bcml_wireless_cfg_t cfg;    // Reused across records
+    unsigned int steal_seed;
+} bulk_worker_t;
+
+static bool buf_reserve(bulk_buf_t* b, size_t extra) {
+    if (b->len + extra <= b->cap)
+        return true;
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < b->len + extra)
+        cap *= 2;
+    char* p = realloc(b->data, cap);
+    if (!p)
+        return false;
+    b->data = p;
+    b->cap = cap;
+    return true;
+}
+
+static bool buf_append(bulk_buf_t* b, const char* s, size_t n) {
+    if (!buf_reserve(b, n))
+        return false;
+    memcpy(b->data + b->len, s, n);
+    b->len += n;
+    return true;
+}
+
+// ---- Work-stealing deques ----
+
+static void deque_push(bulk_deque_t* q, bulk_chunk_t* c) {
+    pthread_mutex_lock(&q->lock);
+    q->items[(q->head + q->count) % q->cap] = c;
+    q->count++;
+    pthread_mutex_unlock(&q->lock);
+}
+
+static bulk_chunk_t* deque_pop_oldest(bulk_deque_t* q) {
+    bulk_chunk_t* c = NULL;
+    pthread_mutex_lock(&q->lock);
+    if (q->count) {
+        c = q->items[q->head];
+        q->head = (q->head + 1) % q->cap;
+        q->count--;
+    }
+    pthread_mutex_unlock(&q->lock);
+    return c;
+}
+
+static bulk_chunk_t* deque_steal_newest(bulk_deque_t* q) {
+    bulk_chunk_t* c = NULL;
+    if (pthread_mutex_trylock(&q->lock) != 0)
+        return NULL;
+    if (q->count) {
+        q->count--;
+        c = q->items[(q->head + q->count) % q->cap];
+    }
+    pthread_mutex_unlock(&q->lock);
+    return c;
+}
+
+static bulk_chunk_t* take_work(bulk_worker_t* w) {
+    bulk_ctx_t* ctx = w->ctx;
+    bulk_chunk_t* c = deque_pop_oldest(&ctx->deques[w->id]);
+    if (!c && ctx->workers > 1) {
+        int start = (int)(rand_r(&w->steal_seed) % (unsigned)ctx->workers);
+        for (int k = 0; k < ctx->workers && !c; ++k) {
+            int victim = (start + k) % ctx->workers;
+            if (victim != w->id)
+                c = deque_steal_newest(&ctx->deques[victim]);
+        }
+    }
+    return c;
+}
+
+// ---- Record processing ----
+
+static void emit_error(bulk_chunk_t* chunk, unsigned long line, const char* device, const char* reason) {
+    cJSON* rec = cJSON_CreateObject();
+    char* text = NULL;
+    chunk->errors++;
+    if (rec) {
+        cJSON_AddNumberToObject(rec, "line", (double)line);
+        if (device && device[0])
+            cJSON_AddStringToObject(rec, "device", device);
+        cJSON_AddStringToObject(rec, "error", reason);
+        text = cJSON_PrintUnformatted(rec);
+        cJSON_Delete(rec);
+    }
+    if (text) {
+        buf_append(&chunk->out, text, strlen(text));
+        buf_append(&chunk->out, "\n", 1);
+        free(text);
+    }
+}
+
+static void process_record(bulk_worker_t* w, bulk_chunk_t* chunk, const char* line, size_t len,
+                           unsigned long line_no) {
+    bulk_ctx_t* ctx = w->ctx;
+    char device[BULK_DEVICE_MAX] = "";
+    char key[16];
+    size_t key_len;
+    size_t device_len = 0;
+    bool have_device = false;
+    bool have_wireless = false;
+    bool first = true;
+    bcml_wireless_cfg_t* cfg = &w->cfg;
+    json_cur_t cur;
+    int r;
+
+    chunk->records++;
+    if (!json_scan(&w->scan, line, len, JSON_SCAN_AUTO)) {
+        emit_error(chunk, line_no, NULL, "malformed JSON");
+        return;
+    }
+    json_cur_init(&cur, &w->scan);
+    if (!json_cur_object_begin(&cur)) {
+        emit_error(chunk, line_no, NULL, "record is not an object");
+        return;
+    }
+    while ((r = json_cur_member(&cur, &first, key, sizeof(key), &key_len)) == 1) {
+        if (key_len < sizeof(key) && strcmp(key, "device") == 0 && !have_device) {
+            if (!json_cur_string(&cur, device, sizeof(device), &device_len)) {
+                emit_error(chunk, line_no, NULL, "'device' must be a string");
+                return;
+            }
+            if (device_len == 0 || device_len >= sizeof(device)) {
+                emit_error(chunk, line_no, NULL, "'device' is empty or too long");
+                return;
+            }
+            have_device = true;
+        } else if (key_len < sizeof(key) && strcmp(key, "wireless") == 0 && !have_wireless) {
+            have_wireless = true;
+            json_cur_t at = cur;
+            if (!wireless_cfg_from_scan(&cur, cfg, WIRELESS_SECTION_ALL, WIRELESS_KEYS_NB, true)) {
+                // Tell a schema violation from broken JSON
+                cur = at;
+                emit_error(chunk, line_no, device, json_cur_skip(&cur) ? "wireless: schema validation failed"
+                                                                       : "malformed JSON");
+                return;
+            }
+        } else if (!json_cur_skip(&cur)) {
+            emit_error(chunk, line_no, device, "malformed JSON");
+            return;
+        }
+    }
+    if (r < 0 || !json_cur_at_end(&cur)) {
+        emit_error(chunk, line_no, device, "malformed JSON");
+        return;
+    }
+    if (!have_device || !have_wireless) {
+        emit_error(chunk, line_no, device, have_device ? "missing 'wireless'" : "missing 'device'");
+        return;
+    }
+    if (ctx->errors_only)
+        return;
+
+    cJSON* rec = cJSON_CreateObject();
+    cJSON* wireless = wireless_cfg_to_json(cfg, WIRELESS_SECTION_ALL, ctx->keys);
+    char* text = NULL;
+    if (rec && wireless) {
+        cJSON_AddStringToObject(rec, "device", device);
+        cJSON_AddItemToObject(rec, "wireless", wireless);
+        wireless = NULL;
+        text = cJSON_PrintUnformatted(rec);
+    }
+    cJSON_Delete(wireless);
+    cJSON_Delete(rec);
+    if (!text) {
+        emit_error(chunk, line_no, device, "out of memory");
+        return;
+    }
+    buf_append(&chunk->out, text, strlen(text));
+    buf_append(&chunk->out, "\n", 1);
+    free(text);
+}
+
+static bool blank_line(const char* p, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (p[i] != ' ' && p[i] != '\t' && p[i] != '\r')
+            return false;
+    }
+    return true;
+}
+
+static void process_chunk(bulk_worker_t* w, bulk_chunk_t* chunk) {
+    chunk->out.len = 0;
+    chunk->records = 0;
+    chunk->errors = 0;
+    if (chunk->oversized) {
+        chunk->records = 1;
+        emit_error(chunk, chunk->first_line, NULL, "line too long");
+        return;
+    }
+
+    const char* p = chunk->in.data;
+    const char* end = p + chunk->in.len;
+    unsigned long line_no = chunk->first_line;
+    while (p < end) {
+        const char* nl = memchr(p, '\n', (size_t)(end - p));
+        size_t n = nl ? (size_t)(nl - p) : (size_t)(end - p);
+        if (n > w->ctx->max_line) {
+            chunk->records++;
+            emit_error(chunk, line_no, NULL, "line too long");
+        } else if (!blank_line(p, n)) {
+            process_record(w, chunk, p, n, line_no);
+        }
+        p += n + 1;
+        line_no++;
+    }
+}
+
+static void* worker_main(void* arg) {
+    bulk_worker_t* w = (bulk_worker_t*)arg;
+    bulk_ctx_t* ctx = w->ctx;
+
+    for (;;) {
+        pthread_mutex_lock(&ctx->lock);
+        while (ctx->queued == 0 && !ctx->eof)
+            pthread_cond_wait(&ctx->work_cond, &ctx->lock);
+        if (ctx->queued == 0 && ctx->eof) {
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        pthread_mutex_unlock(&ctx->lock);
+
+        bulk_chunk_t* chunk = take_work(w);
+        if (!chunk) {
+            sched_yield();  // Someone else got it first
+            continue;
+        }
+        pthread_mutex_lock(&ctx->lock);
+        ctx->queued--;
+        pthread_mutex_unlock(&ctx->lock);
+
+        process_chunk(w, chunk);
+
+        pthread_mutex_lock(&ctx->lock);
+        chunk->done = true;
+        pthread_cond_broadcast(&ctx->done_cond);
+        pthread_mutex_unlock(&ctx->lock);
+    }
+    return NULL;
+}
+
+// ---- Ordered writer ----
+
+static bool write_all(int fd, const char* p, size_t n) {
+    while (n) {
+        ssize_t k = write(fd, p, n);
+        if (k < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        p += k;
+        n -= (size_t)k;
+    }
+    return true;
+}
+
+static void* writer_main(void* arg) {
+    bulk_ctx_t* ctx = (bulk_ctx_t*)arg;
+
+    for (unsigned long seq = 0;; ++seq) {
+        bulk_chunk_t* chunk = &ctx->slots[seq % ctx->window];
+
+        pthread_mutex_lock(&ctx->lock);
+        while (!(seq < ctx->submitted && chunk->done) && !(ctx->eof && seq >= ctx->submitted))
+            pthread_cond_wait(&ctx->done_cond, &ctx->lock);
+        if (seq >= ctx->submitted) {
+            pthread_mutex_unlock(&ctx->lock);
+            break;
+        }
+        pthread_mutex_unlock(&ctx->lock);
+
+        bool ok = ctx->write_failed || write_all(ctx->out_fd, chunk->out.data, chunk->out.len);
+
+        pthread_mutex_lock(&ctx->lock);
+        if (!ok)
+            ctx->write_failed = true;
+        ctx->total_records += chunk->records;
+        ctx->total_errors += chunk->errors;
+        chunk->done = false;
+        ctx->written = seq + 1;
+        pthread_cond_broadcast(&ctx->free_cond);
+        pthread_mutex_unlock(&ctx->lock);
+    }
+    return NULL;
+}
+
+// ---- Reader (main thread) ----
+
+static void submit(bulk_ctx_t* ctx, bulk_chunk_t* chunk) {
+    deque_push(&ctx->deques[chunk->seq % (unsigned long)ctx->workers], chunk);
+    pthread_mutex_lock(&ctx->lock);
+    ctx->submitted = chunk->seq + 1;
+    ctx->queued++;
+    pthread_cond_signal(&ctx->work_cond);
+    pthread_mutex_unlock(&ctx->lock);
+}
+
+static bulk_chunk_t* next_slot(bulk_ctx_t* ctx, unsigned long seq) {
+    pthread_mutex_lock(&ctx->lock);
+    while (seq >= ctx->written + ctx->window)
+        pthread_cond_wait(&ctx->free_cond, &ctx->lock);
+    pthread_mutex_unlock(&ctx->lock);
+
+    bulk_chunk_t* chunk = &ctx->slots[seq % ctx->window];
+    chunk->seq = seq;
+    chunk->in.len = 0;
+    chunk->oversized = false;
+    chunk->done = false;
+    return chunk;
+}
+
+static unsigned long count_lines(const char* p, size_t n) {
+    unsigned long lines = 0;
+    const char* end = p + n;
+    while ((p = memchr(p, '\n', (size_t)(end - p))) != NULL) {
+        ++lines;
+        ++p;
+    }
+    return lines;
+}
+
+// Read until the buffer is full or EOF; false on read error
+static bool fill(int fd, bulk_buf_t* b, size_t limit, bool* eof) {
+    while (b->len < limit && !*eof) {
+        ssize_t n = read(fd, b->data + b->len, limit - b->len);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        if (n == 0)
+            *eof = true;
+        b->len += (size_t)n;
+    }
+    return true;
+}
+
+// Discard input up to and including the next newline; returns bytes kept after it in carry
+static bool skip_line(int fd, bulk_buf_t* carry, bool* eof) {
+    for (;;) {
+        char* nl = memchr(carry->data, '\n', carry->len);
+        if (nl) {
+            size_t rest = carry->len - (size_t)(nl + 1 - carry->data);
+            memmove(carry->data, nl + 1, rest);
+            carry->len = rest;
+            return true;
+        }
+        carry->len = 0;
+        if (*eof)
+            return true;
+        if (!fill(fd, carry, carry->cap, eof))
+            return false;
+    }
+}
+
+static bool read_input(bulk_ctx_t* ctx) {
+    bulk_buf_t carry = { 0 };
+    bool eof = false;
+    bool ok = true;
+    unsigned long line = 1;
+    unsigned long seq = 0;
+
+    if (!buf_reserve(&carry, ctx->chunk_size))
+        return false;
+
+    while (ok && (!eof || carry.len)) {
+        bulk_chunk_t* chunk = next_slot(ctx, seq);
+        bulk_buf_t* in = &chunk->in;
+        size_t limit = ctx->chunk_size;
+
+        if (!buf_reserve(in, limit)) {
+            ok = false;
+            break;
+        }
+        buf_append(in, carry.data, carry.len);
+        carry.len = 0;
+
+        // Grow past chunk_size only for a single line that does not fit
+        size_t boundary;
+        for (;;) {
+            if (!fill(ctx->in_fd, in, limit, &eof)) {
+                ok = false;
+                break;
+            }
+            char* nl = memrchr(in->data, '\n', in->len);
+            if (nl || eof) {
+                boundary = (nl && !eof) ? (size_t)(nl + 1 - in->data) : in->len;
+                break;
+            }
+            // Room for max_line bytes plus the newline
+            if (limit > ctx->max_line) {
+                boundary = 0;
+                break;
+            }
+            limit = (limit * 2 <= ctx->max_line) ? limit * 2 : ctx->max_line + 1;
+            if (!buf_reserve(in, limit - in->len)) {
+                ok = false;
+                break;
+            }
+        }
+        if (!ok)
+            break;
+
+        chunk->first_line = line;
+        if (boundary == 0 && in->len > 0) {
+            // One line longer than max_line: report it and drop the rest of it
+            chunk->oversized = true;
+            in->len = 0;
+            line++;
+            submit(ctx, chunk);
+            seq++;
+            if (!skip_line(ctx->in_fd, &carry, &eof)) {
+                ok = false;
+                break;
+            }
+            continue;
+        }
+
+        buf_append(&carry, in->data + boundary, in->len - boundary);
+        in->len = boundary;
+        line += count_lines(in->data, in->len);
+        if (in->len == 0)
+            continue;   // Slot stays free for the next round
+        submit(ctx, chunk);
+        seq++;
+    }
+    free(carry.data);
+    return ok;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options] [input.ndjson]\n"
+            "  -o FILE   output file (default: stdout)\n"
+            "  -j N      worker threads (default: online CPUs)\n"
+            "  -f FMT    output keys: nb (default) or rest\n"
+            "  -e        only write error records (validate mode)\n"
+            "  -c KB     chunk size in KiB (default: %u)\n"
+            "  -w N      chunks in flight (default: 4 per worker)\n"
+            "  -m BYTES  maximum line length (default: %u)\n"
+            "  -v        log library errors to stderr\n",
+            prog, BULK_DEFAULT_CHUNK_KB, BULK_DEFAULT_MAX_LINE);
+}
+
+int main(int argc, char** argv) {
+    bulk_ctx_t ctx;
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    const char* out_path = NULL;
+    bool verbose = false;
+    int opt;
+
+    memset(&ctx, 0, sizeof(ctx));
+    ctx.workers = cpus > 0 ? (int)cpus : 1;
+    ctx.chunk_size = (size_t)BULK_DEFAULT_CHUNK_KB * 1024;
+    ctx.max_line = BULK_DEFAULT_MAX_LINE;
+    ctx.keys = WIRELESS_KEYS_NB;
+    ctx.in_fd = STDIN_FILENO;
+    ctx.out_fd = STDOUT_FILENO;
+
+    while ((opt = getopt(argc, argv, "o:j:f:ec:w:m:vh")) != -1) {
+        switch (opt) {
+            case 'o': out_path = optarg; break;
+            case 'j': ctx.workers = atoi(optarg); break;
+            case 'f':
+                if (strcmp(optarg, "nb") == 0) {
+                    ctx.keys = WIRELESS_KEYS_NB;
+                } else if (strcmp(optarg, "rest") == 0) {
+                    ctx.keys = WIRELESS_KEYS_REST;
+                } else {
+                    usage(argv[0]);
+                    return 2;
+                }
+                break;
+            case 'e': ctx.errors_only = true; break;
+            case 'c': ctx.chunk_size = (size_t)strtoul(optarg, NULL, 10) * 1024; break;
+            case 'w': ctx.window = (unsigned)strtoul(optarg, NULL, 10); break;
+            case 'm': ctx.max_line = (size_t)strtoul(optarg, NULL, 10); break;
+            case 'v': verbose = true; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (ctx.workers < 1 || ctx.chunk_size == 0 || ctx.max_line == 0 || optind < argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    if (ctx.window == 0)
+        ctx.window = 4u * (unsigned)ctx.workers;
+
+    if (optind < argc && strcmp(argv[optind], "-") != 0) {
+        ctx.in_fd = open(argv[optind], O_RDONLY);
+        if (ctx.in_fd < 0) {
+            fprintf(stderr, "bcml-bulk: %s: %s\n", argv[optind], strerror(errno));
+            return 2;
+        }
+        posix_fadvise(ctx.in_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+    }
+    if (out_path) {
+        ctx.out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (ctx.out_fd < 0) {
+            fprintf(stderr, "bcml-bulk: %s: %s\n", out_path, strerror(errno));
+            return 2;
+        }
+    }
+    bcml_set_log_level(verbose ? LOG_LEVEL_ERROR : LOG_LEVEL_NONE);
+
+    ctx.slots = calloc(ctx.window, sizeof(*ctx.slots));
+    ctx.deques = calloc((size_t)ctx.workers, sizeof(*ctx.deques));
+    bulk_worker_t* workers = calloc((size_t)ctx.workers, sizeof(*workers));
+    pthread_t* tids = calloc((size_t)ctx.workers, sizeof(*tids));
+    if (!ctx.slots || !ctx.deques || !workers || !tids) {
+        fprintf(stderr, "bcml-bulk: out of memory\n");
+        return 2;
+    }
+    pthread_mutex_init(&ctx.lock, NULL);
+    pthread_cond_init(&ctx.work_cond, NULL);
+    pthread_cond_init(&ctx.done_cond, NULL);
+    pthread_cond_init(&ctx.free_cond, NULL);
+    for (int i = 0; i < ctx.workers; ++i) {
+        pthread_mutex_init(&ctx.deques[i].lock, NULL);
+        ctx.deques[i].cap = ctx.window;
+        ctx.deques[i].items = calloc(ctx.window, sizeof(bulk_chunk_t*));
+        if (!ctx.deques[i].items) {
+            fprintf(stderr, "bcml-bulk: out of memory\n");
+            return 2;
+        }
+    }
+
+    struct timespec t0, t1;
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+
+    pthread_t writer;
+    if ((errno = pthread_create(&writer, NULL, writer_main, &ctx)) != 0) {
+        fprintf(stderr, "bcml-bulk: cannot start writer: %s\n", strerror(errno));
+        return 2;
+    }
+    int started = 0;
+    for (int i = 0; i < ctx.workers; ++i) {
+        workers[i].ctx = &ctx;
+        workers[i].id = i;
+        workers[i].steal_seed = (unsigned int)i * 2654435761u + 1;
+        json_scan_init(&workers[i].scan);
+        bcml_wireless_cfg_init(&workers[i].cfg);
+    }
+    for (; started < ctx.workers; ++started) {
+        if ((errno = pthread_create(&tids[started], NULL, worker_main, &workers[started])) != 0) {
+            fprintf(stderr, "bcml-bulk: cannot start worker %d: %s\n", started, strerror(errno));
+            break;
+        }
+    }
+
+    // Nothing is read unless every thread runs; eof with nothing submitted lets the started ones exit
+    bool threads_ok = started == ctx.workers;
+    bool read_ok = threads_ok && read_input(&ctx);
+    int read_errno = errno;
+
+    pthread_mutex_lock(&ctx.lock);
+    ctx.eof = true;
+    pthread_cond_broadcast(&ctx.work_cond);
+    pthread_cond_broadcast(&ctx.done_cond);
+    pthread_mutex_unlock(&ctx.lock);
+    for (int i = 0; i < ctx.workers; ++i) {
+        if (i < started)
+            pthread_join(tids[i], NULL);
+        json_scan_free(&workers[i].scan);
+        bcml_wireless_cfg_free(&workers[i].cfg);
+    }
+    pthread_join(writer, NULL);
+    if (!threads_ok)
+        return 2;
+
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    double secs = (double)(t1.tv_sec - t0.tv_sec) + (double)(t1.tv_nsec - t0.tv_nsec) / 1e9;
+    fprintf(stderr, "bcml-bulk: %lu records, %lu rejected, %.2f s (%.0f records/s, %d workers)\n",
+            ctx.total_records, ctx.total_errors, secs,
+            secs > 0 ? (double)ctx.total_records / secs : 0.0, ctx.workers);
+
+    for (unsigned i = 0; i < ctx.window; ++i) {
+        free(ctx.slots[i].in.data);
+        free(ctx.slots[i].out.data);
+    }
+    for (int i = 0; i < ctx.workers; ++i) {
+        free(ctx.deques[i].items);
+        pthread_mutex_destroy(&ctx.deques[i].lock);
+    }
+    free(ctx.slots);
+    free(ctx.deques);
+    free(workers);
+    free(tids);
+    if (ctx.out_fd != STDOUT_FILENO)
+        close(ctx.out_fd);
+    if (ctx.in_fd != STDIN_FILENO)
+        close(ctx.in_fd);
+
+    if (!read_ok) {
+        fprintf(stderr, "bcml-bulk: read error: %s\n", strerror(read_errno));
+        return 2;
+    }
+    if (ctx.write_failed) {
+        fprintf(stderr, "bcml-bulk: write error\n");
+        return 2;
+    }
+    return ctx.total_errors ? 1 : 0;
+}
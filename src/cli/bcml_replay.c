@@ -0,0 +1,351 @@
+// bcml-replay: re-drive a call trace (bcml_trace.h, e.g. bcmld -t) through
+// libbcml and report throughput and latency.
+//
+// By default the southbound is a mock built from the trace: a get answers
+// what the device answered when the trace was taken (the recorded config, "not
+// modified" or a failure), a set succeeds or fails as it did, optionally after
+// the recorded device latency (-L). Library changes then show up on their own,
+// and every get's output is compared with the recorded one. With -b the calls
+// go to a real registered backend instead.
+//
+// Calls are issued at their recorded offsets divided by the speed (-s 0:
+// back to back). Rollbacks need the journal they were taken against and are
+// skipped. The report is one line per call kind with replayed and recorded
+// latency percentiles, then "key value" totals, so two runs (e.g. two library
+// versions against the same trace) compare with diff or awk.
+//
+// Exit status: 0 replay matches the trace, 1 some calls diverged (result or
+// output), 2 usage or I/O error.
+
+#define _GNU_SOURCE
+#include "bcml_config.h"
+#include "bcml_sb.h"
+#include "bcml_trace.h"
+#include "bcml_wireless.h"
+#include "wireless_codec.h"
+#include "bcml_types.h"
+#include "bcml_log.h"
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#define REPLAY_BACKEND      "replay"
+#define REPLAY_BUF_MAX      (16u * 1024 * 1024)
+
+// Reported call kinds: the trace ops, then all of them together
+enum { KIND_SET, KIND_GET, KIND_SET_BIN, KIND_GET_BIN, KIND_ALL, KIND_COUNT };
+static const char* const g_kind_names[KIND_COUNT] = { "set", "get", "set_bin", "get_bin", "all" };
+
+typedef struct {
+    bcml_trace_rec_t rec;       // payload and sb point into data
+    uint8_t* data;
+} replay_call_t;
+
+typedef struct {
+    double* replayed;           // us
+    double* recorded;
+    size_t n;
+    size_t failed;
+} replay_stats_t;
+
+static const replay_call_t* g_current;  // Call whose recorded answers the mock gives
+static bool g_emulate_latency;
+
+// ---- Mock southbound ----
+
+static void sleep_ns(uint64_t ns) {
+    struct timespec ts = { .tv_sec = (time_t)(ns / 1000000000u), .tv_nsec = (long)(ns % 1000000000u) };
+    while (nanosleep(&ts, &ts) < 0 && errno == EINTR)
+        ;
+}
+
+static bool replay_set_wireless_config(const sb_ops_t* self, const bcml_wireless_cfg_t* cfg) {
+    (void)self;
+    (void)cfg;
+    if (g_emulate_latency)
+        sleep_ns(g_current->rec.stage_ns[BCML_TRACE_STAGE_SB]);
+    // A call that never reached the device failed earlier, before this
+    return g_current->rec.sb_status != 0;
+}
+
+static sb_get_status_t replay_get_wireless_config(const sb_ops_t* self, bcml_wireless_cfg_t* cfg) {
+    (void)self;
+    const bcml_trace_rec_t* rec = &g_current->rec;
+    if (g_emulate_latency)
+        sleep_ns(rec->stage_ns[BCML_TRACE_STAGE_SB]);
+    switch (rec->sb_status) {
+        case SB_GET_OK:
+            return wireless_delta_apply(cfg, rec->sb, rec->sb_len) ? SB_GET_OK : SB_GET_FAILED;
+        case SB_GET_NOT_MODIFIED:
+            return SB_GET_NOT_MODIFIED;
+        default:
+            return SB_GET_FAILED;
+    }
+}
+
+static const sb_ops_t g_replay_ops = {
+    .name = REPLAY_BACKEND,
+    .set_wireless_config = replay_set_wireless_config,
+    .get_wireless_config = replay_get_wireless_config
+};
+
+// ---- Trace loading ----
+
+static replay_call_t* load_trace(const char* path, size_t* count, uint32_t* buf_size) {
+    bcml_trace_reader_t* reader = bcml_trace_reader_open(path);
+    if (!reader)
+        return NULL;
+
+    replay_call_t* calls = NULL;
+    size_t n = 0, cap = 0;
+    bcml_trace_rec_t rec;
+    *buf_size = 1;
+    while (bcml_trace_reader_next(reader, &rec)) {
+        if (n == cap) {
+            cap = cap ? 2 * cap : 1024;
+            replay_call_t* p = realloc(calls, cap * sizeof(*calls));
+            if (!p)
+                goto fail;
+            calls = p;
+        }
+        // One block: payload, NUL (a JSON set is passed as a string), sb config
+        uint8_t* data = malloc(rec.payload_len + 1 + rec.sb_len);
+        if (!data)
+            goto fail;
+        memcpy(data, rec.payload, rec.payload_len);
+        data[rec.payload_len] = '\0';
+        memcpy(data + rec.payload_len + 1, rec.sb, rec.sb_len);
+        rec.payload = data;
+        rec.sb = data + rec.payload_len + 1;
+        calls[n].rec = rec;
+        calls[n].data = data;
+        ++n;
+        if ((rec.op == BCML_TRACE_OP_GET || rec.op == BCML_TRACE_OP_GET_BIN) && rec.arg > *buf_size)
+            *buf_size = rec.arg > REPLAY_BUF_MAX ? REPLAY_BUF_MAX : rec.arg;
+    }
+    bcml_trace_reader_close(reader);
+    *count = n;
+    return calls;
+
+fail:
+    fprintf(stderr, "bcml-replay: out of memory\n");
+    for (size_t i = 0; i < n; ++i)
+        free(calls[i].data);
+    free(calls);
+    bcml_trace_reader_close(reader);
+    return NULL;
+}
+
+// ---- Replay ----
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void sleep_until(uint64_t deadline) {
+    struct timespec ts = { .tv_sec = (time_t)(deadline / 1000000000u), .tv_nsec = (long)(deadline % 1000000000u) };
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR)
+        ;
+}
+
+// Issue one recorded call; *out_len: size of a get's output in buf
+static bool replay_one(const bcml_trace_rec_t* rec, uint8_t* buf, size_t* out_len) {
+    const char* type = rec->type;
+    size_t size = rec->arg < REPLAY_BUF_MAX ? rec->arg : REPLAY_BUF_MAX;
+    bool ok = false;
+    *out_len = 0;
+    switch (rec->op) {
+        case BCML_TRACE_OP_SET:
+            ok = bcml_config_set(type, (const char*)rec->payload);
+            break;
+        case BCML_TRACE_OP_SET_BIN:
+            ok = bcml_config_set_bin(type, rec->payload, rec->payload_len);
+            break;
+        case BCML_TRACE_OP_GET:
+            ok = size && bcml_config_get(type, (char*)buf, size);
+            if (ok)
+                *out_len = strlen((const char*)buf);
+            break;
+        case BCML_TRACE_OP_GET_BIN:
+            ok = size && bcml_config_get_bin(type, buf, size, out_len);
+            break;
+    }
+    return ok;
+}
+
+static int cmp_double(const void* a, const void* b) {
+    double x = *(const double*)a, y = *(const double*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest-rank percentile of sorted samples
+static double percentile(const double* v, size_t n, double p) {
+    if (n == 0)
+        return 0;
+    size_t rank = (size_t)(p * (double)n + 0.999999);
+    return v[(rank ? rank : 1) - 1];
+}
+
+static void print_stats(const char* name, replay_stats_t* s) {
+    qsort(s->replayed, s->n, sizeof(double), cmp_double);
+    qsort(s->recorded, s->n, sizeof(double), cmp_double);
+    printf("%-8s %8zu %7zu %10.1f %10.1f %10.1f %10.1f %10.1f %10.1f\n", name, s->n, s->failed,
+           percentile(s->replayed, s->n, 0.50), percentile(s->replayed, s->n, 0.90),
+           percentile(s->replayed, s->n, 0.99), s->n ? s->replayed[s->n - 1] : 0.0,
+           percentile(s->recorded, s->n, 0.50), percentile(s->recorded, s->n, 0.99));
+}
+
+static int kind_of(uint8_t op) {
+    switch (op) {
+        case BCML_TRACE_OP_SET: return KIND_SET;
+        case BCML_TRACE_OP_GET: return KIND_GET;
+        case BCML_TRACE_OP_SET_BIN: return KIND_SET_BIN;
+        case BCML_TRACE_OP_GET_BIN: return KIND_GET_BIN;
+        default: return -1;
+    }
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [options] trace\n"
+            "  -b NAME   replay against registered backend NAME (default: the trace's recorded answers)\n"
+            "  -s SPEED  pace calls at SPEED times the recorded rate, 0: back to back (default: 1)\n"
+            "  -n N      play the trace N times (default: 1)\n"
+            "  -L        mock backend waits for the recorded southbound latency\n"
+            "  -C CC     regulatory domain, as given to bcmld -C (default: no check)\n"
+            "  -v        log library errors to stderr\n",
+            prog);
+}
+
+int main(int argc, char** argv) {
+    const char* backend = NULL;
+    const char* country = NULL;
+    double speed = 1.0;
+    long loops = 1;
+    bool verbose = false;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "b:s:n:LC:vh")) != -1) {
+        switch (opt) {
+            case 'b': backend = optarg; break;
+            case 's': speed = strtod(optarg, NULL); break;
+            case 'n': loops = strtol(optarg, NULL, 10); break;
+            case 'L': g_emulate_latency = true; break;
+            case 'C': country = optarg; break;
+            case 'v': verbose = true; break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 2;
+        }
+    }
+    if (speed < 0 || loops < 1 || optind != argc - 1) {
+        usage(argv[0]);
+        return 2;
+    }
+    bcml_set_log_level(verbose ? LOG_LEVEL_ERROR : LOG_LEVEL_NONE);
+
+    size_t count = 0;
+    uint32_t buf_size = 0;
+    replay_call_t* calls = load_trace(argv[optind], &count, &buf_size);
+    if (!calls) {
+        fprintf(stderr, "bcml-replay: cannot read trace %s\n", argv[optind]);
+        return 2;
+    }
+
+    if (!backend && !bcml_sb_register(&g_replay_ops)) {
+        fprintf(stderr, "bcml-replay: cannot register the mock backend\n");
+        return 2;
+    }
+    if (!bcml_sb_select(NULL, backend ? backend : REPLAY_BACKEND)) {
+        fprintf(stderr, "bcml-replay: unknown backend '%s'\n", backend);
+        return 2;
+    }
+    if (country && !bcml_wireless_set_country(country)) {
+        fprintf(stderr, "bcml-replay: unknown country '%s'\n", country);
+        return 2;
+    }
+
+    size_t total = count * (size_t)loops;
+    replay_stats_t stats[KIND_COUNT];
+    uint8_t* buf = malloc(buf_size);
+    bool alloc_ok = buf != NULL;
+    for (int k = 0; k < KIND_COUNT; ++k) {
+        stats[k].replayed = malloc((total ? total : 1) * sizeof(double));
+        stats[k].recorded = malloc((total ? total : 1) * sizeof(double));
+        stats[k].n = stats[k].failed = 0;
+        alloc_ok = alloc_ok && stats[k].replayed && stats[k].recorded;
+    }
+    if (!alloc_ok) {
+        fprintf(stderr, "bcml-replay: out of memory\n");
+        return 2;
+    }
+
+    size_t diverged = 0, mismatched = 0, skipped = 0;
+    uint64_t t_start = now_ns();
+    for (long loop = 0; loop < loops; ++loop) {
+        uint64_t t_loop = now_ns();
+        for (size_t i = 0; i < count; ++i) {
+            const bcml_trace_rec_t* rec = &calls[i].rec;
+            int kind = kind_of(rec->op);
+            if (kind < 0) {
+                ++skipped;
+                continue;
+            }
+            if (speed > 0)
+                sleep_until(t_loop + (uint64_t)((double)rec->start_ns / speed));
+
+            g_current = &calls[i];
+            size_t out_len;
+            uint64_t t0 = now_ns();
+            bool ok = replay_one(rec, buf, &out_len);
+            double us = (double)(now_ns() - t0) / 1e3;
+
+            if (ok != rec->ok)
+                ++diverged;
+            else if (ok && !backend && rec->payload_len &&
+                     (rec->op == BCML_TRACE_OP_GET || rec->op == BCML_TRACE_OP_GET_BIN) &&
+                     (out_len != rec->payload_len || memcmp(buf, rec->payload, out_len) != 0))
+                ++mismatched;
+            int kinds[] = { kind, KIND_ALL };
+            for (size_t j = 0; j < sizeof(kinds) / sizeof(kinds[0]); ++j) {
+                replay_stats_t* s = &stats[kinds[j]];
+                s->replayed[s->n] = us;
+                s->recorded[s->n] = (double)rec->total_ns / 1e3;
+                s->n++;
+                s->failed += !ok;
+            }
+        }
+    }
+    double elapsed = (double)(now_ns() - t_start) / 1e9;
+
+    printf("# trace %s, backend %s, speed %g, loops %ld\n", argv[optind], backend ? backend : REPLAY_BACKEND,
+           speed, loops);
+    printf("%-8s %8s %7s %10s %10s %10s %10s %10s %10s\n", "call", "count", "failed", "p50_us", "p90_us",
+           "p99_us", "max_us", "rec_p50_us", "rec_p99_us");
+    for (int k = 0; k < KIND_COUNT; ++k) {
+        if (stats[k].n || k == KIND_ALL)
+            print_stats(g_kind_names[k], &stats[k]);
+    }
+    printf("calls %zu\n", stats[KIND_ALL].n);
+    printf("elapsed_s %.6f\n", elapsed);
+    printf("throughput_calls_per_s %.1f\n", elapsed > 0 ? (double)stats[KIND_ALL].n / elapsed : 0.0);
+    printf("diverged %zu\n", diverged);
+    printf("mismatched %zu\n", mismatched);
+    printf("skipped %zu\n", skipped);
+
+    bcml_shutdown();
+    for (int k = 0; k < KIND_COUNT; ++k) {
+        free(stats[k].replayed);
+        free(stats[k].recorded);
+    }
+    for (size_t i = 0; i < count; ++i)
+        free(calls[i].data);
+    free(calls);
+    free(buf);
+    return diverged || mismatched ? 1 : 0;
+}
@@ -0,0 +1,350 @@
+// libbcml_client: bcml_config_set/get forwarded to bcmld (see bcml_client.h)
+
+#include "bcml_client.h"
+#include "bcml_config.h"
+#include "bcml_ipc.h"
+#include "bcml_log.h"
+#include <errno.h>
+#include <poll.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define CLIENT_TIMEOUT_MS   5000
+
+static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+static int g_fd = -1;
+static uint32_t g_next_id;
+static char g_path[sizeof(((struct sockaddr_un*)0)->sun_path)];
+
+// Reused between calls, guarded by g_lock
+static uint8_t* g_tx;
+static size_t g_tx_cap;
+static uint8_t* g_rx;
+static size_t g_rx_cap;
+
+static void close_locked(void) {
+    if (g_fd >= 0)
+        close(g_fd);
+    g_fd = -1;
+}
+
+static bool connect_locked(void) {
+    if (g_fd >= 0)
+        return true;
+
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    const char* path = g_path[0] ? g_path : getenv("BCMLD_SOCKET");
+    if (!path || !*path)
+        path = BCMLD_SOCKET_PATH;
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        BCML_LOG_ERROR("bcml_client: socket path too long: %s\n", path);
+        return false;
+    }
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return false;
+    if (connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        BCML_LOG_ERROR("bcml_client: cannot connect to %s: %s\n", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    g_fd = fd;
+    return true;
+}
+
+static bool grow(uint8_t** buf, size_t* cap, size_t need) {
+    if (need <= *cap)
+        return true;
+    size_t n = *cap ? *cap : 4096;
+    while (n < need)
+        n *= 2;
+    uint8_t* p = realloc(*buf, n);
+    if (!p)
+        return false;
+    *buf = p;
+    *cap = n;
+    return true;
+}
+
+// Encode every request into g_tx; false if one does not fit in a frame.
+// op 0 picks SET or GET (or their _BIN forms) per request, anything else applies to
+// all (json is the argument).
+static bool encode_locked(bcml_client_req_t* reqs, size_t count, uint8_t op, uint32_t first_id, size_t* out_len) {
+    size_t len = 0;
+    for (size_t i = 0; i < count; ++i) {
+        size_t tlen = strlen(reqs[i].type) + 1;
+        bool bin = !op && reqs[i].bin;
+        size_t jlen = !reqs[i].json ? 0 : bin ? reqs[i].len : strlen(reqs[i].json) + 1;
+        if (tlen + jlen > BCML_IPC_MAX_PAYLOAD) {
+            BCML_LOG_ERROR("bcml_client: %s request too large\n", reqs[i].type);
+            return false;
+        }
+        if (!grow(&g_tx, &g_tx_cap, len + BCML_IPC_HDR_SIZE + tlen + jlen))
+            return false;
+        bcml_ipc_hdr_t h = {
+            .op = op ? op
+                : reqs[i].json ? (bin ? BCML_IPC_OP_SET_BIN : BCML_IPC_OP_SET)
+                : (bin ? BCML_IPC_OP_GET_BIN : BCML_IPC_OP_GET),
+            .id = first_id + (uint32_t)i,
+            .len = (uint32_t)(tlen + jlen)
+        };
+        bcml_ipc_put_hdr(g_tx + len, &h);
+        memcpy(g_tx + len + BCML_IPC_HDR_SIZE, reqs[i].type, tlen);
+        if (jlen)
+            memcpy(g_tx + len + BCML_IPC_HDR_SIZE + tlen, reqs[i].json, jlen);
+        len += BCML_IPC_HDR_SIZE + h.len;
+    }
+    *out_len = len;
+    return true;
+}
+
+// Store one response in its request; false on a protocol error
+static bool decode_response(bcml_client_req_t* req, const bcml_ipc_hdr_t* h, uint32_t want_id, const uint8_t* payload) {
+    if (h->id != want_id) {
+        BCML_LOG_ERROR("bcml_client: response id %u, expected %u\n", h->id, want_id);
+        return false;
+    }
+    req->ok = h->status == BCML_IPC_OK;
+    if (req->json)
+        return true;
+
+    // get: the payload is consumed either way so the stream stays in sync
+    if (req->buffer_size == 0)
+        return true;
+    if (req->bin) {
+        req->len = 0;
+        if (req->ok && h->len <= req->buffer_size) {
+            memcpy(req->buffer, payload, h->len);
+            req->len = h->len;
+        } else {
+            if (req->ok)
+                BCML_LOG_ERROR("bcml_client: %s CBOR (%u bytes) exceeds buffer\n", req->type, h->len);
+            req->ok = false;
+        }
+        return true;
+    }
+    if (req->ok && h->len < req->buffer_size) {
+        memcpy(req->buffer, payload, h->len);
+        req->buffer[h->len] = '\0';
+    } else {
+        if (req->ok)
+            BCML_LOG_ERROR("bcml_client: %s JSON (%u bytes) exceeds buffer\n", req->type, h->len);
+        req->ok = false;
+        req->buffer[0] = '\0';
+    }
+    return true;
+}
+
+// Write the batch and read the responses concurrently, so a batch larger than
+// the socket buffers cannot deadlock against the daemon's output back-pressure.
+// *got counts the responses received, for the retry decision.
+static bool exchange_locked(bcml_client_req_t* reqs, size_t count, uint8_t op, size_t* got) {
+    uint32_t first_id = g_next_id;
+    size_t tx_len, tx_off = 0, rx_len = 0;
+
+    *got = 0;
+    g_next_id += (uint32_t)count;
+    if (!encode_locked(reqs, count, op, first_id, &tx_len))
+        return false;
+
+    while (*got < count) {
+        struct pollfd pfd = { .fd = g_fd, .events = POLLIN | (tx_off < tx_len ? POLLOUT : 0) };
+        int rc = poll(&pfd, 1, CLIENT_TIMEOUT_MS);
+        if (rc < 0 && errno == EINTR)
+            continue;
+        if (rc <= 0) {
+            BCML_LOG_ERROR("bcml_client: daemon %s\n", rc == 0 ? "timed out" : strerror(errno));
+            return false;
+        }
+
+        if ((pfd.revents & POLLOUT) && tx_off < tx_len) {
+            ssize_t n = send(g_fd, g_tx + tx_off, tx_len - tx_off, MSG_NOSIGNAL | MSG_DONTWAIT);
+            if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)
+                return false;
+            if (n > 0)
+                tx_off += (size_t)n;
+        }
+        if (!(pfd.revents & (POLLIN | POLLHUP | POLLERR)))
+            continue;
+
+        if (!grow(&g_rx, &g_rx_cap, rx_len + 16 * 1024))
+            return false;
+        ssize_t n = recv(g_fd, g_rx + rx_len, g_rx_cap - rx_len, MSG_DONTWAIT);
+        if (n == 0)
+            return false;
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+                continue;
+            return false;
+        }
+        rx_len += (size_t)n;
+
+        size_t off = 0;
+        while (*got < count && rx_len - off >= BCML_IPC_HDR_SIZE) {
+            bcml_ipc_hdr_t h;
+            if (!bcml_ipc_get_hdr(g_rx + off, &h))
+                return false;
+            if (rx_len - off < BCML_IPC_HDR_SIZE + h.len) {
+                // Make room for the rest of this frame
+                if (!grow(&g_rx, &g_rx_cap, off + BCML_IPC_HDR_SIZE + h.len))
+                    return false;
+                break;
+            }
+            if (!decode_response(&reqs[*got], &h, first_id + (uint32_t)*got, g_rx + off + BCML_IPC_HDR_SIZE))
+                return false;
+            off += BCML_IPC_HDR_SIZE + h.len;
+            ++*got;
+        }
+        memmove(g_rx, g_rx + off, rx_len - off);
+        rx_len -= off;
+    }
+    return true;
+}
+
+static bool batch(bcml_client_req_t* reqs, size_t count, uint8_t op) {
+    pthread_mutex_lock(&g_lock);
+    bool ok = false;
+    // A kept-open connection may have gone stale (daemon restarted):
+    // reconnect and resend once, unless part of the batch was already answered
+    for (int attempt = 0; attempt < 2 && !ok; ++attempt) {
+        size_t got = 0;
+        if (!connect_locked())
+            break;
+        ok = exchange_locked(reqs, count, op, &got);
+        if (!ok) {
+            close_locked();
+            if (got > 0)
+                break;
+        }
+    }
+    pthread_mutex_unlock(&g_lock);
+    return ok;
+}
+
+bool bcml_client_batch(bcml_client_req_t* reqs, size_t count) {
+    if (!reqs)
+        return false;
+    for (size_t i = 0; i < count; ++i) {
+        reqs[i].ok = false;
+        if (!reqs[i].type || (!reqs[i].json && !reqs[i].buffer))
+            return false;
+    }
+    if (count == 0)
+        return true;
+    return batch(reqs, count, 0);
+}
+
+bool bcml_config_set(const char* type, const char* json_data) {
+    if (!type || !json_data)
+        return false;
+    bcml_client_req_t req = { .type = type, .json = json_data };
+    return bcml_client_batch(&req, 1) && req.ok;
+}
+
+bool bcml_config_get(const char* type, char* json_buffer, size_t buffer_size) {
+    if (!type || !json_buffer || buffer_size == 0)
+        return false;
+    bcml_client_req_t req = { .type = type, .buffer = json_buffer, .buffer_size = buffer_size };
+    return bcml_client_batch(&req, 1) && req.ok;
+}
+
+// One pipelined batch: the daemon's fetches run back to back, but the round trips overlap
+bool bcml_config_get_many(bcml_config_get_t* reqs, size_t count) {
+    if (!reqs || count == 0)
+        return false;
+    bcml_client_req_t* batch_reqs = calloc(count, sizeof(*batch_reqs));
+    if (!batch_reqs)
+        return false;
+    for (size_t i = 0; i < count; ++i) {
+        reqs[i].ok = false;
+        if (!reqs[i].type || !reqs[i].buffer || reqs[i].buffer_size == 0) {
+            free(batch_reqs);
+            return false;
+        }
+        batch_reqs[i].type = reqs[i].type;
+        batch_reqs[i].buffer = reqs[i].buffer;
+        batch_reqs[i].buffer_size = reqs[i].buffer_size;
+    }
+    bool ok = bcml_client_batch(batch_reqs, count);
+    for (size_t i = 0; i < count; ++i) {
+        reqs[i].ok = batch_reqs[i].ok;
+        ok = ok && reqs[i].ok;
+    }
+    free(batch_reqs);
+    return ok;
+}
+
+bool bcml_config_set_bin(const char* type, const void* data, size_t len) {
+    if (!type || !data || len == 0)
+        return false;
+    bcml_client_req_t req = { .type = type, .json = (const char*)data, .bin = true, .len = len };
+    return bcml_client_batch(&req, 1) && req.ok;
+}
+
+bool bcml_config_get_bin(const char* type, void* buffer, size_t buffer_size, size_t* len) {
+    if (len)
+        *len = 0;
+    if (!type || !buffer || buffer_size == 0)
+        return false;
+    bcml_client_req_t req = { .type = type, .buffer = (char*)buffer, .buffer_size = buffer_size, .bin = true };
+    bool ok = bcml_client_batch(&req, 1) && req.ok;
+    if (ok && len)
+        *len = req.len;
+    return ok;
+}
+
+bool bcml_config_rollback(const char* type, unsigned int generations) {
+    char arg[16];
+    if (!type)
+        return false;
+    snprintf(arg, sizeof(arg), "%u", generations);
+    bcml_client_req_t req = { .type = type, .json = arg };
+    return batch(&req, 1, BCML_IPC_OP_ROLLBACK) && req.ok;
+}
+
+bool bcml_client_set_socket_path(const char* path) {
+    if (path && strlen(path) >= sizeof(g_path))
+        return false;
+    pthread_mutex_lock(&g_lock);
+    snprintf(g_path, sizeof(g_path), "%s", path ? path : "");
+    close_locked();
+    pthread_mutex_unlock(&g_lock);
+    return true;
+}
+
+void bcml_client_close(void) {
+    pthread_mutex_lock(&g_lock);
+    close_locked();
+    free(g_tx);
+    free(g_rx);
+    g_tx = g_rx = NULL;
+    g_tx_cap = g_rx_cap = 0;
+    pthread_mutex_unlock(&g_lock);
+}
+
+static void client_atexit(void) {
+    bcml_client_close();
+}
+
+// The daemon holds the warm state, so init only connects (and BCML_INIT_WARM has nothing to add)
+bool bcml_init(unsigned int flags) {
+    static bool atexit_registered;
+
+    pthread_mutex_lock(&g_lock);
+    bool ok = connect_locked();
+    if (!(flags & BCML_INIT_NO_ATEXIT) && !atexit_registered)
+        atexit_registered = atexit(client_atexit) == 0;
+    pthread_mutex_unlock(&g_lock);
+    return ok;
+}
+
+void bcml_shutdown(void) {
+    bcml_client_close();
+}
@@ -0,0 +1,395 @@
+// bcmld: keeps libbcml warm (handlers, backend connections, caches) and serves
+// bcml_config_set/get to other processes over a Unix domain socket.
+//
+// Protocol: src/lib/ipc/bcml_ipc.h. Clients: libbcml_client (bcml_client.h).
+//
+// One thread, one poll() loop: the config handlers are not thread-safe, and a
+// request costs microseconds, so requests are simply served in arrival order.
+// Every complete frame in a read is handled before the responses are flushed
+// in one send, which is what makes pipelining pay off.
+//
+// Usage: bcmld [-s socket] [-b backend] [-c cache_ms] [-p shm_name] [-j journal [-k keep]] [-C country] [-t trace] [-v level]
+
+#include "bcml_ipc.h"
+#include "bcml_config.h"
+#include "bcml_sb.h"
+#include "bcml_snapshot.h"
+#include "bcml_journal.h"
+#include "bcml_trace.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define BCMLD_MAX_CLIENTS   64
+#define BCMLD_JSON_MAX      (64 * 1024)
+#define BCMLD_READ_CHUNK    (16 * 1024)
+#define BCMLD_OUT_HIGH      (256 * 1024)    // Stop reading a client until its output drains
+#define BCMLD_CACHE_NAME    "bcmld-cache"
+#define BCMLD_SNAPSHOT_MODE 0640            // -p segment: owner writes, group reads
+
+typedef struct {
+    uint8_t* data;
+    size_t len;
+    size_t cap;
+} bcmld_buf_t;
+
+typedef struct {
+    int fd;
+    bcmld_buf_t in;
+    bcmld_buf_t out;
+    size_t out_off;     // Bytes of out already sent
+} bcmld_conn_t;
+
+static volatile sig_atomic_t g_stop;
+static bcmld_conn_t g_conns[BCMLD_MAX_CLIENTS];
+static int g_nconns;
+static char g_json[BCMLD_JSON_MAX];
+
+static void on_signal(int sig) {
+    (void)sig;
+    g_stop = 1;
+}
+
+static bool buf_reserve(bcmld_buf_t* b, size_t extra) {
+    if (b->len + extra <= b->cap)
+        return true;
+    size_t cap = b->cap ? b->cap : 4096;
+    while (cap < b->len + extra)
+        cap *= 2;
+    uint8_t* p = realloc(b->data, cap);
+    if (!p)
+        return false;
+    b->data = p;
+    b->cap = cap;
+    return true;
+}
+
+static bool queue_response(bcmld_conn_t* c, const bcml_ipc_hdr_t* req, bcml_ipc_status_t status,
+                           const char* payload, size_t len) {
+    bcml_ipc_hdr_t h = { .op = req->op, .status = (uint8_t)status, .id = req->id, .len = (uint32_t)len };
+    if (!buf_reserve(&c->out, BCML_IPC_HDR_SIZE + len))
+        return false;
+    bcml_ipc_put_hdr(c->out.data + c->out.len, &h);
+    if (len)
+        memcpy(c->out.data + c->out.len + BCML_IPC_HDR_SIZE, payload, len);
+    c->out.len += BCML_IPC_HDR_SIZE + len;
+    return true;
+}
+
+static bool handle_request(bcmld_conn_t* c, const bcml_ipc_hdr_t* h, const char* payload) {
+    // Payload starts with the NUL-terminated config type
+    const char* type = payload;
+    const char* nul = memchr(payload, '\0', h->len);
+    if (h->op != BCML_IPC_OP_PING && (!nul || nul == payload))
+        return queue_response(c, h, BCML_IPC_BAD_REQUEST, NULL, 0);
+
+    switch (h->op) {
+        case BCML_IPC_OP_PING:
+            return queue_response(c, h, BCML_IPC_OK, NULL, 0);
+
+        case BCML_IPC_OP_SET: {
+            // bcml_config_set() takes a C string: terminate the JSON in place
+            // (the frame's last byte is the NUL the client sends after it)
+            const char* json = nul + 1;
+            size_t json_len = h->len - (size_t)(json - payload);
+            if (json_len == 0 || json[json_len - 1] != '\0')
+                return queue_response(c, h, BCML_IPC_BAD_REQUEST, NULL, 0);
+            bool ok = bcml_config_set(type, json);
+            BCML_LOG_DEBUG("bcmld: set %s id=%u -> %d\n", type, h->id, ok);
+            return queue_response(c, h, ok ? BCML_IPC_OK : BCML_IPC_FAILED, NULL, 0);
+        }
+
+        case BCML_IPC_OP_SET_BIN: {
+            const uint8_t* data = (const uint8_t*)nul + 1;
+            size_t len = h->len - (size_t)((const char*)data - payload);
+            bool ok = bcml_config_set_bin(type, data, len);
+            BCML_LOG_DEBUG("bcmld: set_bin %s id=%u -> %d\n", type, h->id, ok);
+            return queue_response(c, h, ok ? BCML_IPC_OK : BCML_IPC_FAILED, NULL, 0);
+        }
+
+        case BCML_IPC_OP_GET_BIN: {
+            size_t len = 0;
+            bool ok = bcml_config_get_bin(type, g_json, sizeof(g_json), &len);
+            BCML_LOG_DEBUG("bcmld: get_bin %s id=%u -> %d\n", type, h->id, ok);
+            if (!ok)
+                return queue_response(c, h, BCML_IPC_FAILED, NULL, 0);
+            return queue_response(c, h, BCML_IPC_OK, g_json, len);
+        }
+
+        case BCML_IPC_OP_ROLLBACK: {
+            const char* arg = nul + 1;
+            size_t arg_len = h->len - (size_t)(arg - payload);
+            char* end;
+            if (arg_len < 2 || arg[arg_len - 1] != '\0' || arg[0] < '0' || arg[0] > '9')
+                return queue_response(c, h, BCML_IPC_BAD_REQUEST, NULL, 0);
+            unsigned long generations = strtoul(arg, &end, 10);
+            if (*end != '\0' || generations > UINT_MAX)
+                return queue_response(c, h, BCML_IPC_BAD_REQUEST, NULL, 0);
+            bool ok = bcml_config_rollback(type, (unsigned int)generations);
+            BCML_LOG_DEBUG("bcmld: rollback %s by %lu id=%u -> %d\n", type, generations, h->id, ok);
+            return queue_response(c, h, ok ? BCML_IPC_OK : BCML_IPC_FAILED, NULL, 0);
+        }
+
+        case BCML_IPC_OP_GET: {
+            bool ok = bcml_config_get(type, g_json, sizeof(g_json));
+            BCML_LOG_DEBUG("bcmld: get %s id=%u -> %d\n", type, h->id, ok);
+            if (!ok)
+                return queue_response(c, h, BCML_IPC_FAILED, NULL, 0);
+            return queue_response(c, h, BCML_IPC_OK, g_json, strlen(g_json));
+        }
+
+        default:
+            return queue_response(c, h, BCML_IPC_BAD_REQUEST, NULL, 0);
+    }
+}
+
+// Handle every complete frame in the input buffer; false drops the connection
+static bool process_input(bcmld_conn_t* c) {
+    size_t off = 0;
+    while (c->in.len - off >= BCML_IPC_HDR_SIZE) {
+        bcml_ipc_hdr_t h;
+        if (!bcml_ipc_get_hdr(c->in.data + off, &h)) {
+            BCML_LOG_WARN("bcmld: bad frame header on fd %d\n", c->fd);
+            return false;
+        }
+        if (c->in.len - off < BCML_IPC_HDR_SIZE + h.len)
+            break;
+        if (!handle_request(c, &h, (const char*)c->in.data + off + BCML_IPC_HDR_SIZE))
+            return false;
+        off += BCML_IPC_HDR_SIZE + h.len;
+    }
+    memmove(c->in.data, c->in.data + off, c->in.len - off);
+    c->in.len -= off;
+    return true;
+}
+
+static bool flush_output(bcmld_conn_t* c) {
+    while (c->out_off < c->out.len) {
+        ssize_t n = send(c->fd, c->out.data + c->out_off, c->out.len - c->out_off, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+            return false;
+        }
+        c->out_off += (size_t)n;
+    }
+    c->out.len = 0;
+    c->out_off = 0;
+    return true;
+}
+
+static bool read_input(bcmld_conn_t* c) {
+    for (;;) {
+        if (!buf_reserve(&c->in, BCMLD_READ_CHUNK))
+            return false;
+        ssize_t n = recv(c->fd, c->in.data + c->in.len, c->in.cap - c->in.len, 0);
+        if (n == 0)
+            return false;
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return errno == EAGAIN || errno == EWOULDBLOCK;
+        }
+        c->in.len += (size_t)n;
+        if (!process_input(c))
+            return false;
+        if ((size_t)n < BCMLD_READ_CHUNK || c->out.len >= BCMLD_OUT_HIGH)
+            return true;
+    }
+}
+
+static void close_conn(int i) {
+    bcmld_conn_t* c = &g_conns[i];
+    BCML_LOG_DEBUG("bcmld: client fd %d closed\n", c->fd);
+    close(c->fd);
+    free(c->in.data);
+    free(c->out.data);
+    g_conns[i] = g_conns[--g_nconns];
+    memset(&g_conns[g_nconns], 0, sizeof(g_conns[g_nconns]));
+}
+
+static void accept_clients(int lfd) {
+    for (;;) {
+        int fd = accept(lfd, NULL, NULL);
+        if (fd < 0)
+            return;
+        if (g_nconns >= BCMLD_MAX_CLIENTS) {
+            BCML_LOG_WARN("bcmld: too many clients, rejecting\n");
+            close(fd);
+            continue;
+        }
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+        fcntl(fd, F_SETFD, FD_CLOEXEC);
+        memset(&g_conns[g_nconns], 0, sizeof(g_conns[g_nconns]));
+        g_conns[g_nconns++].fd = fd;
+        BCML_LOG_DEBUG("bcmld: client fd %d connected\n", fd);
+    }
+}
+
+static int listen_socket(const char* path) {
+    struct sockaddr_un addr = { .sun_family = AF_UNIX };
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        BCML_LOG_ERROR("bcmld: socket path too long: %s\n", path);
+        return -1;
+    }
+    snprintf(addr.sun_path, sizeof(addr.sun_path), "%s", path);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0)
+        return -1;
+    unlink(path);
+    mode_t old = umask(0117);   // srw-rw----
+    int rc = bind(fd, (struct sockaddr*)&addr, sizeof(addr));
+    umask(old);
+    if (rc < 0 || listen(fd, 32) < 0) {
+        BCML_LOG_ERROR("bcmld: cannot listen on %s: %s\n", path, strerror(errno));
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr,
+            "Usage: %s [-s socket] [-b backend] [-c cache_ms] [-p shm_name] [-j journal [-k keep]] [-C country] [-t trace] [-v level]\n"
+            "  -s PATH  listen socket (default: %s)\n"
+            "  -b NAME  southbound backend for every config type\n"
+            "  -c MS    cache reads of the -b backend for MS milliseconds (0: until the next set)\n"
+            "  -p NAME  publish the config snapshot to shared memory NAME (e.g. %s),\n"
+            "           mode 0640: readers must be in bcmld's group\n"
+            "  -j PATH  journal applied configs to PATH, enabling rollback\n"
+            "  -k N     configs to keep per type in the journal (default: %d)\n"
+            "  -C CC    check radio settings against regulatory domain CC, 00 for world (default: no check)\n"
+            "  -t PATH  record every request to PATH for bcml-replay\n"
+            "  -v N     log level 0=error .. 3=debug (default: 1)\n",
+            prog, BCMLD_SOCKET_PATH, BCML_SNAPSHOT_SHM_NAME, BCML_JOURNAL_KEEP_DEFAULT);
+}
+
+int main(int argc, char** argv) {
+    const char* path = BCMLD_SOCKET_PATH;
+    const char* backend = NULL;
+    const char* snapshot = NULL;
+    const char* journal = NULL;
+    const char* country = NULL;
+    const char* trace = NULL;
+    long keep = 0;
+    long cache_ms = -1;
+    int level = LOG_LEVEL_WARN;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "s:b:c:p:j:k:C:t:v:h")) != -1) {
+        switch (opt) {
+            case 's': path = optarg; break;
+            case 'b': backend = optarg; break;
+            case 'c': cache_ms = strtol(optarg, NULL, 10); break;
+            case 'p': snapshot = optarg; break;
+            case 'j': journal = optarg; break;
+            case 'k': keep = strtol(optarg, NULL, 10); break;
+            case 'C': country = optarg; break;
+            case 't': trace = optarg; break;
+            case 'v': level = atoi(optarg); break;
+            default:
+                usage(argv[0]);
+                return opt == 'h' ? 0 : 1;
+        }
+    }
+    bcml_set_log_level((log_level_t)level);
+
+    if (backend && !bcml_sb_select(NULL, backend)) {
+        BCML_LOG_ERROR("bcmld: unknown backend '%s'\n", backend);
+        return 1;
+    }
+    if (cache_ms >= 0) {
+        // The cache wraps a named backend, so -c needs -b
+        if (!backend || !bcml_sb_register_cache(BCMLD_CACHE_NAME, backend, (unsigned int)cache_ms) ||
+            !bcml_sb_select(NULL, BCMLD_CACHE_NAME)) {
+            BCML_LOG_ERROR("bcmld: cannot set up read cache (-c requires -b)\n");
+            return 1;
+        }
+    }
+
+    if (country && !bcml_wireless_set_country(country))
+        return 1;
+
+    if (journal && (keep < 0 || keep > UINT_MAX || !bcml_journal_open(journal, (unsigned int)keep)))
+        return 1;
+
+    // Same access as the socket: readers share bcmld's group
+    if (snapshot && !bcml_snapshot_publisher_open(snapshot, BCMLD_SNAPSHOT_MODE))
+        return 1;
+    // Opened first so the warm-up fetches are in the trace too
+    if (trace && !bcml_trace_open(trace))
+        return 1;
+    // Transports up and every config fetched once, which also primes the
+    // snapshot so readers have something before the first request
+    if (!bcml_init(BCML_INIT_WARM))
+        return 1;
+
+    struct sigaction sa = { .sa_handler = on_signal };
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+
+    int lfd = listen_socket(path);
+    if (lfd < 0)
+        return 1;
+    BCML_LOG_INFO("bcmld: listening on %s\n", path);
+
+    struct pollfd pfds[BCMLD_MAX_CLIENTS + 1];
+    while (!g_stop) {
+        pfds[0].fd = lfd;
+        pfds[0].events = POLLIN;
+        for (int i = 0; i < g_nconns; ++i) {
+            bcmld_conn_t* c = &g_conns[i];
+            pfds[i + 1].fd = c->fd;
+            pfds[i + 1].events = (c->out.len < BCMLD_OUT_HIGH ? POLLIN : 0) |
+                                 (c->out_off < c->out.len ? POLLOUT : 0);
+            pfds[i + 1].revents = 0;
+        }
+        int nfds = g_nconns + 1;
+        if (poll(pfds, (nfds_t)nfds, -1) < 0) {
+            if (errno == EINTR)
+                continue;
+            BCML_LOG_ERROR("bcmld: poll: %s\n", strerror(errno));
+            break;
+        }
+
+        // Walk backwards so close_conn()'s swap-with-last is safe
+        for (int i = nfds - 2; i >= 0; --i) {
+            bcmld_conn_t* c = &g_conns[i];
+            short re = pfds[i + 1].revents;
+            bool ok = true;
+            if (re & (POLLIN | POLLHUP | POLLERR))
+                ok = read_input(c);
+            if (ok && c->out_off < c->out.len)
+                ok = flush_output(c);
+            if (!ok)
+                close_conn(i);
+        }
+        if (pfds[0].revents & POLLIN)
+            accept_clients(lfd);
+    }
+
+    BCML_LOG_INFO("bcmld: shutting down\n");
+    while (g_nconns)
+        close_conn(g_nconns - 1);
+    close(lfd);
+    unlink(path);
+    // Closes the journal and the publisher; the segment stays, so readers keep
+    // the last snapshot across daemon restarts
+    bcml_shutdown();
+    return 0;
+}
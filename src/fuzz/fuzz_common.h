@@ -0,0 +1,24 @@
+#ifndef FUZZ_COMMON_H
+#define FUZZ_COMMON_H
+
+#include "bcml_log.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// The entry points take NUL-terminated strings; fuzz inputs are raw bytes.
+static inline char* fuzz_cstring(const uint8_t* data, size_t size) {
+    char* s = malloc(size + 1);
+    if (!s)
+        abort();
+    memcpy(s, data, size);
+    s[size] = '\0';
+    return s;
+}
+
+// Logging is pure overhead while fuzzing
+static inline void fuzz_quiet(void) {
+    bcml_set_log_level(LOG_LEVEL_NONE);
+}
+
+#endif // FUZZ_COMMON_H
@@ -0,0 +1,130 @@
+// Differential fuzz target for wireless JSON parsers/serializers.
+//
+// The cJSON-based validate/parse/export functions are the reference. An
+// implementation may bring a stricter validator; it must never accept what the
+// reference rejects. For any input accepted by both validators it must:
+//   1. accept it and decode exactly the same bcml_wireless_cfg_t as the reference,
+//   2. serialize that config to exactly the reference's JSON (the exporter's
+//      fragment cache carries over from earlier inputs), which the reference
+//      decodes back to the same config,
+//   3. round-trip its own output to the same config.
+// The reference config must also survive the journal's binary delta encoding,
+// both self-contained and against the previous input's config.
+// If it is also valid UTF-8 (the scan validator), it must survive the CBOR
+// form, which follows the same schema.
+// Any mismatch aborts, so libFuzzer/AFL report it as a crash.
+//
+// To check a new parser or serializer, add it to diff_impls[].
+
+#include "fuzz_common.h"
+#include "validator_wireless.h"
+#include "parse_wireless_json.h"
+#include "export_wireless_json.h"
+#include "wireless_cbor.h"
+#include "wireless_codec.h"
+#include "bcml_wireless.h"
+#include <stdio.h>
+
+#define DIFF_OUT_SIZE 8192
+
+// Config of the previous valid input, the base for the next delta
+static bcml_wireless_cfg_t g_prev_cfg = BCML_WIRELESS_CFG_INIT;
+
+typedef struct {
+    const char* name;
+    bool (*validate)(const char* json, const char* schema_path);
+    bool (*parse)(const char* json, void* sdata);
+    bool (*export_json)(const void* sdata, char* json_buffer, size_t buffer_size);
+} diff_impl_t;
+
+static const diff_impl_t diff_ref = {
+    "cjson", validate_wireless_json_cjson, parse_wireless_json_cjson, export_wireless_json_full
+};
+
+static const diff_impl_t diff_impls[] = {
+    // Reference against itself: round-trip stability
+    { "cjson", validate_wireless_json_cjson, parse_wireless_json_cjson, export_wireless_json },
+    // Structural-index (json_scan) decoder
+    { "scan", validate_wireless_json_scan, parse_wireless_json_scan, export_wireless_json },
+};
+
+static void diff_fail(const diff_impl_t* impl, const char* what) {
+    fprintf(stderr, "fuzz_diff_wireless: %s: %s\n", impl->name, what);
+    abort();
+}
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static char ref_out[DIFF_OUT_SIZE];
+    static char impl_out[DIFF_OUT_SIZE];
+    static uint8_t delta[WIRELESS_DELTA_MAX];
+    static uint8_t bin[DIFF_OUT_SIZE];
+    bcml_wireless_cfg_t ref_cfg = BCML_WIRELESS_CFG_INIT;
+    bcml_wireless_cfg_t impl_cfg = BCML_WIRELESS_CFG_INIT;
+    bcml_wireless_cfg_t back_cfg = BCML_WIRELESS_CFG_INIT;
+
+    fuzz_quiet();
+    char* json = fuzz_cstring(data, size);
+    bool ref_valid = diff_ref.validate(json, NULL);
+    for (size_t i = 0; i < sizeof(diff_impls) / sizeof(diff_impls[0]); ++i) {
+        if (!ref_valid && diff_impls[i].validate(json, NULL))
+            diff_fail(&diff_impls[i], "accepts input the reference validator rejects");
+    }
+    if (!ref_valid)
+        goto out;
+
+    if (!diff_ref.parse(json, &ref_cfg))
+        diff_fail(&diff_ref, "validated input rejected by reference parser");
+    if (!diff_ref.export_json(&ref_cfg, ref_out, sizeof(ref_out)))
+        diff_fail(&diff_ref, "reference export failed");
+
+    size_t delta_len = wireless_delta_encode(NULL, &ref_cfg, delta);
+    if (!delta_len || !wireless_delta_apply(&back_cfg, delta, delta_len) || !wireless_cfg_equal(&ref_cfg, &back_cfg))
+        diff_fail(&diff_ref, "self-contained delta does not round-trip");
+    delta_len = wireless_delta_encode(&g_prev_cfg, &ref_cfg, delta);
+    if (!delta_len || !wireless_delta_apply(&g_prev_cfg, delta, delta_len) || !wireless_cfg_equal(&ref_cfg, &g_prev_cfg))
+        diff_fail(&diff_ref, "delta against the previous config does not round-trip");
+    size_t bin_len;
+    if (validate_wireless_json_scan(json, NULL) &&
+        (!export_wireless_cbor(&ref_cfg, bin, sizeof(bin), &bin_len) || !parse_wireless_cbor(bin, bin_len, &back_cfg) ||
+         !wireless_cfg_equal(&ref_cfg, &back_cfg)))
+        diff_fail(&diff_ref, "CBOR form does not round-trip");
+
+    for (size_t i = 0; i < sizeof(diff_impls) / sizeof(diff_impls[0]); ++i) {
+        const diff_impl_t* impl = &diff_impls[i];
+
+        // Inputs only the reference accepts (e.g. trailing data, invalid UTF-8) are out of scope
+        if (!impl->validate(json, NULL))
+            continue;
+
+        // 1. Decode must match the reference
+        if (!impl->parse(json, &impl_cfg))
+            diff_fail(impl, "validated input rejected");
+        if (!wireless_cfg_equal(&ref_cfg, &impl_cfg))
+            diff_fail(impl, "decoded config differs from reference");
+
+        // 2. Output must mean the same thing to the reference parser
+        if (!impl->export_json(&impl_cfg, impl_out, sizeof(impl_out)))
+            diff_fail(impl, "export failed");
+        if (strcmp(impl_out, ref_out) != 0)
+            diff_fail(impl, "exported JSON differs from the reference output");
+        if (!diff_ref.parse(impl_out, &back_cfg) || !wireless_cfg_equal(&ref_cfg, &back_cfg))
+            diff_fail(impl, "exported JSON decodes differently in reference");
+        if (!diff_ref.validate(impl_out, NULL) || !impl->validate(impl_out, NULL))
+            diff_fail(impl, "exported JSON fails validation");
+
+        // 3. Own round trip, including decoding the reference output
+        if (!impl->parse(impl_out, &back_cfg) || !wireless_cfg_equal(&ref_cfg, &back_cfg))
+            diff_fail(impl, "round trip of own output differs");
+        if (!impl->validate(ref_out, NULL))
+            diff_fail(impl, "reference output fails validation");
+        if (!impl->parse(ref_out, &back_cfg) || !wireless_cfg_equal(&ref_cfg, &back_cfg))
+            diff_fail(impl, "decoding reference output differs");
+    }
+
+out:
+    bcml_wireless_cfg_free(&ref_cfg);
+    bcml_wireless_cfg_free(&impl_cfg);
+    bcml_wireless_cfg_free(&back_cfg);
+    free(json);
+    return 0;
+}
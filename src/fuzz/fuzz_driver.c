@@ -0,0 +1,46 @@
+// Standalone / AFL driver for the LLVMFuzzerTestOneInput targets.
+// Used when the compiler has no libFuzzer (gcc, afl-gcc, afl-clang-fast without -fsanitize=fuzzer).
+//
+//   fuzz_xxx file...      run each file once (corpus replay / crash reproduction)
+//   fuzz_xxx < input      run stdin once (AFL: afl-fuzz -i corpus -o out -- ./fuzz_xxx)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+#define FUZZ_MAX_INPUT (1 << 20)
+
+static int run_stream(FILE* fp) {
+    uint8_t* buf = malloc(FUZZ_MAX_INPUT);
+    if (!buf)
+        return 1;
+    size_t len = fread(buf, 1, FUZZ_MAX_INPUT, fp);
+    LLVMFuzzerTestOneInput(buf, len);
+    free(buf);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+#ifdef __AFL_COMPILER
+        // AFL++ persistent mode
+        while (__AFL_LOOP(10000))
+            run_stream(stdin);
+        return 0;
+#else
+        return run_stream(stdin);
+#endif
+    }
+    for (int i = 1; i < argc; ++i) {
+        FILE* fp = fopen(argv[i], "rb");
+        if (!fp) {
+            perror(argv[i]);
+            return 1;
+        }
+        run_stream(fp);
+        fclose(fp);
+    }
+    return 0;
+}
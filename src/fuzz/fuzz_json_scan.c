@@ -0,0 +1,49 @@
+// Fuzz target: json_scan() implementations and the scan-based validator.
+//
+// For any input:
+//   1. scalar, SSE2 and AVX2 stage 1 must agree on the verdict and the index
+//      (implementations the CPU lacks fall back to scalar);
+//   2. skipping the root value over the index must never read out of bounds;
+//   3. the scan validator is stricter than the cJSON reference (RFC 8259, UTF-8),
+//      never more permissive: accepted by scan => accepted by cJSON.
+
+#include "fuzz_common.h"
+#include "json_scan.h"
+#include "validator_wireless.h"
+#include <stdio.h>
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static const json_scan_impl_t impls[] = { JSON_SCAN_SSE2, JSON_SCAN_AVX2 };
+    json_scan_t ref, scan;
+    json_cur_t cur;
+
+    fuzz_quiet();
+    char* json = fuzz_cstring(data, size);
+    json_scan_init(&ref);
+    json_scan_init(&scan);
+
+    bool ok = json_scan(&ref, json, size, JSON_SCAN_SCALAR);
+    for (size_t k = 0; k < sizeof(impls) / sizeof(impls[0]); ++k) {
+        bool impl_ok = json_scan(&scan, json, size, impls[k]);
+        if (impl_ok != ok || scan.count != ref.count ||
+            (ok && memcmp(scan.pos, ref.pos, ref.count * sizeof(ref.pos[0])) != 0)) {
+            fprintf(stderr, "fuzz_json_scan: %s disagrees with scalar\n", json_scan_impl_name(impls[k]));
+            abort();
+        }
+    }
+
+    if (ok) {
+        json_cur_init(&cur, &ref);
+        json_cur_skip(&cur);
+    }
+
+    if (validate_wireless_json_scan(json, NULL) && !validate_wireless_json_cjson(json, NULL)) {
+        fprintf(stderr, "fuzz_json_scan: scan validator accepts input the reference rejects\n");
+        abort();
+    }
+
+    json_scan_free(&scan);
+    json_scan_free(&ref);
+    free(json);
+    return 0;
+}
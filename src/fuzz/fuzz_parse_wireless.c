@@ -0,0 +1,43 @@
+// Fuzz target: parse_wireless_json(), then export, regulatory check and compact round trip
+// of whatever was parsed
+#include "fuzz_common.h"
+#include "parse_wireless_json.h"
+#include "export_wireless_json.h"
+#include "wireless_codec.h"
+#include "bcml_compact.h"
+#include "bcml_wireless.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static char out[8192];
+    bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+    bcml_wireless_cfg_t back = BCML_WIRELESS_CFG_INIT;
+    bcml_wireless_limits_t limits;
+
+    fuzz_quiet();
+    char* json = fuzz_cstring(data, size);
+    if (parse_wireless_json(json, &cfg)) {
+        // Counts stay within the runtime limits, every string is terminated inside its buffer
+        bcml_wireless_get_limits(&limits);
+        if (cfg.radio_count > limits.max_radio || cfg.ssid_count > limits.max_ssid)
+            abort();
+        for (int i = 0; i < cfg.ssid_count; ++i) {
+            if (!memchr(cfg.ssid[i].ssid, '\0', sizeof(cfg.ssid[i].ssid)) ||
+                !memchr(cfg.ssid[i].password, '\0', sizeof(cfg.ssid[i].password)))
+                abort();
+        }
+        export_wireless_json(&cfg, out, sizeof(out));
+        // Any value, however far out of range, is a plain rejection
+        bcml_wireless_regdom_check(&cfg);
+
+        // The compact form is lossless and hashes like the full struct
+        bcml_wireless_compact_t* c = bcml_wireless_compact_encode(&cfg);
+        if (!c || !bcml_wireless_compact_decode(c, &back) || !wireless_cfg_equal(&cfg, &back) ||
+            bcml_wireless_compact_hash(c) != bcml_wireless_cfg_hash(&cfg))
+            abort();
+        bcml_wireless_compact_free(c);
+    }
+    bcml_wireless_cfg_free(&cfg);
+    bcml_wireless_cfg_free(&back);
+    free(json);
+    return 0;
+}
@@ -0,0 +1,35 @@
+// Fuzz target: parse_wireless_cbor(). A document it accepts must re-encode to
+// CBOR that decodes to the same config, and its JSON export must pass the JSON
+// validators and parse back to the same config: both forms follow one schema.
+#include "fuzz_common.h"
+#include "wireless_cbor.h"
+#include "validator_wireless.h"
+#include "parse_wireless_json.h"
+#include "export_wireless_json.h"
+#include "wireless_codec.h"
+#include "bcml_wireless.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    static uint8_t bin[8192];
+    static char json[8192];
+    bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+    bcml_wireless_cfg_t back = BCML_WIRELESS_CFG_INIT;
+    size_t len;
+
+    fuzz_quiet();
+    bool valid = validate_wireless_cbor(data, size);
+    if (parse_wireless_cbor(data, size, &cfg) != valid)
+        abort();
+    if (valid) {
+        if (!export_wireless_cbor(&cfg, bin, sizeof(bin), &len) || !parse_wireless_cbor(bin, len, &back) ||
+            !wireless_cfg_equal(&cfg, &back))
+            abort();
+        if (!export_wireless_json_full(&cfg, json, sizeof(json)) || !validate_wireless_json_cjson(json, NULL) ||
+            !validate_wireless_json_scan(json, NULL) || !parse_wireless_json_cjson(json, &back) ||
+            !wireless_cfg_equal(&cfg, &back))
+            abort();
+    }
+    bcml_wireless_cfg_free(&cfg);
+    bcml_wireless_cfg_free(&back);
+    return 0;
+}
@@ -0,0 +1,25 @@
+// Fuzz target: REST backend decoding of a wireless GET response
+#include "fuzz_common.h"
+#include "restapi/sb_ops_restapi.h"
+#include "bcml_wireless.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    bcml_wireless_cfg_t cfg = BCML_WIRELESS_CFG_INIT;
+
+    fuzz_quiet();
+    char* body = fuzz_cstring(data, size);
+    // Decoder must not rely on zeroed entries: start from a full config of garbage
+    bcml_wireless_cfg_resize(&cfg, BCML_RADIO_LIMIT, BCML_SSID_LIMIT);
+    memset(cfg.radio, 0xa5, sizeof(*cfg.radio) * BCML_RADIO_LIMIT);
+    memset(cfg.ssid, 0xa5, sizeof(*cfg.ssid) * BCML_SSID_LIMIT);
+    if (rest_decode_wireless_json(body, &cfg)) {
+        for (int i = 0; i < cfg.ssid_count; ++i) {
+            if (!memchr(cfg.ssid[i].ssid, '\0', sizeof(cfg.ssid[i].ssid)) ||
+                !memchr(cfg.ssid[i].password, '\0', sizeof(cfg.ssid[i].password)))
+                abort();
+        }
+    }
+    bcml_wireless_cfg_free(&cfg);
+    free(body);
+    return 0;
+}
@@ -0,0 +1,11 @@
+// Fuzz target: validate_wireless_json()
+#include "fuzz_common.h"
+#include "validator_wireless.h"
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    fuzz_quiet();
+    char* json = fuzz_cstring(data, size);
+    validate_wireless_json(json, NULL);
+    free(json);
+    return 0;
+}
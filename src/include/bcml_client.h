@@ -0,0 +1,48 @@
+#ifndef _BCML_CLIENT_H_
+#define _BCML_CLIENT_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// libbcml_client: talks to bcmld over its Unix domain socket.
+//
+// Link against bcml_client instead of bcml and bcml_config.h works unchanged:
+// bcml_config_set()/get()/get_many()/rollback() and the _bin variants are forwarded to the daemon, which owns
+// the handlers, backend connections and caches. One connection per process,
+// opened by bcml_init() or on first use and shared by all threads (calls are
+// serialized); bcml_shutdown() closes it.
+//
+// Socket path: bcml_client_set_socket_path(), else $BCMLD_SOCKET, else
+// BCMLD_SOCKET_PATH ("/var/run/bcml/bcmld.sock").
+
+/**
+ * @brief Use another daemon socket; closes the current connection.
+ * @param path  Socket path, or NULL to go back to the default.
+ * @return false if the path does not fit in sockaddr_un.
+ */
+bool bcml_client_set_socket_path(const char* path);
+
+// Close the daemon connection (reopened on the next call)
+void bcml_client_close(void);
+
+// One request of a pipelined batch
+typedef struct {
+    const char* type;       // Config type
+    const char* json;       // set: JSON to apply; get: NULL
+    char* buffer;           // get: output buffer (NULL for set)
+    size_t buffer_size;
+    bool ok;                // Result, filled by bcml_client_batch()
+    bool bin;               // Binary form (bcml_config_set_bin()): json holds len bytes of
+                            // CBOR, a get stores CBOR in buffer (no terminator)
+    size_t len;             // bin set: size of json; bin get: set to the bytes received
+} bcml_client_req_t;
+
+/**
+ * @brief Send all requests back to back, then collect the responses.
+ *        Requests are applied by the daemon in array order.
+ * @return false if the daemon could not be reached or the connection broke;
+ *         per-request results are in reqs[i].ok.
+ */
+bool bcml_client_batch(bcml_client_req_t* reqs, size_t count);
+
+#endif // _BCML_CLIENT_H_
@@ -0,0 +1,66 @@
+#ifndef _BCML_COMPACT_H_
+#define _BCML_COMPACT_H_
+
+#include "bcml_types.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Compact canonical form of a wireless config.
+//
+// Radios and SSIDs are packed back to back: flags as bits, integers as
+// varints, strings length-prefixed; a zeroed entry packs to a few bytes.
+// A typical config takes ~100 bytes, which is what to keep resident when
+// tracking many devices.
+//
+// Equal configs (same counts, same entries) have identical bytes and an
+// identical 64-bit content hash. The hash is a term for the counts plus the
+// sum of per-entry hashes, so replacing one entry updates it in O(1). It is
+// stable across builds and hosts, so it can serve as a cache key, for change
+// detection, or for fleet-wide dedup.
+
+typedef struct bcml_wireless_compact bcml_wireless_compact_t;
+
+// Changed entries between two configs, bit i = entry i (BCML_SSID_LIMIT <= 32)
+typedef struct {
+    uint32_t radios;
+    uint32_t ssids;
+} bcml_wireless_diff_t;
+
+// Encode a config; NULL on allocation failure. Free with bcml_wireless_compact_free().
+bcml_wireless_compact_t* bcml_wireless_compact_encode(const bcml_wireless_cfg_t* cfg);
+
+// Decode back into a config, resized to the encoded counts
+bool bcml_wireless_compact_decode(const bcml_wireless_compact_t* c, bcml_wireless_cfg_t* cfg);
+
+void bcml_wireless_compact_free(bcml_wireless_compact_t* c);
+
+uint64_t bcml_wireless_compact_hash(const bcml_wireless_compact_t* c);
+
+// Heap bytes held by c
+size_t bcml_wireless_compact_size(const bcml_wireless_compact_t* c);
+
+// Content hash of a full config, same value as its compact form, without allocating
+uint64_t bcml_wireless_cfg_hash(const bcml_wireless_cfg_t* cfg);
+
+/**
+ * @brief Replace one radio/SSID entry in place, updating the hash incrementally.
+ *        An index at or past the count appends, padding with zeroed entries.
+ * @param c  Compact config; may be reallocated.
+ * @return false on a bad index or allocation failure (c unchanged).
+ */
+bool bcml_wireless_compact_set_radio(bcml_wireless_compact_t** c, int index, const bcml_wireless_radio_t* radio);
+bool bcml_wireless_compact_set_ssid(bcml_wireless_compact_t** c, int index, const bcml_wireless_ssid_t* ssid);
+
+// Content equality: hash first, bytes only when the hashes match
+bool bcml_wireless_compact_equal(const bcml_wireless_compact_t* a, const bcml_wireless_compact_t* b);
+
+/**
+ * @brief Which entries differ between a and b (present in only one counts as differing).
+ * @param diff  Optional, receives the changed radio/SSID indices.
+ * @return true if anything differs.
+ */
+bool bcml_wireless_compact_diff(const bcml_wireless_compact_t* a, const bcml_wireless_compact_t* b,
+                                bcml_wireless_diff_t* diff);
+
+#endif // _BCML_COMPACT_H_
@@ -4,6 +4,33 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+// bcml_init() flags
+#define BCML_INIT_WARM      0x1u    // Fetch every config type from its backend during init
+#define BCML_INIT_NO_ATEXIT 0x2u    // Do not register bcml_shutdown() with atexit()
+
+/**
+ * @brief Do the setup that would otherwise be paid by the first requests:
+ *        load the schema limits, initialize the backends' transports (libcurl
+ *        global state and a pooled connection, or the UDS connection) and,
+ *        with BCML_INIT_WARM, fetch every config type so the snapshot, the
+ *        export cache and the backends' ETag/section hashes are primed.
+ *        Optional; calling it again before bcml_shutdown() does nothing.
+ * @param flags  BCML_INIT_* flags.
+ * @return false if a backend cannot be initialized. A failed warm fetch (e.g.
+ *         the device is not up yet) is only logged.
+ */
+bool bcml_init(unsigned int flags);
+
+/**
+ * @brief Release what the library holds: closes the apply journal and the
+ *        snapshot publisher if open, shuts the backends' transports down and
+ *        frees the cached configs. Safe to call more than once and without
+ *        bcml_init(); registered with atexit() by bcml_init(). No other bcml
+ *        call may be running. The library can be initialized and used again
+ *        afterwards.
+ */
+void bcml_shutdown(void);
+
 /**
  * @brief Set the configuration data of a specific type (in JSON format).
  * @param type        Configuration type string (e.g., "wireless", "display", ...)
@@ -21,5 +48,71 @@ bool bcml_config_set(const char* type, const char* json_data);
  */
 bool bcml_config_get(const char* type, char* json_buffer, size_t buffer_size);
 
+// One type of a bcml_config_get_many() call
+typedef struct {
+    const char* type;       // Configuration type string
+    char* buffer;           // Buffer for output JSON, as bcml_config_get()
+    size_t buffer_size;
+    bool ok;                // Result, filled by bcml_config_get_many()
+} bcml_config_get_t;
+
+/**
+ * @brief Get several config types in one call, as bcml_config_get() each, in
+ *        order. A type listed twice is fetched once and copied; an unknown
+ *        type fails its own entry only.
+ * @param reqs   Types to get; results in reqs[i].buffer and reqs[i].ok.
+ * @param count  Number of requests.
+ * @return true if every type was fetched and exported.
+ */
+bool bcml_config_get_many(bcml_config_get_t* reqs, size_t count);
+
+/**
+ * @brief Same, into one document merging each type's JSON (each already
+ *        wrapped in its type): {"wireless":{...},"display":{...}}. Each
+ *        type's JSON may take up to 64 KB.
+ * @param types        Configuration type strings
+ * @param count        Number of types
+ * @param json_buffer  Buffer for output JSON
+ * @param buffer_size  Buffer size in bytes
+ * @return true on success, false if any type fails or the document does not fit
+ */
+bool bcml_config_get_many_json(const char* const* types, size_t count, char* json_buffer, size_t buffer_size);
+
+/**
+ * @brief Set a config from its binary form: CBOR (RFC 8949) encoding of the same
+ *        document as the JSON form, e.g. {"wireless":{"radio":[...],"ssid":[...]}}
+ *        with the same keys as CBOR text strings, integers, booleans, arrays and
+ *        maps of definite length. The same schema rules apply; the document is
+ *        decoded straight into the config structure, without JSON text.
+ * @param type  Configuration type string
+ * @param data  CBOR document
+ * @param len   Size of data in bytes
+ * @return true on success, false on failure (also for types without a binary form)
+ */
+bool bcml_config_set_bin(const char* type, const void* data, size_t len);
+
+/**
+ * @brief Get the configuration data of a specific type in its binary (CBOR) form,
+ *        see bcml_config_set_bin().
+ * @param type         Configuration type string
+ * @param buffer       Output buffer
+ * @param buffer_size  Buffer size in bytes
+ * @param len          Optional, set to the number of bytes written (0 on failure)
+ * @return true on success, false on failure
+ */
+bool bcml_config_get_bin(const char* type, void* buffer, size_t buffer_size, size_t* len);
+
+/**
+ * @brief Re-apply an earlier config from the apply journal (see bcml_journal.h),
+ *        without going through JSON. The restored config is journaled as the
+ *        newest generation, so rolling back by 1 again undoes the rollback.
+ * @param type         Configuration type string
+ * @param generations  0 = the last config successfully applied (e.g. after a
+ *                     failed set), 1 = the one before, ...
+ * @return false if no journal is open, it does not reach back that far, or the
+ *         southbound set fails.
+ */
+bool bcml_config_rollback(const char* type, unsigned int generations);
+
 #endif // _BCML_CONFIG_H_
 
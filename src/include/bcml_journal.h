@@ -0,0 +1,66 @@
+#ifndef _BCML_JOURNAL_H_
+#define _BCML_JOURNAL_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Append-only journal of applied configs.
+//
+// Once a journal is open, every config that bcml_config_set() (or a rollback)
+// gets through the southbound is appended as a checksummed record, and the
+// call returns only after the record is on disk. Records hold binary deltas
+// against the previously applied config of the same type, with a
+// self-contained checkpoint every BCML_JOURNAL_CHECKPOINT_EVERY records, so
+// bcml_config_rollback() restores an earlier config by replaying a few small
+// records instead of parsing JSON.
+//
+// Concurrent appends share one fsync (group commit). A background thread
+// compacts the file once it holds about twice the retained history, without
+// blocking appends for more than the copy of the records added meanwhile.
+// A torn or corrupt tail left by a crash is cut off when the journal is opened.
+
+// Record types (one per journaled config type)
+#define BCML_JOURNAL_TAG_WIRELESS 1
+
+// Deltas between two self-contained checkpoints
+#define BCML_JOURNAL_CHECKPOINT_EVERY 32
+
+// Default number of configs kept per type
+#define BCML_JOURNAL_KEEP_DEFAULT 64
+
+/**
+ * @brief Open (or create) the journal and start appending to it.
+ * @param path  Journal file.
+ * @param keep  Configs to keep per type across compactions (0 = BCML_JOURNAL_KEEP_DEFAULT).
+ * @return false if the file cannot be opened or is not a journal.
+ */
+bool bcml_journal_open(const char* path, unsigned keep);
+
+// Stop journaling; waits for a running compaction
+void bcml_journal_close(void);
+
+bool bcml_journal_is_open(void);
+
+/**
+ * @brief Append one record and wait until it is durable.
+ * @param full  data is self-contained (a checkpoint), not a delta.
+ * @return false on I/O error.
+ */
+bool bcml_journal_append(uint8_t tag, bool full, const void* data, size_t len);
+
+// Whether the next record of this tag should be a checkpoint
+bool bcml_journal_want_checkpoint(uint8_t tag);
+
+/**
+ * @brief Replay the records that rebuild a journaled config: the checkpoint at
+ *        or before it, then every delta up to it.
+ * @param generations  0 for the latest record of the tag, 1 for the one before, ...
+ * @param apply        Called once per record in order; full marks the checkpoint.
+ * @return false if the journal does not reach that far back, on a read or
+ *         checksum error, or if apply fails.
+ */
+bool bcml_journal_replay(uint8_t tag, unsigned generations,
+                         bool (*apply)(void* ctx, bool full, const uint8_t* data, size_t len), void* ctx);
+
+#endif // _BCML_JOURNAL_H_
@@ -6,6 +6,7 @@ extern "C" {
 #endif
 
 typedef enum {
+    LOG_LEVEL_NONE  = -1, // Disable all output
     LOG_LEVEL_ERROR = 0,
     LOG_LEVEL_WARN  = 1,
     LOG_LEVEL_INFO  = 2,
@@ -0,0 +1,69 @@
+#ifndef _BCML_PROBE_H_
+#define _BCML_PROBE_H_
+
+// USDT (sys/sdt.h) static tracepoints, provider "bcml".
+//
+// Built with BCML_USDT (CMake option, on when sys/sdt.h is found) every probe
+// is a single nop plus an ELF note that bpftrace/perf/SystemTap attach to; the
+// arguments live in registers or on the stack already and are not computed
+// for the probe. An argument that costs something (a strlen) is guarded by
+// BCML_PROBE_ENABLED(), a load of the probe's semaphore, which tracers raise
+// while attached. Without BCML_USDT everything here compiles to nothing.
+//
+// Probes come in start/done pairs around each stage; a thread handles a stage
+// from start to done, so per-thread timestamps give the stage latency
+// (src/trace/bcml_stages.bt). Strings are NUL-terminated, sizes in bytes.
+//
+//   set__start      (type, json_len)           bcml_config_set(), _set_bin() (CBOR size)
+//   set__done       (type, ok)
+//   get__start      (type, buffer_size)        bcml_config_get(), _get_bin()
+//   get__done       (type, ok)
+//   validate__start (type, json_len)           schema validation (set input, get output)
+//   validate__done  (type, ok)
+//   parse__start    (type, json_len)           JSON (or CBOR, validating too) to config
+//   parse__done     (type, ok)
+//   sb__set__start  (type, backend)            southbound apply
+//   sb__set__done   (type, ok)
+//   sb__get__start  (type, backend)            southbound fetch
+//   sb__get__done   (type, status)             sb_get_status_t
+//   export__start   (type)                     export_wireless_json()
+//   export__done    (type, json_len, ok)       json_len 0 on failure
+//   rest__start     (method, url, body_len)    one REST request (rest_client_*)
+//   rest__done      (method, http_status, response_len)   http_status 0: transport error
+
+#define BCML_PROBE_LIST(X) \
+    X(set__start) X(set__done) \
+    X(get__start) X(get__done) \
+    X(validate__start) X(validate__done) \
+    X(parse__start) X(parse__done) \
+    X(sb__set__start) X(sb__set__done) \
+    X(sb__get__start) X(sb__get__done) \
+    X(export__start) X(export__done) \
+    X(rest__start) X(rest__done)
+
+#ifdef BCML_USDT
+
+// Semaphores are defined once, in bcml_probe.c
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+
+#define BCML_PROBE_SEMAPHORE(name) bcml_##name##_semaphore
+#define BCML_PROBE_DECLARE(name) extern unsigned short BCML_PROBE_SEMAPHORE(name);
+BCML_PROBE_LIST(BCML_PROBE_DECLARE)
+
+#define BCML_PROBE_ENABLED(name)          __builtin_expect(BCML_PROBE_SEMAPHORE(name) != 0, 0)
+#define BCML_PROBE1(name, a)              DTRACE_PROBE1(bcml, name, a)
+#define BCML_PROBE2(name, a, b)           DTRACE_PROBE2(bcml, name, a, b)
+#define BCML_PROBE3(name, a, b, c)        DTRACE_PROBE3(bcml, name, a, b, c)
+
+#else
+
+// sizeof: arguments count as used but are not evaluated
+#define BCML_PROBE_ENABLED(name)          0
+#define BCML_PROBE1(name, a)              do { (void)sizeof(a); } while (0)
+#define BCML_PROBE2(name, a, b)           do { (void)sizeof(a); (void)sizeof(b); } while (0)
+#define BCML_PROBE3(name, a, b, c)        do { (void)sizeof(a); (void)sizeof(b); (void)sizeof(c); } while (0)
+
+#endif // BCML_USDT
+
+#endif // _BCML_PROBE_H_
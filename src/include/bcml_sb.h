@@ -0,0 +1,73 @@
+#ifndef _BCML_SB_H_
+#define _BCML_SB_H_
+
+#include "bcml_types.h"
+#include <stdbool.h>
+
+// Southbound backend interface and runtime registry.
+//
+// A backend is an sb_ops_t registered under a unique name. Every config type
+// ("wireless", ...) is bound to one backend at a time; the binding is resolved
+// when it is selected, so dispatch costs a single indirect call.
+// Built-in backends ("uci", "restapi") are registered automatically when compiled in.
+
+// Result of a southbound get
+typedef enum {
+    SB_GET_FAILED = 0,
+    SB_GET_OK,            // cfg refreshed from the device
+    SB_GET_NOT_MODIFIED   // Device unchanged since the last get, cfg holds the previous result
+} sb_get_status_t;
+
+typedef struct sb_ops sb_ops_t;
+
+// sb_ops_t: Function pointers for all config types. NULL means "type not supported".
+// self is the registered ops, so stateful/chained backends can reach priv.
+struct sb_ops {
+    const char* name;
+    bool (*set_wireless_config)(const sb_ops_t* self, const bcml_wireless_cfg_t* cfg);
+    sb_get_status_t (*get_wireless_config)(const sb_ops_t* self, bcml_wireless_cfg_t* cfg);
+    // Optional: how many radios/SSIDs the device supports, applied when the backend is selected
+    bool (*get_wireless_limits)(const sb_ops_t* self, int* max_radio, int* max_ssid);
+    // Optional: set up / release transport resources ahead of the first request (bcml_init/bcml_shutdown)
+    bool (*init)(const sb_ops_t* self);
+    void (*shutdown)(const sb_ops_t* self);
+    // Extend here for more config types
+    // bool (*set_network_config)(const sb_ops_t* self, const bcml_network_cfg_t* cfg);
+    // sb_get_status_t (*get_network_config)(const sb_ops_t* self, bcml_network_cfg_t* cfg);
+    void* priv;           // Backend private data
+};
+
+#define BCML_SB_MAX_BACKENDS 8
+
+/**
+ * @brief Register a backend under ops->name. The ops must stay valid for the process lifetime.
+ * @return false if the name is taken or the registry is full.
+ */
+bool bcml_sb_register(const sb_ops_t* ops);
+
+// Look up a registered backend by name, NULL if not found.
+const sb_ops_t* bcml_sb_lookup(const char* name);
+
+/**
+ * @brief Bind a config type to a registered backend. Binding "wireless" to a
+ *        backend that reports get_wireless_limits applies those limits.
+ * @param type     Config type ("wireless", ...), or NULL to bind every type.
+ * @param backend  Registered backend name.
+ * @return true on success.
+ */
+bool bcml_sb_select(const char* type, const char* backend);
+
+/**
+ * @brief Register a write-through backend: set goes to primary then secondary
+ *        (fails if either fails), get is served by primary.
+ */
+bool bcml_sb_register_writethrough(const char* name, const char* primary, const char* secondary);
+
+/**
+ * @brief Register an in-memory cache in front of another backend.
+ *        get is answered from the last set/get result for up to max_age_ms
+ *        (0 = until the next set), otherwise forwarded.
+ */
+bool bcml_sb_register_cache(const char* name, const char* backing, unsigned int max_age_ms);
+
+#endif // _BCML_SB_H_
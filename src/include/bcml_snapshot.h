@@ -0,0 +1,68 @@
+#ifndef _BCML_SNAPSHOT_H_
+#define _BCML_SNAPSHOT_H_
+
+#include "bcml_types.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Published config snapshot in POSIX shared memory.
+//
+// One process (typically bcmld) opens a publisher; from then on every config
+// applied by bcml_config_set() or fetched by bcml_config_get() is copied into
+// the segment under a seqlock. Any number of processes map the segment
+// read-only and copy a consistent snapshot out of it without syscalls or
+// locks; readers never delay the publisher.
+//
+// The generation counts published changes: it only moves when the config
+// differs from the previous snapshot, and survives publisher restarts.
+//
+// The segment holds the SSID passwords, so it is never world-readable: the
+// publisher gives it the mode it is opened with (0600 by default, 0640 from
+// bcmld), and readers run as its owner or, with 0640, in its group.
+
+#define BCML_SNAPSHOT_SHM_NAME "/bcml-snapshot"
+#define BCML_SNAPSHOT_MODE     0600
+
+// ---- Publisher ----
+
+/**
+ * @brief Create (or attach to) the snapshot segment and start publishing.
+ * @param name  shm_open() name, NULL for BCML_SNAPSHOT_SHM_NAME.
+ * @param mode  Permissions of the segment, 0 for BCML_SNAPSHOT_MODE. Also
+ *              applied to an existing segment; other bits are rejected.
+ * @return false if the segment cannot be created, given the mode, or mapped.
+ */
+bool bcml_snapshot_publisher_open(const char* name, unsigned int mode);
+
+// Stop publishing; unlink removes the segment name (mapped readers keep working)
+void bcml_snapshot_publisher_close(bool unlink);
+
+// Publish a wireless config now (no-op without an open publisher)
+void bcml_snapshot_publish_wireless(const bcml_wireless_cfg_t* cfg);
+
+// ---- Reader ----
+
+typedef struct bcml_snapshot bcml_snapshot_t;
+
+/**
+ * @brief Map a snapshot segment read-only.
+ * @param name  shm_open() name, NULL for BCML_SNAPSHOT_SHM_NAME.
+ * @return NULL if no publisher has created it yet or its layout does not
+ *         match this build.
+ */
+bcml_snapshot_t* bcml_snapshot_open(const char* name);
+
+void bcml_snapshot_close(bcml_snapshot_t* snap);
+
+// Current generation, 0 if nothing has been published. A single load: cheap enough to poll.
+uint64_t bcml_snapshot_generation(const bcml_snapshot_t* snap);
+
+/**
+ * @brief Copy out a consistent wireless snapshot.
+ * @param cfg         Resized to the published counts; reuse it across reads.
+ * @param generation  Optional, receives the generation of the copy.
+ * @return false if nothing is published yet, or a publisher stalled mid-update.
+ */
+bool bcml_snapshot_read_wireless(const bcml_snapshot_t* snap, bcml_wireless_cfg_t* cfg, uint64_t* generation);
+
+#endif // _BCML_SNAPSHOT_H_
@@ -0,0 +1,98 @@
+#ifndef _BCML_STORE_H_
+#define _BCML_STORE_H_
+
+#include "bcml_types.h"
+#include "bcml_compact.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Content-addressed store of wireless configs for many devices.
+//
+// Every distinct radio and SSID is held once, interned by the hash of its
+// compact form (bcml_compact.h), whatever slot or device it appears in. A
+// config is a vector of item ids, and is interned too: devices with the same
+// config share it, so a device costs one config id, and configs that differ
+// in one SSID share every other item.
+//
+// Because equal content always maps to the same id, equality, grouping and
+// "which devices differ from this profile" compare integers only; configs and
+// items are never unpacked for them. Config hashes are the content hash of
+// bcml_wireless_cfg_hash(), so they are stable across stores and hosts.
+//
+// Devices are numbered by the caller (e.g. an index into its AP table), and
+// the store grows to the highest number used. Not thread-safe: callers
+// serialize access to one store.
+
+typedef struct bcml_wireless_store bcml_wireless_store_t;
+
+// One set of devices with identical configs
+typedef struct {
+    uint32_t config;            // Config id, shared by every member
+    uint64_t hash;              // Content hash of the config
+    unsigned devices;           // Number of members
+    unsigned first;             // Lowest-numbered member
+} bcml_wireless_group_t;
+
+typedef struct {
+    unsigned devices;           // Devices holding a config
+    size_t configs;             // Distinct configs
+    size_t radios;              // Distinct radios
+    size_t ssids;               // Distinct SSIDs
+    size_t bytes;               // Heap bytes held by the store
+} bcml_wireless_store_stats_t;
+
+bcml_wireless_store_t* bcml_wireless_store_new(void);
+void bcml_wireless_store_free(bcml_wireless_store_t* s);
+
+/**
+ * @brief Store the config of a device, replacing what it had.
+ * @return false on out-of-range counts or allocation failure (device unchanged).
+ */
+bool bcml_wireless_store_put(bcml_wireless_store_t* s, unsigned device, const bcml_wireless_cfg_t* cfg);
+
+/**
+ * @brief Replace one radio/SSID of a device's config, rehashing only that entry.
+ * @return false if the device has no config, the index is past its count,
+ *         or on allocation failure (device unchanged).
+ */
+bool bcml_wireless_store_set_radio(bcml_wireless_store_t* s, unsigned device, int index,
+                                   const bcml_wireless_radio_t* radio);
+bool bcml_wireless_store_set_ssid(bcml_wireless_store_t* s, unsigned device, int index,
+                                  const bcml_wireless_ssid_t* ssid);
+
+// Rebuild a device's config into cfg; false if the device has none
+bool bcml_wireless_store_get(const bcml_wireless_store_t* s, unsigned device, bcml_wireless_cfg_t* cfg);
+
+// Drop a device's config
+void bcml_wireless_store_remove(bcml_wireless_store_t* s, unsigned device);
+
+// Id of the device's config, 0 if it has none. Same id <=> same config.
+uint32_t bcml_wireless_store_config(const bcml_wireless_store_t* s, unsigned device);
+
+// Content hash of the device's config (bcml_wireless_cfg_hash()), 0 if it has none
+uint64_t bcml_wireless_store_hash(const bcml_wireless_store_t* s, unsigned device);
+
+// Both devices hold a config and it is the same one
+bool bcml_wireless_store_equal(const bcml_wireless_store_t* s, unsigned a, unsigned b);
+
+/**
+ * @brief Devices whose config differs from a profile. The profile is only
+ *        looked up, not added: items the store does not hold differ everywhere.
+ * @param devices  Receives up to max device numbers, ascending (may be NULL if max is 0).
+ * @param diffs    Optional, receives the changed entries of each listed device.
+ * @return Number of differing devices (may exceed max); devices without a config are not counted.
+ */
+size_t bcml_wireless_store_differ(const bcml_wireless_store_t* s, const bcml_wireless_cfg_t* profile,
+                                  unsigned* devices, bcml_wireless_diff_t* diffs, size_t max);
+
+/**
+ * @brief Group devices by config.
+ * @param groups  Receives up to max groups, largest first (may be NULL if max is 0).
+ * @return Number of groups (distinct configs in use), which may exceed max.
+ */
+size_t bcml_wireless_store_groups(const bcml_wireless_store_t* s, bcml_wireless_group_t* groups, size_t max);
+
+void bcml_wireless_store_stats(const bcml_wireless_store_t* s, bcml_wireless_store_stats_t* stats);
+
+#endif // _BCML_STORE_H_
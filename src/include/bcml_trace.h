@@ -0,0 +1,95 @@
+#ifndef _BCML_TRACE_H_
+#define _BCML_TRACE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Call trace recorder.
+//
+// While a trace is open, every bcml_config_set/get (and _bin, rollback) call
+// is appended to it as one binary record: the request payload (the response
+// for a get), when the call started, how long it and each pipeline stage
+// took, and what the southbound answered, including the config a get fetched.
+// bcml-replay re-drives a trace against a mock backend built from those
+// answers, or against a real one, and reports throughput and latency.
+//
+// Records are buffered and written by the calling thread under a lock; the
+// file is complete once the trace is closed (bcml_shutdown() closes it). A
+// trace cut short by a crash reads up to its last whole record. Integers are
+// little endian, so a trace taken on the device replays on any host.
+
+// Calls (bcml_trace_rec_t.op)
+#define BCML_TRACE_OP_SET       1
+#define BCML_TRACE_OP_GET       2
+#define BCML_TRACE_OP_SET_BIN   3
+#define BCML_TRACE_OP_GET_BIN   4
+#define BCML_TRACE_OP_ROLLBACK  5
+
+// Pipeline stages timed per call (bcml_trace_rec_t.stage_ns)
+enum {
+    BCML_TRACE_STAGE_VALIDATE,      // Schema validation of the input, or of a get's output
+    BCML_TRACE_STAGE_PARSE,         // JSON/CBOR to config
+    BCML_TRACE_STAGE_CHECK,         // Cross-field/regulatory rules
+    BCML_TRACE_STAGE_SB,            // Southbound set or get
+    BCML_TRACE_STAGE_EXPORT,        // Config to JSON/CBOR
+    BCML_TRACE_STAGE_COUNT
+};
+
+// Southbound status of a call (bcml_trace_rec_t.sb_status): a get's
+// sb_get_status_t, 1/0 for a set that succeeded/failed, or this when the
+// call failed before reaching the southbound
+#define BCML_TRACE_SB_NONE      0xff
+
+#define BCML_TRACE_TYPE_MAX     31
+
+typedef struct {
+    uint8_t op;                 // BCML_TRACE_OP_*
+    bool ok;                    // What the call returned
+    uint8_t sb_status;
+    char type[BCML_TRACE_TYPE_MAX + 1];
+    uint64_t start_ns;          // Since the trace was opened
+    uint64_t total_ns;
+    uint32_t stage_ns[BCML_TRACE_STAGE_COUNT];  // Saturate at UINT32_MAX
+    uint32_t arg;               // get: buffer size, rollback: generations
+    const uint8_t* payload;     // set: request JSON/CBOR, get: response (if ok)
+    size_t payload_len;
+    const uint8_t* sb;          // Config fetched by a get (sb_status SB_GET_OK), as a
+    size_t sb_len;              // self-contained journal delta of its type
+} bcml_trace_rec_t;
+
+/**
+ * @brief Start recording calls to path (created or truncated, mode 0600:
+ *        records hold the configs, passwords included).
+ * @return false if a trace is already open or the file cannot be created.
+ */
+bool bcml_trace_open(const char* path);
+
+// Flush and stop recording
+void bcml_trace_close(void);
+
+bool bcml_trace_is_open(void);
+
+// Recording side (bcml_config.c): monotonic clock in ns, and append one call
+uint64_t bcml_trace_now(void);
+bool bcml_trace_append(const bcml_trace_rec_t* rec);
+
+// ---- Reading ----
+
+typedef struct bcml_trace_reader bcml_trace_reader_t;
+
+// NULL if the file cannot be opened or is not a trace
+bcml_trace_reader_t* bcml_trace_reader_open(const char* path);
+
+/**
+ * @brief Read the next record. Its pointers stay valid until the next call.
+ * @return false at the end of the trace, or at a truncated or malformed record.
+ */
+bool bcml_trace_reader_next(bcml_trace_reader_t* reader, bcml_trace_rec_t* rec);
+
+// Wall clock (ns since the epoch) at which the trace was opened
+uint64_t bcml_trace_reader_started(const bcml_trace_reader_t* reader);
+
+void bcml_trace_reader_close(bcml_trace_reader_t* reader);
+
+#endif // _BCML_TRACE_H_
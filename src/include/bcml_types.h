@@ -1,41 +1,56 @@
-#ifndef _BCML_TYPES_H_
-#define _BCML_TYPES_H_
-
-#include <stdbool.h>
-
-#define MAX_RADIO_NUM 4  // Maximum number of radios
-#define MAX_SSID_NUM 4   // Maximum number of SSID entries per wireless config
-
-// Wireless radio settings
-typedef struct {
-    int power;
-    int channel2g;
-    int channel5g;
-    int bandwidth2g;
-    int bandwidth5g;
-    bool dfs;
-    bool atf;
-    bool bandsteering;
-    bool zerowait;
-} bcml_wireless_radio_t;
-
-// Wireless SSID settings
-typedef struct {
-    char ssid[64];
-    bool hide;
-    int security;
-    char password[64];
-    bool password_onscreen;
-    bool enable2g;
-    bool enable5g;
-    bool isolation;
-    bool hopping;
-} bcml_wireless_ssid_t;
-
-// Top-level wireless configuration
-typedef struct {
-    bcml_wireless_radio_t radio[MAX_RADIO_NUM];
-    bcml_wireless_ssid_t ssid[MAX_SSID_NUM];
-} bcml_wireless_cfg_t;
-
+#ifndef _BCML_TYPES_H_
+#define _BCML_TYPES_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#define MAX_RADIO_NUM 4  // Default radio cap (schema maxItems), see bcml_wireless_set_limits()
+#define MAX_SSID_NUM 4   // Default SSID cap (schema maxItems)
+
+#define BCML_RADIO_LIMIT 16  // Largest runtime radio cap
+#define BCML_SSID_LIMIT 32   // Largest runtime SSID cap
+
+#define BCML_SSID_MAX_LEN 64      // Max SSID length in bytes (schema maxLength)
+#define BCML_PASSWORD_MAX_LEN 64  // Max password length in bytes (schema maxLength)
+
+// Wireless radio settings
+typedef struct {
+    int power;
+    int channel2g;
+    int channel5g;
+    int bandwidth2g;
+    int bandwidth5g;
+    bool dfs;
+    bool atf;
+    bool bandsteering;
+    bool zerowait;
+} bcml_wireless_radio_t;
+
+// Wireless SSID settings
+typedef struct {
+    char ssid[BCML_SSID_MAX_LEN + 1];
+    bool hide;
+    int security;
+    char password[BCML_PASSWORD_MAX_LEN + 1];
+    bool password_onscreen;
+    bool enable2g;
+    bool enable5g;
+    bool isolation;
+    bool hopping;
+} bcml_wireless_ssid_t;
+
+// Top-level wireless configuration.
+// Entries live in one block owned by the config, sized to the actual counts
+// (bcml_wireless.h). A zero-initialized config is valid and empty; release it
+// with bcml_wireless_cfg_free(). Plain struct assignment shares the block:
+// use bcml_wireless_cfg_copy().
+typedef struct {
+    bcml_wireless_radio_t* radio;   // radio_count entries
+    bcml_wireless_ssid_t* ssid;     // ssid_count entries
+    int radio_count;
+    int ssid_count;
+    void* arena;                    // Backing block of radio[] and ssid[]
+    size_t arena_size;
+} bcml_wireless_cfg_t;
+
 #endif // _BCML_TYPES_H_
\ No newline at end of file
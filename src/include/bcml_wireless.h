@@ -0,0 +1,80 @@
+#ifndef _BCML_WIRELESS_H_
+#define _BCML_WIRELESS_H_
+
+#include "bcml_types.h"
+#include <stdbool.h>
+
+// Wireless config storage and runtime limits.
+//
+// A bcml_wireless_cfg_t holds as many radios/SSIDs as the config actually has,
+// in a single block that is reused (never shrunk) across resizes, so a config
+// that is parsed over and over allocates once. How many entries a config may
+// have is a runtime limit: MAX_RADIO_NUM/MAX_SSID_NUM by default, replaced by
+// the schema's maxItems, and by what the selected backend reports for the
+// device (which wins over the schema while it is set).
+
+#define BCML_WIRELESS_CFG_INIT { NULL, NULL, 0, 0, NULL, 0 }
+
+// Per-config entry limits, at most BCML_RADIO_LIMIT/BCML_SSID_LIMIT
+typedef struct {
+    int max_radio;
+    int max_ssid;
+} bcml_wireless_limits_t;
+
+void bcml_wireless_cfg_init(bcml_wireless_cfg_t* cfg);
+
+// Release the entries; cfg is empty (and reusable) afterwards
+void bcml_wireless_cfg_free(bcml_wireless_cfg_t* cfg);
+
+/**
+ * @brief Set the number of radios and SSIDs. Entries below the new counts are
+ *        kept, new entries are zeroed.
+ * @return false if a count exceeds BCML_RADIO_LIMIT/BCML_SSID_LIMIT or on
+ *         allocation failure (cfg unchanged).
+ */
+bool bcml_wireless_cfg_resize(bcml_wireless_cfg_t* cfg, int radio_count, int ssid_count);
+
+// Deep copy; dst's block is reused when large enough
+bool bcml_wireless_cfg_copy(bcml_wireless_cfg_t* dst, const bcml_wireless_cfg_t* src);
+
+// Limits currently enforced by validation and parsing
+void bcml_wireless_get_limits(bcml_wireless_limits_t* limits);
+
+/**
+ * @brief Set the device limits, which take precedence over the schema limits.
+ * @param limits  NULL drops the device limits, falling back to the schema's.
+ * @return false if a limit is < 1 or above BCML_RADIO_LIMIT/BCML_SSID_LIMIT.
+ */
+bool bcml_wireless_set_limits(const bcml_wireless_limits_t* limits);
+
+// Set the limits that apply while no device limits are set
+bool bcml_wireless_set_schema_limits(const bcml_wireless_limits_t* limits);
+
+/**
+ * @brief Take the schema limits from the "maxItems" of the radio/ssid arrays
+ *        in a wireless JSON schema file (e.g. schema/wireless_data_model_schema.json).
+ * @return false if the file cannot be read or holds no usable maxItems
+ *         (limits unchanged).
+ */
+bool bcml_wireless_limits_from_schema(const char* schema_path);
+
+// Regulatory domain the radio settings are checked against on set, as an
+// ISO 3166 alpha-2 code ("US", "DE", ...) or "00" (world). The check is off
+// until a domain is set, and NULL or "" turns it off again. The world domain
+// is the intersection of all others: 2.4 GHz channels 1-11 and 5 GHz 36-64 up
+// to 80 MHz. Returns false for a country without tables (domain unchanged).
+bool bcml_wireless_set_country(const char* alpha2);
+// Current domain, NULL while the check is off
+const char* bcml_wireless_get_country(void);
+
+/**
+ * @brief Check every radio against the regulatory domain: each channel has to
+ *        be usable at its bandwidth (20/40/80/160 MHz) in that band, and a 5 GHz
+ *        channel whose span includes DFS channels needs dfs. Channel 0 and
+ *        bandwidth 0 mean automatic and are accepted. Always true while no
+ *        domain is set.
+ * @return false on the first radio that fails (logged).
+ */
+bool bcml_wireless_regdom_check(const bcml_wireless_cfg_t* cfg);
+
+#endif // _BCML_WIRELESS_H_
@@ -0,0 +1,8 @@
+#include "bcml_probe.h"
+
+#ifdef BCML_USDT
+// One semaphore per probe, in the section tracers look them up in
+#define BCML_PROBE_DEFINE(name) \
+    unsigned short BCML_PROBE_SEMAPHORE(name) __attribute__((unused, section(".probes")));
+BCML_PROBE_LIST(BCML_PROBE_DEFINE)
+#endif
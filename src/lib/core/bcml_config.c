@@ -3,34 +3,129 @@
 #include "validator_wireless.h"
 #include "parse_wireless_json.h"
 #include "export_wireless_json.h"
+#include "wireless_cbor.h"
 // #include "bchal_display.h" // Include if display config type is supported
 #include "sb_ops.h" // Include southbound interface
+#include "bcml_snapshot.h" // Shared-memory snapshot publisher
+#include "bcml_wireless.h"
+#include "bcml_journal.h" // Apply journal
+#include "bcml_trace.h" // Call trace recorder
+#include "wireless_codec.h"
 #include "bcml_log.h" // Include logging interface
+#include "bcml_probe.h" // USDT tracepoints
 
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <strings.h> // for strcasecmp
 
+// Last exported JSON of a config type, reused when the southbound reports it unchanged
+typedef struct {
+    char* json;
+    size_t len;
+    bool valid;
+} config_export_cache_t;
+
+// Journaling of a config type: applied configs are recorded as deltas against
+// the previous one (base), checkpoints are encoded against nothing
+typedef struct {
+    uint8_t tag;                    // BCML_JOURNAL_TAG_*
+    bool base_valid;
+    void* base;                     // Last config written to the journal
+    uint8_t* buf;                   // Encoding buffer, large enough for any record
+    uint8_t* trace_buf;             // Same, for configs recorded in a call trace
+    size_t (*encode)(const void* base, const void* sdata, uint8_t* out);
+    bool (*apply)(void* sdata, const uint8_t* data, size_t len);
+    bool (*copy)(void* dst, const void* src);
+} config_journal_t;
+
 typedef struct {
     const char* type;
     bool (*validate)(const char* json, const char* schema_path);
     bool (*parse)(const char* json, void* sdata);
+    bool (*check)(const void* sdata);   // Cross-field rules on a parsed config, before it is applied (optional)
     bool (*export_json)(const void* sdata, char* json_buffer, size_t buffer_size); // Export config to JSON string
+    // Binary (CBOR) northbound form, optional: validate and decode in one step, schema check, export
+    bool (*parse_bin)(const uint8_t* data, size_t len, void* sdata);
+    bool (*validate_bin)(const uint8_t* data, size_t len);
+    bool (*export_bin)(const void* sdata, uint8_t* buffer, size_t buffer_size, size_t* len);
+    void (*publish)(const void* sdata); // Publish applied/fetched config to the shm snapshot (optional)
+    void (*release)(void* sdata);       // Free what a config instance holds (optional, bcml_shutdown)
     void* cfg_instance;
     const char* schema_path;
+    config_export_cache_t* export_cache;
+    void (*load_limits)(void);   // Take runtime limits from the schema, once (optional)
+    pthread_once_t* limits_once;
+    config_journal_t* journal;   // Apply journal support (optional)
 } config_handler_t;
 
+#define WIRELESS_SCHEMA_PATH "schema/wireless_data_model_schema.json"
+
 // Example: Wireless config handler
 static bcml_wireless_cfg_t g_wireless_cfg;
+static config_export_cache_t g_wireless_export_cache;
+static pthread_once_t g_wireless_limits_once = PTHREAD_ONCE_INIT;
+
+static void wireless_load_limits(void) {
+    bcml_wireless_limits_from_schema(WIRELESS_SCHEMA_PATH);
+}
+
+static size_t wireless_journal_encode(const void* base, const void* sdata, uint8_t* out) {
+    return wireless_delta_encode((const bcml_wireless_cfg_t*)base, (const bcml_wireless_cfg_t*)sdata, out);
+}
+
+static bool wireless_journal_apply(void* sdata, const uint8_t* data, size_t len) {
+    return wireless_delta_apply((bcml_wireless_cfg_t*)sdata, data, len);
+}
+
+static bool wireless_journal_copy(void* dst, const void* src) {
+    return bcml_wireless_cfg_copy((bcml_wireless_cfg_t*)dst, (const bcml_wireless_cfg_t*)src);
+}
+
+static bcml_wireless_cfg_t g_wireless_journal_base;
+static uint8_t g_wireless_journal_buf[WIRELESS_DELTA_MAX];
+static uint8_t g_wireless_trace_buf[WIRELESS_DELTA_MAX];
+static config_journal_t g_wireless_journal = {
+    .tag = BCML_JOURNAL_TAG_WIRELESS,
+    .base = &g_wireless_journal_base,
+    .buf = g_wireless_journal_buf,
+    .trace_buf = g_wireless_trace_buf,
+    .encode = wireless_journal_encode,
+    .apply = wireless_journal_apply,
+    .copy = wireless_journal_copy
+};
+
+static void publish_wireless_adapter(const void* sdata) {
+    bcml_snapshot_publish_wireless((const bcml_wireless_cfg_t*)sdata);
+}
+
+static bool check_wireless_adapter(const void* sdata) {
+    return bcml_wireless_regdom_check((const bcml_wireless_cfg_t*)sdata);
+}
+
+static void release_wireless_adapter(void* sdata) {
+    bcml_wireless_cfg_free((bcml_wireless_cfg_t*)sdata);
+}
 
 static config_handler_t config_handlers[] = {
     {
         .type = "wireless",
         .validate = validate_wireless_json,
         .parse = parse_wireless_json,
+        .check = check_wireless_adapter,
         .export_json = export_wireless_json,
+        .parse_bin = parse_wireless_cbor,
+        .validate_bin = validate_wireless_cbor,
+        .export_bin = export_wireless_cbor,
+        .publish = publish_wireless_adapter,
+        .release = release_wireless_adapter,
         .cfg_instance = &g_wireless_cfg,
-        .schema_path = "schema/wireless_data_model_schema.json"
+        .schema_path = WIRELESS_SCHEMA_PATH,
+        .export_cache = &g_wireless_export_cache,
+        .load_limits = wireless_load_limits,
+        .limits_once = &g_wireless_limits_once,
+        .journal = &g_wireless_journal
     },
     // Example for display config type
     // {
@@ -38,8 +133,11 @@ static config_handler_t config_handlers[] = {
     //     .validate = validate_display_json,
     //     .parse = parse_display_json_adapter,
     //     .export_json = export_display_json_adapter,
+    //     .publish = NULL,
+    //     .release = NULL,
     //     .cfg_instance = &g_display_cfg,
-    //     .schema_path = "schema/display_data_model_schema.json"
+    //     .schema_path = "schema/display_data_model_schema.json",
+    //     .export_cache = &g_display_export_cache
     // },
 };
 
@@ -50,6 +148,8 @@ static const config_handler_t* find_handler(const char* type) {
     for (size_t i = 0; i < num; ++i) {
         if (strcasecmp(type, config_handlers[i].type) == 0) {
             BCML_LOG_DEBUG("find_handler: FOUND handler for '%s' at index %zu\n", type, i);
+            if (config_handlers[i].load_limits)
+                pthread_once(config_handlers[i].limits_once, config_handlers[i].load_limits);
             return &config_handlers[i];
         }
     }
@@ -58,76 +158,382 @@ static const config_handler_t* find_handler(const char* type) {
     return NULL;
 }
 
-bool bcml_config_set(const char* type, const char* json_data) {
-    if (!type || !json_data)
-        return false;
+static void export_cache_invalidate(config_export_cache_t* cache) {
+    if (cache)
+        cache->valid = false;
+}
 
+static void export_cache_store(config_export_cache_t* cache, const char* json) {
+    if (!cache)
+        return;
+    size_t len = strlen(json);
+    char* p = realloc(cache->json, len + 1);
+    if (!p) {
+        cache->valid = false;
+        return;
+    }
+    memcpy(p, json, len + 1);
+    cache->json = p;
+    cache->len = len;
+    cache->valid = true;
+}
+
+// Record the config just applied; a failure costs durability, not the apply itself
+static void journal_record(const config_handler_t* handler) {
+    config_journal_t* j = handler->journal;
+    if (!j || !bcml_journal_is_open())
+        return;
+
+    bool full = !j->base_valid || bcml_journal_want_checkpoint(j->tag);
+    size_t len = j->encode(full ? NULL : j->base, handler->cfg_instance, j->buf);
+    if (len && bcml_journal_append(j->tag, full, j->buf, len)) {
+        j->base_valid = j->copy(j->base, handler->cfg_instance);
+        return;
+    }
+    j->base_valid = false;
+    BCML_LOG_ERROR("%s: applied config not journaled\n", handler->type);
+}
+
+static bool journal_replay_apply(void* ctx, bool full, const uint8_t* data, size_t len) {
+    const config_handler_t* handler = ctx;
+    (void)full;  // A checkpoint is a delta holding every entry
+    return handler->journal->apply(handler->cfg_instance, data, len);
+}
+
+// ---- Call trace (bcml_trace.h) ----
+
+// The call being recorded on this thread
+typedef struct {
+    bcml_trace_rec_t rec;
+    const config_handler_t* fetched;    // Handler whose instance the southbound refreshed
+} trace_call_t;
+
+// NULL unless a trace is open, so the stages below only pay for a TLS load
+static __thread trace_call_t* t_trace;
+
+static void trace_begin(trace_call_t* call, uint8_t op, const char* type, uint32_t arg) {
+    if (!bcml_trace_is_open())
+        return;
+    memset(call, 0, sizeof(*call));
+    call->rec.op = op;
+    call->rec.sb_status = BCML_TRACE_SB_NONE;
+    call->rec.arg = arg;
+    snprintf(call->rec.type, sizeof(call->rec.type), "%s", type);
+    call->rec.start_ns = bcml_trace_now();
+    t_trace = call;
+}
+
+// payload: the request of a set, the response of a successful get
+static void trace_end(bool ok, const void* payload, size_t len) {
+    trace_call_t* call = t_trace;
+    if (!call)
+        return;
+    t_trace = NULL;
+    call->rec.total_ns = bcml_trace_now() - call->rec.start_ns;
+    call->rec.ok = ok;
+    call->rec.payload = payload;
+    call->rec.payload_len = payload ? len : 0;
+    // What the device answered, so a replay can stand in for it
+    const config_handler_t* handler = call->fetched;
+    if (handler && handler->journal && handler->journal->trace_buf) {
+        call->rec.sb = handler->journal->trace_buf;
+        call->rec.sb_len = handler->journal->encode(NULL, handler->cfg_instance, handler->journal->trace_buf);
+    }
+    bcml_trace_append(&call->rec);
+}
+
+static uint64_t trace_stage_start(void) {
+    return t_trace ? bcml_trace_now() : 0;
+}
+
+static void trace_stage_done(int stage, uint64_t t0) {
+    if (!t_trace)
+        return;
+    uint64_t ns = t_trace->rec.stage_ns[stage] + (bcml_trace_now() - t0);
+    t_trace->rec.stage_ns[stage] = ns > UINT32_MAX ? UINT32_MAX : (uint32_t)ns;
+}
+
+// Pipeline stages, each bracketed by its start/done probes (bcml_probe.h)
+static bool stage_validate(const config_handler_t* handler, const char* json, size_t json_len) {
+    BCML_PROBE2(validate__start, handler->type, json_len);
+    uint64_t t0 = trace_stage_start();
+    bool ok = handler->validate(json, handler->schema_path);
+    trace_stage_done(BCML_TRACE_STAGE_VALIDATE, t0);
+    BCML_PROBE2(validate__done, handler->type, ok);
+    return ok;
+}
+
+static bool stage_parse(const config_handler_t* handler, const char* json, size_t json_len) {
+    BCML_PROBE2(parse__start, handler->type, json_len);
+    uint64_t t0 = trace_stage_start();
+    bool ok = handler->parse(json, handler->cfg_instance);
+    trace_stage_done(BCML_TRACE_STAGE_PARSE, t0);
+    BCML_PROBE2(parse__done, handler->type, ok);
+    return ok;
+}
+
+// Binary form: the decoder enforces the schema, so parse covers validation too
+static bool stage_parse_bin(const config_handler_t* handler, const uint8_t* data, size_t len) {
+    BCML_PROBE2(parse__start, handler->type, len);
+    uint64_t t0 = trace_stage_start();
+    bool ok = handler->parse_bin(data, len, handler->cfg_instance);
+    trace_stage_done(BCML_TRACE_STAGE_PARSE, t0);
+    BCML_PROBE2(parse__done, handler->type, ok);
+    return ok;
+}
+
+static bool stage_validate_bin(const config_handler_t* handler, const uint8_t* data, size_t len) {
+    BCML_PROBE2(validate__start, handler->type, len);
+    uint64_t t0 = trace_stage_start();
+    bool ok = handler->validate_bin(data, len);
+    trace_stage_done(BCML_TRACE_STAGE_VALIDATE, t0);
+    BCML_PROBE2(validate__done, handler->type, ok);
+    return ok;
+}
+
+static bool stage_check(const config_handler_t* handler) {
+    uint64_t t0 = trace_stage_start();
+    bool ok = handler->check(handler->cfg_instance);
+    trace_stage_done(BCML_TRACE_STAGE_CHECK, t0);
+    return ok;
+}
+
+static bool stage_sb_set(const config_handler_t* handler, const sb_ops_entry_t* sb_entry) {
+    BCML_PROBE2(sb__set__start, handler->type, sb_entry->ops ? sb_entry->ops->name : "");
+    uint64_t t0 = trace_stage_start();
+    bool ok = sb_entry_set(sb_entry, handler->cfg_instance);
+    trace_stage_done(BCML_TRACE_STAGE_SB, t0);
+    if (t_trace)
+        t_trace->rec.sb_status = ok;
+    BCML_PROBE2(sb__set__done, handler->type, ok);
+    return ok;
+}
+
+static sb_get_status_t stage_sb_get(const config_handler_t* handler, const sb_ops_entry_t* sb_entry) {
+    BCML_PROBE2(sb__get__start, handler->type, sb_entry->ops ? sb_entry->ops->name : "");
+    uint64_t t0 = trace_stage_start();
+    sb_get_status_t status = sb_entry_get(sb_entry, handler->cfg_instance);
+    trace_stage_done(BCML_TRACE_STAGE_SB, t0);
+    if (t_trace) {
+        t_trace->rec.sb_status = (uint8_t)status;
+        t_trace->fetched = status == SB_GET_OK ? handler : NULL;
+    }
+    BCML_PROBE2(sb__get__done, handler->type, (int)status);
+    return status;
+}
+
+static bool stage_export(const config_handler_t* handler, char* json_buffer, size_t buffer_size) {
+    uint64_t t0 = trace_stage_start();
+    bool ok = handler->export_json(handler->cfg_instance, json_buffer, buffer_size);
+    trace_stage_done(BCML_TRACE_STAGE_EXPORT, t0);
+    return ok;
+}
+
+static bool stage_export_bin(const config_handler_t* handler, uint8_t* buffer, size_t buffer_size, size_t* len) {
+    uint64_t t0 = trace_stage_start();
+    bool ok = handler->export_bin(handler->cfg_instance, buffer, buffer_size, len);
+    trace_stage_done(BCML_TRACE_STAGE_EXPORT, t0);
+    return ok;
+}
+
+static bool config_apply(const config_handler_t* handler, const char* type);
+
+static bool config_set(const char* type, const char* json_data, size_t json_len) {
     const config_handler_t* handler = find_handler(type);
     if (!handler) {
         BCML_LOG_ERROR("Unknown config type: %s\n", type);
         return false;
     }
 
-    if (!json_data || strlen(json_data) == 0) {
+    if (json_len == 0) {
         BCML_LOG_WARN("bcml_config_set: JSON data is empty.\n");
         return false;
     }
     // Validate the JSON data against the schema
-    if (handler->validate && !handler->validate(json_data, handler->schema_path)) {
+    if (handler->validate && !stage_validate(handler, json_data, json_len)) {
         BCML_LOG_ERROR("%s JSON schema validation failed.\n", handler->type);
         return false;
     }
-    // Parse the JSON data into the configuration instance
-    if (handler->parse && !handler->parse(json_data, handler->cfg_instance)) {
+    // Parse the JSON data into the configuration instance (the cached export no longer matches it)
+    export_cache_invalidate(handler->export_cache);
+    if (handler->parse && !stage_parse(handler, json_data, json_len)) {
         BCML_LOG_ERROR("%s JSON parsing failed.\n", handler->type);
         return false;
     }
+    return config_apply(handler, type);
+}
+
+// Apply the parsed config instance: southbound set, snapshot, journal
+static bool config_apply(const config_handler_t* handler, const char* type) {
+    // Rejected here in microseconds rather than by the device after a radio restart
+    if (handler->check && !stage_check(handler)) {
+        BCML_LOG_ERROR("%s config violates the regulatory/cross-field rules.\n", handler->type);
+        return false;
+    }
 
     // Southbound: Dispatch to corresponding sb_ops by config type
-    const sb_ops_entry_t* sb_entry = sb_ops_find(type);
-    if (!sb_entry || !sb_entry->set) {
+    sb_ops_entry_t sb_entry;
+    if (!sb_ops_find(type, &sb_entry) || !sb_entry.set) {
         BCML_LOG_ERROR("No southbound set for type: %s\n", type);
         return false;
     }
-    if (!sb_entry->set(handler->cfg_instance)) {
+    if (!stage_sb_set(handler, &sb_entry)) {
         BCML_LOG_ERROR("Southbound set failed: %s\n", type);
         return false;
     }
+    if (handler->publish)
+        handler->publish(handler->cfg_instance);
+    journal_record(handler);
 
     BCML_LOG_INFO("bcml_config_set: %s config applied via southbound.\n", handler->type);
     return true;
 }
 
-// Get config function: fetch from southbound and export to JSON
-bool bcml_config_get(const char* type, char* json_buffer, size_t buffer_size) {
-    if (!type || !json_buffer || buffer_size == 0) {
-        BCML_LOG_WARN("bcml_config_get: Invalid input. %s %x %d \n", type, json_buffer, buffer_size);
+static bool config_set_bin(const char* type, const uint8_t* data, size_t len) {
+    const config_handler_t* handler = find_handler(type);
+    if (!handler) {
+        BCML_LOG_ERROR("Unknown config type: %s\n", type);
+        return false;
+    }
+    if (!handler->parse_bin) {
+        BCML_LOG_ERROR("%s has no binary form.\n", handler->type);
+        return false;
+    }
+    if (len == 0) {
+        BCML_LOG_WARN("bcml_config_set_bin: data is empty.\n");
+        return false;
+    }
+    export_cache_invalidate(handler->export_cache);
+    if (!stage_parse_bin(handler, data, len)) {
+        BCML_LOG_ERROR("%s binary config rejected.\n", handler->type);
         return false;
     }
+    return config_apply(handler, type);
+}
+
+bool bcml_config_set_bin(const char* type, const void* data, size_t len) {
+    if (!type || !data)
+        return false;
 
+    BCML_PROBE2(set__start, type, len);
+    trace_call_t call;
+    trace_begin(&call, BCML_TRACE_OP_SET_BIN, type, 0);
+    bool ok = config_set_bin(type, (const uint8_t*)data, len);
+    trace_end(ok, data, len);
+    BCML_PROBE2(set__done, type, ok);
+    return ok;
+}
+
+bool bcml_config_set(const char* type, const char* json_data) {
+    if (!type || !json_data)
+        return false;
+
+    size_t json_len = strlen(json_data);
+    BCML_PROBE2(set__start, type, json_len);
+    trace_call_t call;
+    trace_begin(&call, BCML_TRACE_OP_SET, type, 0);
+    bool ok = config_set(type, json_data, json_len);
+    trace_end(ok, json_data, json_len);
+    BCML_PROBE2(set__done, type, ok);
+    return ok;
+}
+
+// Rollback: rebuild an applied config from the journal and apply it again
+static bool config_rollback(const char* type, unsigned int generations) {
     const config_handler_t* handler = find_handler(type);
     if (!handler) {
         BCML_LOG_ERROR("Unknown config type: %s\n", type);
         return false;
     }
+    if (!handler->journal || !bcml_journal_is_open()) {
+        BCML_LOG_ERROR("bcml_config_rollback: no journal for type %s\n", handler->type);
+        return false;
+    }
 
-    BCML_LOG_DEBUG("bcml_config_get: handler->type='%s' \n", handler->type);
+    export_cache_invalidate(handler->export_cache);
+    if (!bcml_journal_replay(handler->journal->tag, generations, journal_replay_apply, (void*)handler)) {
+        BCML_LOG_ERROR("bcml_config_rollback: %s config %u generations back not available\n",
+                       handler->type, generations);
+        return false;
+    }
 
-    // 1. Southbound: retrieve current config structure
+    sb_ops_entry_t sb_entry;
+    if (!sb_ops_find(type, &sb_entry) || !sb_entry.set || !stage_sb_set(handler, &sb_entry)) {
+        BCML_LOG_ERROR("bcml_config_rollback: southbound set failed: %s\n", type);
+        return false;
+    }
+    if (handler->publish)
+        handler->publish(handler->cfg_instance);
+    // The restored config is now the applied one, so it is journaled as the newest generation
+    journal_record(handler);
+
+    BCML_LOG_INFO("bcml_config_rollback: %s config restored from %u generations back.\n",
+                  handler->type, generations);
+    return true;
+}
+
+bool bcml_config_rollback(const char* type, unsigned int generations) {
+    if (!type)
+        return false;
+
+    trace_call_t call;
+    trace_begin(&call, BCML_TRACE_OP_ROLLBACK, type, generations);
+    bool ok = config_rollback(type, generations);
+    trace_end(ok, NULL, 0);
+    return ok;
+}
+
+// Refresh the config instance from the southbound; SB_GET_FAILED if it cannot be
+static sb_get_status_t config_fetch(const config_handler_t* handler, const char* type) {
     BCML_LOG_DEBUG("bcml_config_get: finding sb_ops_entry for type '%s' \n", type);
-    const sb_ops_entry_t* sb_entry = sb_ops_find(type);
-    if (!sb_entry || !sb_entry->get) {
+    sb_ops_entry_t sb_entry;
+    if (!sb_ops_find(type, &sb_entry) || !sb_entry.get) {
         BCML_LOG_ERROR("No southbound get for type: %s\n", type);
-        return false;
+        return SB_GET_FAILED;
     }
- 
+
     BCML_LOG_DEBUG("bcml_config_get: calling sb_entry->get for type '%s' \n", type);
-    if (!sb_entry->get(handler->cfg_instance)) {
+    sb_get_status_t sb_status = stage_sb_get(handler, &sb_entry);
+    if (sb_status == SB_GET_FAILED) {
         // If southbound get fails, we cannot export the config
         BCML_LOG_ERROR("Southbound get failed for type: %s\n", type);
+        export_cache_invalidate(handler->export_cache);
+        return SB_GET_FAILED;
+    }
+    BCML_LOG_DEBUG("bcml_config_get: sb_entry->get succeeded for type '%s' (status=%d)\n", type, sb_status);
+    if (sb_status == SB_GET_OK && handler->publish)
+        handler->publish(handler->cfg_instance);
+    return sb_status;
+}
+
+// Get config function: fetch from southbound and export to JSON
+static bool config_get(const char* type, char* json_buffer, size_t buffer_size) {
+    const config_handler_t* handler = find_handler(type);
+    if (!handler) {
+        BCML_LOG_ERROR("Unknown config type: %s\n", type);
         return false;
     }
-    BCML_LOG_DEBUG("bcml_config_get: sb_entry->get succeeded for type '%s' \n", type);
+
+    BCML_LOG_DEBUG("bcml_config_get: handler->type='%s' \n", handler->type);
+
+    // 1. Southbound: retrieve current config structure
+    sb_get_status_t sb_status = config_fetch(handler, type);
+    if (sb_status == SB_GET_FAILED)
+        return false;
+
+    // Unchanged on the device: reuse the last exported (and validated) JSON
+    config_export_cache_t* cache = handler->export_cache;
+    if (sb_status == SB_GET_NOT_MODIFIED && cache && cache->valid) {
+        if (cache->len >= buffer_size) {
+            BCML_LOG_ERROR("bcml_config_get: Buffer too small (required=%zu, given=%zu)\n", cache->len + 1, buffer_size);
+            json_buffer[0] = '\0';
+            return false;
+        }
+        memcpy(json_buffer, cache->json, cache->len + 1);
+        BCML_LOG_INFO("bcml_config_get: %s config unchanged, cached JSON reused.\n", handler->type);
+        return true;
+    }
+    export_cache_invalidate(cache);
 
     // 2. Export config structure to JSON string
     if (!handler->export_json) {
@@ -137,7 +543,7 @@ bool bcml_config_get(const char* type, char* json_buffer, size_t buffer_size) {
 
     BCML_LOG_DEBUG("bcml_config_get: exporting JSON for type '%s' \n", handler->type);
 
-    if (!handler->export_json(handler->cfg_instance, json_buffer, buffer_size)) {
+    if (!stage_export(handler, json_buffer, buffer_size)) {
         BCML_LOG_ERROR("%s export_json failed.\n", handler->type);
         return false;
     }
@@ -145,12 +551,218 @@ bool bcml_config_get(const char* type, char* json_buffer, size_t buffer_size) {
     // Optional: validate the exported JSON (for extra safety)
     if (handler->validate) {
         BCML_LOG_DEBUG("bcml_config_get: validating exported JSON for type '%s' \n", handler->type);
-        if (!handler->validate(json_buffer, handler->schema_path)) {
+        size_t json_len = BCML_PROBE_ENABLED(validate__start) ? strlen(json_buffer) : 0;
+        if (!stage_validate(handler, json_buffer, json_len)) {
             BCML_LOG_ERROR("%s exported JSON schema validation failed. \n", handler->type);
             return false;
         }
     }
 
+    export_cache_store(cache, json_buffer);
     BCML_LOG_INFO("bcml_config_get: %s config exported to JSON.\n", handler->type);
     return true;
-}
\ No newline at end of file
+}
+
+bool bcml_config_get(const char* type, char* json_buffer, size_t buffer_size) {
+    if (!type || !json_buffer || buffer_size == 0) {
+        BCML_LOG_WARN("bcml_config_get: Invalid input. %s %x %d \n", type, json_buffer, buffer_size);
+        return false;
+    }
+
+    BCML_PROBE2(get__start, type, buffer_size);
+    trace_call_t call;
+    trace_begin(&call, BCML_TRACE_OP_GET, type, (uint32_t)buffer_size);
+    bool ok = config_get(type, json_buffer, buffer_size);
+    trace_end(ok, ok ? json_buffer : NULL, ok && t_trace ? strlen(json_buffer) : 0);
+    BCML_PROBE2(get__done, type, ok);
+    return ok;
+}
+
+static bool config_get_bin(const char* type, uint8_t* buffer, size_t buffer_size, size_t* len) {
+    const config_handler_t* handler = find_handler(type);
+    if (!handler) {
+        BCML_LOG_ERROR("Unknown config type: %s\n", type);
+        return false;
+    }
+    if (!handler->export_bin) {
+        BCML_LOG_ERROR("%s has no binary form.\n", handler->type);
+        return false;
+    }
+
+    // The instance is current whether the device reported a change or not
+    if (config_fetch(handler, type) == SB_GET_FAILED)
+        return false;
+    if (!stage_export_bin(handler, buffer, buffer_size, len)) {
+        BCML_LOG_ERROR("%s export_bin failed.\n", handler->type);
+        return false;
+    }
+    // Same safety check as the JSON export
+    if (handler->validate_bin && !stage_validate_bin(handler, buffer, *len)) {
+        BCML_LOG_ERROR("%s exported binary config fails the schema.\n", handler->type);
+        return false;
+    }
+    BCML_LOG_INFO("bcml_config_get_bin: %s config exported (%zu bytes).\n", handler->type, *len);
+    return true;
+}
+
+bool bcml_config_get_bin(const char* type, void* buffer, size_t buffer_size, size_t* len) {
+    size_t out_len = 0;
+    if (!type || !buffer || buffer_size == 0) {
+        BCML_LOG_WARN("bcml_config_get_bin: Invalid input.\n");
+        return false;
+    }
+
+    BCML_PROBE2(get__start, type, buffer_size);
+    trace_call_t call;
+    trace_begin(&call, BCML_TRACE_OP_GET_BIN, type, (uint32_t)buffer_size);
+    bool ok = config_get_bin(type, (uint8_t*)buffer, buffer_size, &out_len);
+    trace_end(ok, ok ? buffer : NULL, out_len);
+    BCML_PROBE2(get__done, type, ok);
+    if (len)
+        *len = ok ? out_len : 0;
+    return ok;
+}
+
+// ---- Multi-type get ----
+//
+// Each distinct type is fetched once, in request order, through the public
+// bcml_config_get() (so probes and trace records stay per type); repeats are
+// copied from the first occurrence.
+
+#define CONFIG_NUM_HANDLERS (sizeof(config_handlers) / sizeof(config_handlers[0]))
+
+bool bcml_config_get_many(bcml_config_get_t* reqs, size_t count) {
+    if (!reqs || count == 0)
+        return false;
+
+    // Index of the first request of the same type; repeats are copied from it
+    size_t* dup_of = malloc(count * sizeof(*dup_of));
+    const config_handler_t** handlers = malloc(count * sizeof(*handlers));
+    if (!dup_of || !handlers) {
+        free(dup_of);
+        free(handlers);
+        return false;
+    }
+    bool all_ok = true;
+    for (size_t i = 0; i < count; ++i) {
+        reqs[i].ok = false;
+        dup_of[i] = i;
+        handlers[i] = reqs[i].buffer && reqs[i].buffer_size ? find_handler(reqs[i].type) : NULL;
+        if (!handlers[i]) {
+            BCML_LOG_ERROR("bcml_config_get_many: bad request %zu (%s)\n", i, reqs[i].type ? reqs[i].type : "(null)");
+            all_ok = false;
+            continue;
+        }
+        for (size_t j = 0; j < i; ++j) {
+            if (handlers[j] == handlers[i]) {
+                dup_of[i] = dup_of[j];
+                break;
+            }
+        }
+        if (dup_of[i] == i)
+            reqs[i].ok = bcml_config_get(reqs[i].type, reqs[i].buffer, reqs[i].buffer_size);
+    }
+
+    for (size_t i = 0; i < count; ++i) {
+        const bcml_config_get_t* src = &reqs[dup_of[i]];
+        if (dup_of[i] != i && src->ok) {
+            size_t len = strlen(src->buffer);
+            reqs[i].ok = len < reqs[i].buffer_size;
+            if (reqs[i].ok)
+                memcpy(reqs[i].buffer, src->buffer, len + 1);
+            else
+                reqs[i].buffer[0] = '\0';
+        }
+        all_ok = all_ok && reqs[i].ok;
+    }
+    free(dup_of);
+    free(handlers);
+    return all_ok;
+}
+
+// ---- Lifecycle ----
+
+// Large enough for any exported config, used once per type by a warm init
+#define CONFIG_WARM_BUF_SIZE (64 * 1024)
+
+static pthread_mutex_t g_lifecycle_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool g_initialized;
+static bool g_atexit_registered;
+
+static void lifecycle_atexit(void) {
+    bcml_shutdown();
+}
+
+// Fetch every type once: fills the snapshot, the export cache and the backends' own state
+static void config_warm(void) {
+    bcml_config_get_t reqs[CONFIG_NUM_HANDLERS];
+    char* buf = malloc(CONFIG_NUM_HANDLERS * CONFIG_WARM_BUF_SIZE);
+    if (!buf)
+        return;
+    for (size_t i = 0; i < CONFIG_NUM_HANDLERS; ++i) {
+        reqs[i].type = config_handlers[i].type;
+        reqs[i].buffer = buf + i * CONFIG_WARM_BUF_SIZE;
+        reqs[i].buffer_size = CONFIG_WARM_BUF_SIZE;
+    }
+    bcml_config_get_many(reqs, CONFIG_NUM_HANDLERS);
+    for (size_t i = 0; i < CONFIG_NUM_HANDLERS; ++i) {
+        if (!reqs[i].ok)
+            BCML_LOG_WARN("bcml_init: %s config not fetched, first get goes to the device\n", reqs[i].type);
+    }
+    free(buf);
+}
+
+bool bcml_init(unsigned int flags) {
+    pthread_mutex_lock(&g_lifecycle_lock);
+    if (g_initialized) {
+        pthread_mutex_unlock(&g_lifecycle_lock);
+        return true;
+    }
+
+    // Runtime limits from the schemas, otherwise read on each type's first request
+    for (size_t i = 0; i < sizeof(config_handlers) / sizeof(config_handlers[0]); ++i) {
+        if (config_handlers[i].load_limits)
+            pthread_once(config_handlers[i].limits_once, config_handlers[i].load_limits);
+    }
+    if (!sb_ops_init()) {
+        sb_ops_shutdown();
+        pthread_mutex_unlock(&g_lifecycle_lock);
+        return false;
+    }
+    if (flags & BCML_INIT_WARM)
+        config_warm();
+    if (!(flags & BCML_INIT_NO_ATEXIT) && !g_atexit_registered)
+        g_atexit_registered = atexit(lifecycle_atexit) == 0;
+
+    g_initialized = true;
+    pthread_mutex_unlock(&g_lifecycle_lock);
+    BCML_LOG_INFO("bcml_init: ready\n");
+    return true;
+}
+
+void bcml_shutdown(void) {
+    pthread_mutex_lock(&g_lifecycle_lock);
+    bcml_trace_close();
+    bcml_journal_close();
+    // The segment stays: readers keep the last snapshot across restarts
+    bcml_snapshot_publisher_close(false);
+    sb_ops_shutdown();
+    export_wireless_json_release();
+
+    for (size_t i = 0; i < sizeof(config_handlers) / sizeof(config_handlers[0]); ++i) {
+        config_handler_t* handler = &config_handlers[i];
+        if (handler->release)
+            handler->release(handler->cfg_instance);
+        if (handler->export_cache) {
+            free(handler->export_cache->json);
+            memset(handler->export_cache, 0, sizeof(*handler->export_cache));
+        }
+        if (handler->journal) {
+            if (handler->release)
+                handler->release(handler->journal->base);
+            handler->journal->base_valid = false;
+        }
+    }
+    g_initialized = false;
+    pthread_mutex_unlock(&g_lifecycle_lock);
+}
@@ -0,0 +1,100 @@
+#include "bcml_config.h"
+#include "bcml_log.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// bcml_config_get_many_json() on top of bcml_config_get_many(), shared by
+// libbcml and libbcml_client. Each type is exported to its own scratch buffer,
+// then the members of the top-level objects are spliced into one. Every
+// export is already wrapped in its type ({"wireless":{...}}), so the result
+// is {"wireless":{...},"display":{...}} and no key is written here.
+
+#define MANY_TYPE_JSON_MAX (64 * 1024)     // Scratch per type: the largest export, as bcmld's frames
+
+static bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Members of a top-level JSON object: the text between its outer braces
+static bool object_members(const char* json, const char** begin, size_t* len) {
+    const char* p = json;
+    while (is_space(*p))
+        ++p;
+    const char* end = p + strlen(p);
+    while (end > p && is_space(end[-1]))
+        --end;
+    if (end - p < 2 || *p != '{' || end[-1] != '}')
+        return false;
+    *begin = p + 1;
+    *len = (size_t)(end - p) - 2;
+    return true;
+}
+
+bool bcml_config_get_many_json(const char* const* types, size_t count, char* json_buffer, size_t buffer_size) {
+    if (!types || count == 0 || !json_buffer || buffer_size < 3) {
+        BCML_LOG_WARN("bcml_config_get_many_json: Invalid input.\n");
+        return false;
+    }
+    json_buffer[0] = '\0';
+
+    // No export can be larger than the document it goes into
+    size_t scratch_size = buffer_size < MANY_TYPE_JSON_MAX ? buffer_size : MANY_TYPE_JSON_MAX;
+    if (count > SIZE_MAX / sizeof(bcml_config_get_t) || scratch_size > SIZE_MAX / count) {
+        BCML_LOG_ERROR("bcml_config_get_many_json: too many types (%zu)\n", count);
+        return false;
+    }
+    bcml_config_get_t* reqs = calloc(count, sizeof(*reqs));
+    char* scratch = malloc(count * scratch_size);
+    if (!reqs || !scratch) {
+        free(reqs);
+        free(scratch);
+        return false;
+    }
+    for (size_t i = 0; i < count; ++i) {
+        reqs[i].type = types[i];
+        reqs[i].buffer = scratch + i * scratch_size;
+        reqs[i].buffer_size = scratch_size;
+    }
+    bool ok = bcml_config_get_many(reqs, count);
+
+    size_t pos = 0;
+    json_buffer[pos++] = '{';
+    for (size_t i = 0; ok && i < count; ++i) {
+        const char* members;
+        size_t len;
+        // A type listed twice appears once
+        size_t first = 0;
+        while (strcasecmp(types[first], types[i]) != 0)
+            ++first;
+        if (first < i)
+            continue;
+        if (!object_members(reqs[i].buffer, &members, &len)) {
+            BCML_LOG_ERROR("bcml_config_get_many_json: %s export is not a JSON object\n", types[i]);
+            ok = false;
+            break;
+        }
+        if (len == 0)
+            continue;
+        // Separator, members, and room for the closing brace and terminator
+        if (pos + (pos > 1) + len + 2 > buffer_size) {
+            BCML_LOG_ERROR("bcml_config_get_many_json: Buffer too small (given=%zu)\n", buffer_size);
+            ok = false;
+            break;
+        }
+        if (pos > 1)
+            json_buffer[pos++] = ',';
+        memcpy(json_buffer + pos, members, len);
+        pos += len;
+    }
+    if (ok) {
+        json_buffer[pos++] = '}';
+        json_buffer[pos] = '\0';
+    } else {
+        json_buffer[0] = '\0';
+    }
+    free(reqs);
+    free(scratch);
+    return ok;
+}
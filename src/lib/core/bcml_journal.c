@@ -0,0 +1,543 @@
+#include "bcml_journal.h"
+#include "bcml_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// File: 8-byte header (magic, version), then records back to back.
+// Record: 12-byte header (crc32, payload length, tag, flags, reserved) and
+// the payload. The CRC covers the header after the crc field and the
+// payload. Integers are in native byte order: the journal never leaves the host.
+
+#define JOURNAL_MAGIC       0x4a4d4342u     // "BCMJ"
+#define JOURNAL_VERSION     1
+#define JOURNAL_HDR_SIZE    8
+#define REC_HDR_SIZE        12
+#define REC_FLAG_FULL       0x01
+#define REC_MAX_LEN         (1u << 20)
+#define COPY_CHUNK          (64 * 1024)
+
+typedef struct {
+    off_t off;          // Record header offset
+    uint32_t len;       // Payload length
+    uint8_t tag;
+    bool full;
+} journal_rec_t;
+
+static struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;        // Sync finished, compaction requested, shutdown
+    int fd;
+    char* path;
+    unsigned keep;
+    journal_rec_t* recs;
+    size_t nrecs;
+    size_t cap;
+    off_t end;
+    uint64_t written;           // Records appended
+    uint64_t synced;            // Records known durable
+    bool syncing;               // An appender is in fdatasync() for the group
+    bool broken;                // A sync failed: durability unknown, refuse appends
+    bool appended[256];         // Tag has a record since open (the first one is a checkpoint)
+    size_t count[256];          // Records per tag
+    bool compact_wanted;
+    bool stop;
+    pthread_t compactor;
+} g_journal = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+    .fd = -1
+};
+
+// ---- CRC-32 (IEEE, reflected) ----
+
+static uint32_t g_crc_table[256];
+static pthread_once_t g_crc_once = PTHREAD_ONCE_INIT;
+
+static void crc_init(void) {
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k)
+            c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+        g_crc_table[i] = c;
+    }
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t* p, size_t len) {
+    crc = ~crc;
+    while (len--)
+        crc = g_crc_table[(crc ^ *p++) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+// CRC of a record: header after the crc field, then the payload
+static uint32_t rec_crc(const uint8_t* hdr, const uint8_t* payload, size_t len) {
+    return crc32_update(crc32_update(0, hdr + 4, REC_HDR_SIZE - 4), payload, len);
+}
+
+// ---- I/O helpers ----
+
+static bool pwrite_all(int fd, const void* buf, size_t len, off_t off) {
+    const uint8_t* p = buf;
+    while (len) {
+        ssize_t n = pwrite(fd, p, len, off);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= (size_t)n;
+        off += n;
+    }
+    return true;
+}
+
+static bool pread_all(int fd, void* buf, size_t len, off_t off) {
+    uint8_t* p = buf;
+    while (len) {
+        ssize_t n = pread(fd, p, len, off);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return false;
+        p += n;
+        len -= (size_t)n;
+        off += n;
+    }
+    return true;
+}
+
+// Copy [from, to) of src to dst starting at dst_off
+static bool copy_range(int src, off_t from, off_t to, int dst, off_t dst_off) {
+    static uint8_t buf[COPY_CHUNK];     // Only the compactor copies
+    while (from < to) {
+        size_t n = (size_t)(to - from) < sizeof(buf) ? (size_t)(to - from) : sizeof(buf);
+        if (!pread_all(src, buf, n, from) || !pwrite_all(dst, buf, n, dst_off))
+            return false;
+        from += (off_t)n;
+        dst_off += (off_t)n;
+    }
+    return true;
+}
+
+static void fsync_parent_dir(const char* path) {
+    char dir[PATH_MAX];
+    snprintf(dir, sizeof(dir), "%s", path);
+    char* slash = strrchr(dir, '/');
+    if (!slash)
+        snprintf(dir, sizeof(dir), ".");
+    else if (slash == dir)
+        dir[1] = '\0';
+    else
+        *slash = '\0';
+    int fd = open(dir, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+}
+
+// ---- Index ----
+
+static bool index_add_locked(off_t off, uint32_t len, uint8_t tag, bool full) {
+    if (g_journal.nrecs == g_journal.cap) {
+        size_t cap = g_journal.cap ? g_journal.cap * 2 : 64;
+        journal_rec_t* p = realloc(g_journal.recs, cap * sizeof(*p));
+        if (!p)
+            return false;
+        g_journal.recs = p;
+        g_journal.cap = cap;
+    }
+    g_journal.recs[g_journal.nrecs++] = (journal_rec_t){ off, len, tag, full };
+    g_journal.count[tag]++;
+    return true;
+}
+
+// Index of the record `generations` back among the tag's records, -1 if none
+static long find_generation_locked(uint8_t tag, unsigned generations) {
+    for (size_t i = g_journal.nrecs; i-- > 0;) {
+        if (g_journal.recs[i].tag != tag)
+            continue;
+        if (generations-- == 0)
+            return (long)i;
+    }
+    return -1;
+}
+
+// Checkpoint of the tag at or before record i, -1 if none
+static long find_checkpoint_locked(uint8_t tag, long i) {
+    for (; i >= 0; --i) {
+        if (g_journal.recs[i].tag == tag && g_journal.recs[i].full)
+            return i;
+    }
+    return -1;
+}
+
+// ---- Compaction ----
+
+// First record to keep: every tag keeps its last `keep` records plus the
+// checkpoint they start from
+static size_t compact_cut_locked(void) {
+    size_t cut = g_journal.nrecs;
+    for (unsigned tag = 0; tag < 256; ++tag) {
+        if (!g_journal.count[tag])
+            continue;
+        unsigned back = g_journal.count[tag] > g_journal.keep ? g_journal.keep - 1
+                                                              : (unsigned)g_journal.count[tag] - 1;
+        long first = find_generation_locked((uint8_t)tag, back);
+        long cp = find_checkpoint_locked((uint8_t)tag, first);
+        if (cp < 0)
+            return 0;   // Deltas without a checkpoint: keep everything
+        if ((size_t)cp < cut)
+            cut = (size_t)cp;
+    }
+    return cut;
+}
+
+static void compact(void) {
+    char tmp[PATH_MAX];
+
+    pthread_mutex_lock(&g_journal.lock);
+    size_t cut = compact_cut_locked();
+    if (cut == 0 || cut >= g_journal.nrecs) {
+        pthread_mutex_unlock(&g_journal.lock);
+        return;
+    }
+    int src = g_journal.fd;             // Only this thread replaces the fd
+    off_t cut_off = g_journal.recs[cut].off;
+    off_t snap_end = g_journal.end;
+    snprintf(tmp, sizeof(tmp), "%s.compact", g_journal.path);
+    pthread_mutex_unlock(&g_journal.lock);
+
+    // Bulk copy without the lock: records before snap_end never change
+    uint32_t hdr[2] = { JOURNAL_MAGIC, JOURNAL_VERSION };
+    int dst = open(tmp, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    if (dst < 0 || !pwrite_all(dst, hdr, sizeof(hdr), 0) ||
+        !copy_range(src, cut_off, snap_end, dst, JOURNAL_HDR_SIZE) || fsync(dst) < 0)
+        goto fail;
+
+    pthread_mutex_lock(&g_journal.lock);
+    while (g_journal.syncing)
+        pthread_cond_wait(&g_journal.cond, &g_journal.lock);
+    off_t shift = cut_off - JOURNAL_HDR_SIZE;
+    if (!copy_range(src, snap_end, g_journal.end, dst, snap_end - shift) || fsync(dst) < 0 ||
+        rename(tmp, g_journal.path) < 0) {
+        pthread_mutex_unlock(&g_journal.lock);
+        goto fail;
+    }
+    fsync_parent_dir(g_journal.path);
+
+    for (size_t i = 0; i < cut; ++i)
+        g_journal.count[g_journal.recs[i].tag]--;
+    memmove(g_journal.recs, g_journal.recs + cut, (g_journal.nrecs - cut) * sizeof(*g_journal.recs));
+    g_journal.nrecs -= cut;
+    for (size_t i = 0; i < g_journal.nrecs; ++i)
+        g_journal.recs[i].off -= shift;
+    g_journal.end -= shift;
+    g_journal.fd = dst;
+    g_journal.synced = g_journal.written;   // Everything was just fsynced in the new file
+    pthread_mutex_unlock(&g_journal.lock);
+    close(src);
+    BCML_LOG_INFO("bcml_journal: compacted, dropped %zu records (%lld bytes)\n", cut, (long long)shift);
+    return;
+
+fail:
+    BCML_LOG_ERROR("bcml_journal: compaction failed: %s\n", strerror(errno));
+    if (dst >= 0) {
+        close(dst);
+        unlink(tmp);
+    }
+}
+
+static void* compactor_main(void* arg) {
+    (void)arg;
+    pthread_mutex_lock(&g_journal.lock);
+    while (!g_journal.stop) {
+        if (!g_journal.compact_wanted) {
+            pthread_cond_wait(&g_journal.cond, &g_journal.lock);
+            continue;
+        }
+        g_journal.compact_wanted = false;
+        pthread_mutex_unlock(&g_journal.lock);
+        compact();
+        pthread_mutex_lock(&g_journal.lock);
+    }
+    pthread_mutex_unlock(&g_journal.lock);
+    return NULL;
+}
+
+// ---- Open / close ----
+
+// Index every intact record; false if the file is not a journal
+static bool load_locked(int fd, off_t size) {
+    uint32_t hdr[2];
+    if (size == 0) {
+        hdr[0] = JOURNAL_MAGIC;
+        hdr[1] = JOURNAL_VERSION;
+        if (!pwrite_all(fd, hdr, sizeof(hdr), 0) || fsync(fd) < 0)
+            return false;
+        g_journal.end = JOURNAL_HDR_SIZE;
+        return true;
+    }
+    if (size < JOURNAL_HDR_SIZE || !pread_all(fd, hdr, sizeof(hdr), 0) ||
+        hdr[0] != JOURNAL_MAGIC || hdr[1] != JOURNAL_VERSION) {
+        BCML_LOG_ERROR("bcml_journal: not a journal (or another version)\n");
+        return false;
+    }
+
+    uint8_t* payload = malloc(REC_MAX_LEN);
+    if (!payload)
+        return false;
+    off_t off = JOURNAL_HDR_SIZE;
+    while (off + REC_HDR_SIZE <= size) {
+        uint8_t rh[REC_HDR_SIZE];
+        uint32_t crc, len;
+        if (!pread_all(fd, rh, sizeof(rh), off))
+            break;
+        memcpy(&crc, rh, 4);
+        memcpy(&len, rh + 4, 4);
+        if (len > REC_MAX_LEN || off + REC_HDR_SIZE + (off_t)len > size ||
+            !pread_all(fd, payload, len, off + REC_HDR_SIZE) || rec_crc(rh, payload, len) != crc)
+            break;
+        if (!index_add_locked(off, len, rh[8], (rh[9] & REC_FLAG_FULL) != 0)) {
+            free(payload);
+            return false;
+        }
+        off += REC_HDR_SIZE + (off_t)len;
+    }
+    free(payload);
+
+    // Whatever follows the last intact record is a write cut short by a crash
+    if (off < size) {
+        BCML_LOG_WARN("bcml_journal: dropping %lld bytes of torn/corrupt tail\n", (long long)(size - off));
+        if (ftruncate(fd, off) < 0 || fsync(fd) < 0)
+            return false;
+    }
+    g_journal.end = off;
+    return true;
+}
+
+static void reset_locked(void) {
+    free(g_journal.recs);
+    free(g_journal.path);
+    g_journal.recs = NULL;
+    g_journal.path = NULL;
+    g_journal.nrecs = g_journal.cap = 0;
+    g_journal.end = 0;
+    g_journal.written = g_journal.synced = 0;
+    g_journal.broken = false;
+    g_journal.compact_wanted = false;
+    g_journal.stop = false;
+    memset(g_journal.appended, 0, sizeof(g_journal.appended));
+    memset(g_journal.count, 0, sizeof(g_journal.count));
+}
+
+bool bcml_journal_open(const char* path, unsigned keep) {
+    if (!path) {
+        BCML_LOG_WARN("bcml_journal_open: path is NULL\n");
+        return false;
+    }
+    pthread_once(&g_crc_once, crc_init);
+
+    pthread_mutex_lock(&g_journal.lock);
+    if (g_journal.fd >= 0) {
+        pthread_mutex_unlock(&g_journal.lock);
+        BCML_LOG_ERROR("bcml_journal_open: a journal is already open\n");
+        return false;
+    }
+    reset_locked();
+
+    struct stat st;
+    int fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd < 0 || fstat(fd, &st) < 0) {
+        BCML_LOG_ERROR("bcml_journal_open: %s: %s\n", path, strerror(errno));
+        goto fail;
+    }
+    g_journal.path = strdup(path);
+    g_journal.keep = keep ? keep : BCML_JOURNAL_KEEP_DEFAULT;
+    if (!g_journal.path || !load_locked(fd, st.st_size))
+        goto fail;
+    g_journal.fd = fd;
+    if (pthread_create(&g_journal.compactor, NULL, compactor_main, NULL) != 0) {
+        g_journal.fd = -1;
+        goto fail;
+    }
+    BCML_LOG_INFO("bcml_journal_open: %s, %zu records\n", path, g_journal.nrecs);
+    pthread_mutex_unlock(&g_journal.lock);
+    return true;
+
+fail:
+    if (fd >= 0)
+        close(fd);
+    reset_locked();
+    pthread_mutex_unlock(&g_journal.lock);
+    return false;
+}
+
+void bcml_journal_close(void) {
+    pthread_mutex_lock(&g_journal.lock);
+    if (g_journal.fd < 0) {
+        pthread_mutex_unlock(&g_journal.lock);
+        return;
+    }
+    g_journal.stop = true;
+    pthread_cond_broadcast(&g_journal.cond);
+    pthread_mutex_unlock(&g_journal.lock);
+    pthread_join(g_journal.compactor, NULL);
+
+    pthread_mutex_lock(&g_journal.lock);
+    while (g_journal.syncing)
+        pthread_cond_wait(&g_journal.cond, &g_journal.lock);
+    close(g_journal.fd);
+    g_journal.fd = -1;
+    reset_locked();
+    pthread_mutex_unlock(&g_journal.lock);
+}
+
+bool bcml_journal_is_open(void) {
+    pthread_mutex_lock(&g_journal.lock);
+    bool open = g_journal.fd >= 0;
+    pthread_mutex_unlock(&g_journal.lock);
+    return open;
+}
+
+// ---- Append / replay ----
+
+bool bcml_journal_want_checkpoint(uint8_t tag) {
+    pthread_mutex_lock(&g_journal.lock);
+    bool want = !g_journal.appended[tag];
+    if (!want) {
+        long i = find_checkpoint_locked(tag, (long)g_journal.nrecs - 1);
+        size_t since = 0;
+        for (size_t k = (size_t)(i + 1); k < g_journal.nrecs; ++k)
+            since += g_journal.recs[k].tag == tag;
+        want = i < 0 || since + 1 >= BCML_JOURNAL_CHECKPOINT_EVERY;
+    }
+    pthread_mutex_unlock(&g_journal.lock);
+    return want;
+}
+
+bool bcml_journal_append(uint8_t tag, bool full, const void* data, size_t len) {
+    if (!data || len > REC_MAX_LEN)
+        return false;
+
+    uint8_t* rec = malloc(REC_HDR_SIZE + len);
+    if (!rec)
+        return false;
+    uint32_t len32 = (uint32_t)len;
+    memcpy(rec + 4, &len32, 4);
+    rec[8] = tag;
+    rec[9] = full ? REC_FLAG_FULL : 0;
+    rec[10] = rec[11] = 0;
+    memcpy(rec + REC_HDR_SIZE, data, len);
+    uint32_t crc = rec_crc(rec, rec + REC_HDR_SIZE, len);
+    memcpy(rec, &crc, 4);
+
+    pthread_mutex_lock(&g_journal.lock);
+    bool ok = g_journal.fd >= 0 && !g_journal.broken &&
+              pwrite_all(g_journal.fd, rec, REC_HDR_SIZE + len, g_journal.end) &&
+              index_add_locked(g_journal.end, len32, tag, full);
+    free(rec);
+    if (!ok) {
+        // Leave no partial record behind for the next append to follow
+        if (g_journal.fd >= 0 && ftruncate(g_journal.fd, g_journal.end) < 0)
+            g_journal.broken = true;
+        pthread_mutex_unlock(&g_journal.lock);
+        BCML_LOG_ERROR("bcml_journal_append: write failed\n");
+        return false;
+    }
+    g_journal.end += REC_HDR_SIZE + (off_t)len;
+    g_journal.appended[tag] = true;
+    uint64_t mine = ++g_journal.written;
+
+    // Group commit: one appender syncs for everything written so far, the others wait for it
+    while (g_journal.synced < mine && !g_journal.broken) {
+        if (g_journal.syncing) {
+            pthread_cond_wait(&g_journal.cond, &g_journal.lock);
+            continue;
+        }
+        g_journal.syncing = true;
+        uint64_t target = g_journal.written;
+        int fd = g_journal.fd;
+        pthread_mutex_unlock(&g_journal.lock);
+        int rc = fdatasync(fd);
+        pthread_mutex_lock(&g_journal.lock);
+        g_journal.syncing = false;
+        if (rc == 0) {
+            if (target > g_journal.synced)
+                g_journal.synced = target;
+        } else {
+            BCML_LOG_ERROR("bcml_journal_append: fdatasync: %s\n", strerror(errno));
+            g_journal.broken = true;
+        }
+        pthread_cond_broadcast(&g_journal.cond);
+    }
+    ok = g_journal.synced >= mine;
+
+    if (g_journal.count[tag] >= 2 * (size_t)g_journal.keep + BCML_JOURNAL_CHECKPOINT_EVERY) {
+        g_journal.compact_wanted = true;
+        pthread_cond_broadcast(&g_journal.cond);
+    }
+    pthread_mutex_unlock(&g_journal.lock);
+    return ok;
+}
+
+bool bcml_journal_replay(uint8_t tag, unsigned generations,
+                         bool (*apply)(void* ctx, bool full, const uint8_t* data, size_t len), void* ctx) {
+    if (!apply)
+        return false;
+
+    // Read the records under the lock (compaction moves them), apply them after
+    pthread_mutex_lock(&g_journal.lock);
+    long last = g_journal.fd >= 0 ? find_generation_locked(tag, generations) : -1;
+    long first = last >= 0 ? find_checkpoint_locked(tag, last) : -1;
+    if (first < 0) {
+        pthread_mutex_unlock(&g_journal.lock);
+        BCML_LOG_ERROR("bcml_journal_replay: journal does not go back %u generations\n", generations);
+        return false;
+    }
+    size_t total = 0, n = 0;
+    for (long i = first; i <= last; ++i) {
+        if (g_journal.recs[i].tag == tag) {
+            total += REC_HDR_SIZE + g_journal.recs[i].len;
+            ++n;
+        }
+    }
+    uint8_t* buf = malloc(total);
+    bool ok = buf != NULL;
+    size_t off = 0;
+    for (long i = first; ok && i <= last; ++i) {
+        const journal_rec_t* r = &g_journal.recs[i];
+        if (r->tag != tag)
+            continue;
+        uint32_t crc;
+        ok = pread_all(g_journal.fd, buf + off, REC_HDR_SIZE + r->len, r->off);
+        memcpy(&crc, buf + off, 4);
+        ok = ok && rec_crc(buf + off, buf + off + REC_HDR_SIZE, r->len) == crc;
+        off += REC_HDR_SIZE + r->len;
+    }
+    pthread_mutex_unlock(&g_journal.lock);
+    if (!ok) {
+        BCML_LOG_ERROR("bcml_journal_replay: cannot read records: %s\n", buf ? "read or checksum error" : "out of memory");
+        free(buf);
+        return false;
+    }
+
+    off = 0;
+    for (size_t i = 0; ok && i < n; ++i) {
+        uint32_t len;
+        memcpy(&len, buf + off + 4, 4);
+        ok = apply(ctx, (buf[off + 9] & REC_FLAG_FULL) != 0, buf + off + REC_HDR_SIZE, len);
+        off += REC_HDR_SIZE + len;
+    }
+    free(buf);
+    if (!ok)
+        BCML_LOG_ERROR("bcml_journal_replay: record rejected\n");
+    return ok;
+}
@@ -0,0 +1,290 @@
+#include "bcml_snapshot.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <errno.h>
+#include <sched.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Seqlock over a shared-memory segment.
+//
+// seq is even when the snapshot is stable and odd while the publisher writes
+// it. Readers load seq, copy, and load it again: the copy is consistent if
+// both loads saw the same even value. The payload is moved as 64-bit relaxed
+// atomics so the concurrent copy is well-defined; the fences order it against
+// seq. Publishers take the seqlock with a CAS, so a second publishing process
+// waits instead of corrupting the snapshot.
+//
+// The payload has room for BCML_RADIO_LIMIT radios and BCML_SSID_LIMIT SSIDs:
+// one word with the counts, then the radio area, then the SSID area, unused
+// entries zeroed. Readers copy only the entries in use.
+
+#define SNAP_MAGIC          0x42434d53u     // "BCMS"
+#define SNAP_VERSION        2
+#define SNAP_RADIO_WORDS    ((BCML_RADIO_LIMIT * sizeof(bcml_wireless_radio_t) + 7) / 8)
+#define SNAP_SSID_WORDS     ((BCML_SSID_LIMIT * sizeof(bcml_wireless_ssid_t) + 7) / 8)
+#define SNAP_RADIO_OFF      1
+#define SNAP_SSID_OFF       (SNAP_RADIO_OFF + SNAP_RADIO_WORDS)
+#define SNAP_WORDS          (SNAP_SSID_OFF + SNAP_SSID_WORDS)
+#define SNAP_ENTRY_SIZES    ((uint32_t)(sizeof(bcml_wireless_radio_t) << 16 | sizeof(bcml_wireless_ssid_t)))
+#define SNAP_READ_RETRIES   100000
+#define SNAP_WRITE_SPINS    1000000
+
+typedef struct {
+    uint32_t magic;         // Stored last on initialization
+    uint32_t version;
+    uint32_t cfg_size;      // SNAP_ENTRY_SIZES of the publisher
+    uint32_t reserved;
+    uint64_t seq;
+    uint64_t generation;
+    uint64_t wireless[SNAP_WORDS];
+} snap_shm_t;
+
+struct bcml_snapshot {
+    const snap_shm_t* shm;
+};
+
+static snap_shm_t* g_pub;
+static char g_pub_name[256];
+
+static inline void cpu_relax(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#endif
+}
+
+static bool layout_matches(const snap_shm_t* shm) {
+    return __atomic_load_n(&shm->magic, __ATOMIC_ACQUIRE) == SNAP_MAGIC &&
+           shm->version == SNAP_VERSION && shm->cfg_size == SNAP_ENTRY_SIZES;
+}
+
+// ---- Publisher ----
+
+bool bcml_snapshot_publisher_open(const char* name, unsigned int mode) {
+    if (!name)
+        name = BCML_SNAPSHOT_SHM_NAME;
+    if (mode == 0)
+        mode = BCML_SNAPSHOT_MODE;
+    // Never world-accessible: the payload carries the SSID passwords
+    if (mode & ~0770u) {
+        BCML_LOG_ERROR("bcml_snapshot: mode %03o would expose %s to other users\n", mode, name);
+        return false;
+    }
+    if (g_pub)
+        bcml_snapshot_publisher_close(false);
+
+    int fd = shm_open(name, O_CREAT | O_RDWR | O_CLOEXEC, (mode_t)mode);
+    if (fd < 0) {
+        BCML_LOG_ERROR("bcml_snapshot: shm_open %s: %s\n", name, strerror(errno));
+        return false;
+    }
+    // shm_open() applies the umask, and keeps the mode of an existing segment
+    // (possibly created by an older, laxer build)
+    if (fchmod(fd, (mode_t)mode) < 0) {
+        BCML_LOG_ERROR("bcml_snapshot: cannot set mode %03o on %s: %s\n", mode, name, strerror(errno));
+        close(fd);
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) < 0 || ((size_t)st.st_size < sizeof(snap_shm_t) && ftruncate(fd, sizeof(snap_shm_t)) < 0)) {
+        BCML_LOG_ERROR("bcml_snapshot: cannot size %s: %s\n", name, strerror(errno));
+        close(fd);
+        return false;
+    }
+    snap_shm_t* shm = mmap(NULL, sizeof(snap_shm_t), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED) {
+        BCML_LOG_ERROR("bcml_snapshot: mmap %s: %s\n", name, strerror(errno));
+        return false;
+    }
+
+    if (!layout_matches(shm)) {
+        // New segment, or written by an incompatible build: start over
+        __atomic_store_n(&shm->magic, 0, __ATOMIC_RELEASE);
+        memset(shm->wireless, 0, sizeof(shm->wireless));
+        shm->version = SNAP_VERSION;
+        shm->cfg_size = SNAP_ENTRY_SIZES;
+        __atomic_store_n(&shm->seq, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&shm->generation, 0, __ATOMIC_RELAXED);
+        __atomic_store_n(&shm->magic, SNAP_MAGIC, __ATOMIC_RELEASE);
+    } else if (__atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE) & 1) {
+        // A previous publisher died mid-update; readers would never see a stable copy
+        BCML_LOG_WARN("bcml_snapshot: %s left mid-update, releasing it\n", name);
+        __atomic_fetch_add(&shm->seq, 1, __ATOMIC_RELEASE);
+    }
+
+    g_pub = shm;
+    snprintf(g_pub_name, sizeof(g_pub_name), "%s", name);
+    BCML_LOG_INFO("bcml_snapshot: publishing to %s (generation %llu)\n", name,
+                  (unsigned long long)__atomic_load_n(&shm->generation, __ATOMIC_RELAXED));
+    return true;
+}
+
+void bcml_snapshot_publisher_close(bool unlink) {
+    if (!g_pub)
+        return;
+    munmap(g_pub, sizeof(snap_shm_t));
+    g_pub = NULL;
+    if (unlink)
+        shm_unlink(g_pub_name);
+}
+
+void bcml_snapshot_publish_wireless(const bcml_wireless_cfg_t* cfg) {
+    snap_shm_t* shm = g_pub;
+    uint64_t words[SNAP_WORDS];
+    if (!shm || !cfg)
+        return;
+
+    if (cfg->radio_count < 0 || cfg->radio_count > BCML_RADIO_LIMIT ||
+        cfg->ssid_count < 0 || cfg->ssid_count > BCML_SSID_LIMIT)
+        return;
+    memset(words, 0, sizeof(words));
+    words[0] = (uint64_t)cfg->radio_count | (uint64_t)cfg->ssid_count << 32;
+    if (cfg->radio_count)
+        memcpy(&words[SNAP_RADIO_OFF], cfg->radio, (size_t)cfg->radio_count * sizeof(*cfg->radio));
+    if (cfg->ssid_count)
+        memcpy(&words[SNAP_SSID_OFF], cfg->ssid, (size_t)cfg->ssid_count * sizeof(*cfg->ssid));
+
+    // Common case (periodic get, nothing changed): leave seq alone so readers never retry
+    uint64_t seq = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+    if (!(seq & 1) && __atomic_load_n(&shm->generation, __ATOMIC_RELAXED) != 0) {
+        size_t i = 0;
+        while (i < SNAP_WORDS && __atomic_load_n(&shm->wireless[i], __ATOMIC_RELAXED) == words[i])
+            ++i;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (i == SNAP_WORDS && __atomic_load_n(&shm->seq, __ATOMIC_RELAXED) == seq)
+            return;
+    }
+
+    // Acquire the seqlock
+    int spins = 0;
+    for (;;) {
+        seq = __atomic_load_n(&shm->seq, __ATOMIC_RELAXED);
+        if (!(seq & 1) && __atomic_compare_exchange_n(&shm->seq, &seq, seq + 1, false,
+                                                      __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+            break;
+        if (++spins >= SNAP_WRITE_SPINS) {
+            BCML_LOG_WARN("bcml_snapshot: another publisher holds the snapshot, skipped\n");
+            return;
+        }
+        cpu_relax();
+    }
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    // Only a changed config is a new generation; the lock holder is the sole writer
+    uint64_t gen = __atomic_load_n(&shm->generation, __ATOMIC_RELAXED);
+    bool changed = gen == 0;
+    for (size_t i = 0; i < SNAP_WORDS; ++i) {
+        if (__atomic_load_n(&shm->wireless[i], __ATOMIC_RELAXED) != words[i]) {
+            __atomic_store_n(&shm->wireless[i], words[i], __ATOMIC_RELAXED);
+            changed = true;
+        }
+    }
+    if (changed)
+        __atomic_store_n(&shm->generation, gen + 1, __ATOMIC_RELAXED);
+
+    __atomic_store_n(&shm->seq, seq + 2, __ATOMIC_RELEASE);
+    if (changed)
+        BCML_LOG_DEBUG("bcml_snapshot: wireless generation %llu\n", (unsigned long long)(gen + 1));
+}
+
+// ---- Reader ----
+
+bcml_snapshot_t* bcml_snapshot_open(const char* name) {
+    if (!name)
+        name = BCML_SNAPSHOT_SHM_NAME;
+
+    int fd = shm_open(name, O_RDONLY | O_CLOEXEC, 0);
+    if (fd < 0)
+        return NULL;
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(snap_shm_t)) {
+        close(fd);
+        return NULL;
+    }
+    const snap_shm_t* shm = mmap(NULL, sizeof(snap_shm_t), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shm == MAP_FAILED)
+        return NULL;
+    if (!layout_matches(shm)) {
+        BCML_LOG_WARN("bcml_snapshot: %s has an incompatible layout\n", name);
+        munmap((void*)shm, sizeof(snap_shm_t));
+        return NULL;
+    }
+
+    bcml_snapshot_t* snap = malloc(sizeof(*snap));
+    if (!snap) {
+        munmap((void*)shm, sizeof(snap_shm_t));
+        return NULL;
+    }
+    snap->shm = shm;
+    return snap;
+}
+
+void bcml_snapshot_close(bcml_snapshot_t* snap) {
+    if (!snap)
+        return;
+    munmap((void*)snap->shm, sizeof(snap_shm_t));
+    free(snap);
+}
+
+uint64_t bcml_snapshot_generation(const bcml_snapshot_t* snap) {
+    return snap ? __atomic_load_n(&snap->shm->generation, __ATOMIC_ACQUIRE) : 0;
+}
+
+bool bcml_snapshot_read_wireless(const bcml_snapshot_t* snap, bcml_wireless_cfg_t* cfg, uint64_t* generation) {
+    if (!snap || !cfg)
+        return false;
+    const snap_shm_t* shm = snap->shm;
+    uint64_t words[SNAP_WORDS];
+    uint32_t nr, ns;
+
+    for (int tries = 0; tries < SNAP_READ_RETRIES; ++tries) {
+        uint64_t seq = __atomic_load_n(&shm->seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            // Publisher mid-update; if it was preempted, let it run
+            if ((tries & 63) == 63)
+                sched_yield();
+            else
+                cpu_relax();
+            continue;
+        }
+        uint64_t gen = __atomic_load_n(&shm->generation, __ATOMIC_RELAXED);
+        uint64_t counts = __atomic_load_n(&shm->wireless[0], __ATOMIC_RELAXED);
+        nr = (uint32_t)counts;
+        ns = (uint32_t)(counts >> 32);
+        // Torn counts are caught by the seq check below and bad ones after it;
+        // either way the copy stays inside words[]
+        size_t radio_words = ((size_t)(nr > BCML_RADIO_LIMIT ? 0 : nr) * sizeof(bcml_wireless_radio_t) + 7) / 8;
+        size_t ssid_words = ((size_t)(ns > BCML_SSID_LIMIT ? 0 : ns) * sizeof(bcml_wireless_ssid_t) + 7) / 8;
+        for (size_t i = 0; i < radio_words; ++i)
+            words[SNAP_RADIO_OFF + i] = __atomic_load_n(&shm->wireless[SNAP_RADIO_OFF + i], __ATOMIC_RELAXED);
+        for (size_t i = 0; i < ssid_words; ++i)
+            words[SNAP_SSID_OFF + i] = __atomic_load_n(&shm->wireless[SNAP_SSID_OFF + i], __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&shm->seq, __ATOMIC_RELAXED) != seq)
+            continue;
+
+        // The segment may be writable by others than the publisher: trust nothing in it
+        if (nr > BCML_RADIO_LIMIT || ns > BCML_SSID_LIMIT) {
+            BCML_LOG_WARN("bcml_snapshot: bad counts %u/%u in segment\n", nr, ns);
+            return false;
+        }
+        if (gen == 0 || !bcml_wireless_cfg_resize(cfg, (int)nr, (int)ns))
+            return false;
+        if (nr)
+            memcpy(cfg->radio, &words[SNAP_RADIO_OFF], nr * sizeof(*cfg->radio));
+        if (ns)
+            memcpy(cfg->ssid, &words[SNAP_SSID_OFF], ns * sizeof(*cfg->ssid));
+        if (generation)
+            *generation = gen;
+        return true;
+    }
+    BCML_LOG_WARN("bcml_snapshot: publisher stalled, no consistent snapshot\n");
+    return false;
+}
@@ -0,0 +1,277 @@
+#include "bcml_trace.h"
+#include "bcml_log.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+// File: 16-byte header (magic, version, reserved, wall clock at open in ns),
+// then records back to back. Record: payload length (u32, the bytes after
+// it), the fixed fields below, then type, payload and southbound config.
+
+#define TRACE_MAGIC         0x544d4342u     // "BCMT"
+#define TRACE_VERSION       1
+#define TRACE_HDR_SIZE      16
+// op, flags, sb_status, type length, start, total, stages, arg, payload and sb lengths
+#define REC_FIXED_SIZE      (4 + 8 + 8 + 4 * BCML_TRACE_STAGE_COUNT + 4 + 4 + 4)
+#define REC_FLAG_OK         0x01
+#define REC_MAX_LEN         (16u << 20)
+#define TRACE_BUF_SIZE      (64 * 1024)
+
+static struct {
+    pthread_mutex_t lock;
+    FILE* fp;
+    bool active;            // Read without the lock on every call
+    uint64_t t0;            // bcml_trace_now() at open
+    uint64_t records;
+} g_trace = {
+    .lock = PTHREAD_MUTEX_INITIALIZER
+};
+
+// ---- Little-endian helpers ----
+
+static void put_u16(uint8_t* p, uint16_t v) {
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void put_u32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static void put_u64(uint8_t* p, uint64_t v) {
+    for (int i = 0; i < 8; ++i)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint16_t get_u16(const uint8_t* p) {
+    return (uint16_t)(p[0] | p[1] << 8);
+}
+
+static uint32_t get_u32(const uint8_t* p) {
+    uint32_t v = 0;
+    for (int i = 3; i >= 0; --i)
+        v = v << 8 | p[i];
+    return v;
+}
+
+static uint64_t get_u64(const uint8_t* p) {
+    uint64_t v = 0;
+    for (int i = 7; i >= 0; --i)
+        v = v << 8 | p[i];
+    return v;
+}
+
+// ---- Recording ----
+
+uint64_t bcml_trace_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+bool bcml_trace_open(const char* path) {
+    if (!path)
+        return false;
+
+    pthread_mutex_lock(&g_trace.lock);
+    if (g_trace.fp) {
+        pthread_mutex_unlock(&g_trace.lock);
+        BCML_LOG_ERROR("bcml_trace_open: a trace is already open\n");
+        return false;
+    }
+    // Records carry set requests and get responses, passwords included: owner only,
+    // also when truncating a file that had a wider mode
+    int fd = open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+    FILE* fp = fd >= 0 && fchmod(fd, 0600) == 0 ? fdopen(fd, "wb") : NULL;
+    if (!fp) {
+        if (fd >= 0)
+            close(fd);
+        pthread_mutex_unlock(&g_trace.lock);
+        BCML_LOG_ERROR("bcml_trace_open: cannot create %s: %s\n", path, strerror(errno));
+        return false;
+    }
+    setvbuf(fp, NULL, _IOFBF, TRACE_BUF_SIZE);
+
+    struct timespec wall;
+    clock_gettime(CLOCK_REALTIME, &wall);
+    uint8_t hdr[TRACE_HDR_SIZE];
+    put_u32(hdr, TRACE_MAGIC);
+    put_u16(hdr + 4, TRACE_VERSION);
+    put_u16(hdr + 6, 0);
+    put_u64(hdr + 8, (uint64_t)wall.tv_sec * 1000000000u + (uint64_t)wall.tv_nsec);
+    if (fwrite(hdr, sizeof(hdr), 1, fp) != 1) {
+        fclose(fp);
+        pthread_mutex_unlock(&g_trace.lock);
+        BCML_LOG_ERROR("bcml_trace_open: cannot write %s\n", path);
+        return false;
+    }
+
+    g_trace.fp = fp;
+    g_trace.t0 = bcml_trace_now();
+    g_trace.records = 0;
+    __atomic_store_n(&g_trace.active, true, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&g_trace.lock);
+    BCML_LOG_INFO("bcml_trace_open: recording calls to %s\n", path);
+    return true;
+}
+
+void bcml_trace_close(void) {
+    pthread_mutex_lock(&g_trace.lock);
+    __atomic_store_n(&g_trace.active, false, __ATOMIC_RELEASE);
+    if (g_trace.fp) {
+        if (fclose(g_trace.fp) != 0)
+            BCML_LOG_ERROR("bcml_trace_close: trace tail not written\n");
+        g_trace.fp = NULL;
+        BCML_LOG_INFO("bcml_trace_close: %llu calls recorded\n", (unsigned long long)g_trace.records);
+    }
+    pthread_mutex_unlock(&g_trace.lock);
+}
+
+bool bcml_trace_is_open(void) {
+    return __atomic_load_n(&g_trace.active, __ATOMIC_ACQUIRE);
+}
+
+bool bcml_trace_append(const bcml_trace_rec_t* rec) {
+    size_t type_len = strnlen(rec->type, BCML_TRACE_TYPE_MAX);
+    size_t len = REC_FIXED_SIZE + type_len + rec->payload_len + rec->sb_len;
+    if (len > REC_MAX_LEN) {
+        BCML_LOG_WARN("bcml_trace_append: %zu-byte record dropped\n", len);
+        return false;
+    }
+
+    uint8_t hdr[4 + REC_FIXED_SIZE];
+    uint8_t* p = hdr;
+    put_u32(p, (uint32_t)len);
+    p += 4;
+    *p++ = rec->op;
+    *p++ = rec->ok ? REC_FLAG_OK : 0;
+    *p++ = rec->sb_status;
+    *p++ = (uint8_t)type_len;
+    pthread_mutex_lock(&g_trace.lock);
+    if (!g_trace.fp) {
+        pthread_mutex_unlock(&g_trace.lock);
+        return false;
+    }
+    // Calls started before the trace was (re)opened count from its start
+    put_u64(p, rec->start_ns > g_trace.t0 ? rec->start_ns - g_trace.t0 : 0);
+    p += 8;
+    put_u64(p, rec->total_ns);
+    p += 8;
+    for (int i = 0; i < BCML_TRACE_STAGE_COUNT; ++i, p += 4)
+        put_u32(p, rec->stage_ns[i]);
+    put_u32(p, rec->arg);
+    put_u32(p + 4, (uint32_t)rec->payload_len);
+    put_u32(p + 8, (uint32_t)rec->sb_len);
+
+    bool ok = fwrite(hdr, sizeof(hdr), 1, g_trace.fp) == 1 &&
+              fwrite(rec->type, 1, type_len, g_trace.fp) == type_len &&
+              (!rec->payload_len || fwrite(rec->payload, rec->payload_len, 1, g_trace.fp) == 1) &&
+              (!rec->sb_len || fwrite(rec->sb, rec->sb_len, 1, g_trace.fp) == 1);
+    if (ok)
+        ++g_trace.records;
+    pthread_mutex_unlock(&g_trace.lock);
+    if (!ok)
+        BCML_LOG_ERROR("bcml_trace_append: write failed\n");
+    return ok;
+}
+
+// ---- Reading ----
+
+struct bcml_trace_reader {
+    FILE* fp;
+    uint64_t started;
+    uint8_t* buf;
+    size_t cap;
+};
+
+bcml_trace_reader_t* bcml_trace_reader_open(const char* path) {
+    FILE* fp = path ? fopen(path, "rbe") : NULL;
+    if (!fp) {
+        BCML_LOG_ERROR("bcml_trace_reader_open: cannot open %s\n", path ? path : "(null)");
+        return NULL;
+    }
+    uint8_t hdr[TRACE_HDR_SIZE];
+    if (fread(hdr, sizeof(hdr), 1, fp) != 1 || get_u32(hdr) != TRACE_MAGIC ||
+        get_u16(hdr + 4) != TRACE_VERSION) {
+        BCML_LOG_ERROR("bcml_trace_reader_open: %s is not a version %d trace\n", path, TRACE_VERSION);
+        fclose(fp);
+        return NULL;
+    }
+    bcml_trace_reader_t* reader = calloc(1, sizeof(*reader));
+    if (!reader) {
+        fclose(fp);
+        return NULL;
+    }
+    reader->fp = fp;
+    reader->started = get_u64(hdr + 8);
+    return reader;
+}
+
+bool bcml_trace_reader_next(bcml_trace_reader_t* reader, bcml_trace_rec_t* rec) {
+    uint8_t len_buf[4];
+    if (fread(len_buf, sizeof(len_buf), 1, reader->fp) != 1)
+        return false;
+    uint32_t len = get_u32(len_buf);
+    if (len < REC_FIXED_SIZE || len > REC_MAX_LEN) {
+        BCML_LOG_WARN("bcml_trace_reader_next: malformed record length %u\n", len);
+        return false;
+    }
+    if (len > reader->cap) {
+        uint8_t* buf = realloc(reader->buf, len);
+        if (!buf)
+            return false;
+        reader->buf = buf;
+        reader->cap = len;
+    }
+    if (fread(reader->buf, len, 1, reader->fp) != 1) {
+        BCML_LOG_WARN("bcml_trace_reader_next: truncated record\n");
+        return false;
+    }
+
+    const uint8_t* p = reader->buf;
+    memset(rec, 0, sizeof(*rec));
+    rec->op = p[0];
+    rec->ok = p[1] & REC_FLAG_OK;
+    rec->sb_status = p[2];
+    size_t type_len = p[3];
+    p += 4;
+    rec->start_ns = get_u64(p);
+    rec->total_ns = get_u64(p + 8);
+    p += 16;
+    for (int i = 0; i < BCML_TRACE_STAGE_COUNT; ++i, p += 4)
+        rec->stage_ns[i] = get_u32(p);
+    rec->arg = get_u32(p);
+    rec->payload_len = get_u32(p + 4);
+    rec->sb_len = get_u32(p + 8);
+    p += 12;
+    if (type_len > BCML_TRACE_TYPE_MAX ||
+        (uint64_t)REC_FIXED_SIZE + type_len + rec->payload_len + rec->sb_len != len) {
+        BCML_LOG_WARN("bcml_trace_reader_next: malformed record\n");
+        return false;
+    }
+    memcpy(rec->type, p, type_len);
+    rec->type[type_len] = '\0';
+    p += type_len;
+    rec->payload = p;
+    rec->sb = p + rec->payload_len;
+    return true;
+}
+
+uint64_t bcml_trace_reader_started(const bcml_trace_reader_t* reader) {
+    return reader->started;
+}
+
+void bcml_trace_reader_close(bcml_trace_reader_t* reader) {
+    if (!reader)
+        return;
+    fclose(reader->fp);
+    free(reader->buf);
+    free(reader);
+}
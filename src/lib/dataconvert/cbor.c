@@ -0,0 +1,171 @@
+#include "cbor.h"
+#include <string.h>
+
+// A write that does not fit pushes len past size for good, so later writes are dropped too
+static void put_bytes(cbor_writer_t* w, const void* data, size_t len) {
+    if (w->len <= w->size && len <= w->size - w->len)
+        memcpy(w->buf + w->len, data, len);
+    w->len += len;
+}
+
+// Shortest head for the argument
+static void put_head(cbor_writer_t* w, cbor_major_t major, uint64_t arg) {
+    uint8_t head[9];
+    size_t n;
+    uint8_t mt = (uint8_t)(major << 5);
+    if (arg < 24) {
+        head[0] = mt | (uint8_t)arg;
+        n = 1;
+    } else if (arg <= UINT8_MAX) {
+        head[0] = mt | 24;
+        n = 2;
+    } else if (arg <= UINT16_MAX) {
+        head[0] = mt | 25;
+        n = 3;
+    } else if (arg <= UINT32_MAX) {
+        head[0] = mt | 26;
+        n = 5;
+    } else {
+        head[0] = mt | 27;
+        n = 9;
+    }
+    // Argument in big-endian order after the initial byte
+    for (size_t i = n - 1; i > 0; --i, arg >>= 8)
+        head[i] = (uint8_t)arg;
+    put_bytes(w, head, n);
+}
+
+void cbor_put_int(cbor_writer_t* w, int64_t v) {
+    if (v >= 0)
+        put_head(w, CBOR_UINT, (uint64_t)v);
+    else
+        put_head(w, CBOR_NINT, (uint64_t)(-1 - v));
+}
+
+void cbor_put_bool(cbor_writer_t* w, bool v) {
+    uint8_t b = (uint8_t)((CBOR_SIMPLE << 5) | (v ? 21 : 20));
+    put_bytes(w, &b, 1);
+}
+
+void cbor_put_text(cbor_writer_t* w, const char* s, size_t len) {
+    put_head(w, CBOR_TEXT, len);
+    put_bytes(w, s, len);
+}
+
+void cbor_put_array(cbor_writer_t* w, size_t count) {
+    put_head(w, CBOR_ARRAY, count);
+}
+
+void cbor_put_map(cbor_writer_t* w, size_t pairs) {
+    put_head(w, CBOR_MAP, pairs);
+}
+
+// Head of the next item if it has the given major type; no indefinite lengths
+static bool get_head(cbor_reader_t* r, cbor_major_t major, uint64_t* arg) {
+    if (r->p >= r->end || (*r->p >> 5) != major)
+        return false;
+    uint8_t info = *r->p++ & 0x1f;
+    if (info < 24) {
+        *arg = info;
+        return true;
+    }
+    if (info > 27)
+        return false;
+    size_t n = (size_t)1 << (info - 24);
+    if ((size_t)(r->end - r->p) < n)
+        return false;
+    uint64_t v = 0;
+    for (size_t i = 0; i < n; ++i)
+        v = (v << 8) | *r->p++;
+    *arg = v;
+    return true;
+}
+
+bool cbor_get_int(cbor_reader_t* r, int64_t* v) {
+    uint64_t arg;
+    if (cbor_peek(r) == CBOR_UINT) {
+        if (!get_head(r, CBOR_UINT, &arg) || arg > (uint64_t)INT64_MAX)
+            return false;
+        *v = (int64_t)arg;
+        return true;
+    }
+    if (!get_head(r, CBOR_NINT, &arg) || arg > (uint64_t)INT64_MAX)
+        return false;
+    *v = -1 - (int64_t)arg;
+    return true;
+}
+
+bool cbor_get_bool(cbor_reader_t* r, bool* v) {
+    if (r->p >= r->end)
+        return false;
+    uint8_t b = *r->p;
+    if (b != ((CBOR_SIMPLE << 5) | 20) && b != ((CBOR_SIMPLE << 5) | 21))
+        return false;
+    *v = (b & 0x1f) == 21;
+    ++r->p;
+    return true;
+}
+
+bool cbor_get_text(cbor_reader_t* r, const char** s, size_t* len) {
+    uint64_t arg;
+    if (!get_head(r, CBOR_TEXT, &arg) || arg > (uint64_t)(r->end - r->p))
+        return false;
+    if (!cbor_utf8_valid((const char*)r->p, (size_t)arg))
+        return false;
+    *s = (const char*)r->p;
+    *len = (size_t)arg;
+    r->p += arg;
+    return true;
+}
+
+bool cbor_get_array(cbor_reader_t* r, size_t* count) {
+    uint64_t arg;
+    // Every element takes at least one byte
+    if (!get_head(r, CBOR_ARRAY, &arg) || arg > (uint64_t)(r->end - r->p))
+        return false;
+    *count = (size_t)arg;
+    return true;
+}
+
+bool cbor_get_map(cbor_reader_t* r, size_t* pairs) {
+    uint64_t arg;
+    if (!get_head(r, CBOR_MAP, &arg) || arg > (uint64_t)(r->end - r->p) / 2)
+        return false;
+    *pairs = (size_t)arg;
+    return true;
+}
+
+bool cbor_utf8_valid(const char* s, size_t len) {
+    const unsigned char* p = (const unsigned char*)s;
+    const unsigned char* end = p + len;
+    while (p < end) {
+        unsigned char c = *p++;
+        if (c < 0x80)
+            continue;
+        size_t n;
+        uint32_t cp;
+        if (c >= 0xc2 && c <= 0xdf) {
+            n = 1;
+            cp = c & 0x1f;
+        } else if (c >= 0xe0 && c <= 0xef) {
+            n = 2;
+            cp = c & 0x0f;
+        } else if (c >= 0xf0 && c <= 0xf4) {
+            n = 3;
+            cp = c & 0x07;
+        } else {
+            return false;
+        }
+        if ((size_t)(end - p) < n)
+            return false;
+        for (size_t i = 0; i < n; ++i) {
+            if ((p[i] & 0xc0) != 0x80)
+                return false;
+            cp = (cp << 6) | (p[i] & 0x3f);
+        }
+        p += n;
+        if ((n == 2 && cp < 0x800) || (n == 3 && cp < 0x10000) || cp > 0x10ffff || (cp >= 0xd800 && cp <= 0xdfff))
+            return false;
+    }
+    return true;
+}
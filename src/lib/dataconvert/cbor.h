@@ -0,0 +1,84 @@
+#ifndef CBOR_H
+#define CBOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Minimal CBOR (RFC 8949) writer and reader, for the binary northbound form of
+// the data models (bcml_config_set_bin/get_bin).
+//
+// Only what a data model document needs: integers, text strings, arrays, maps
+// and true/false, all of definite length. The writer always emits the shortest
+// head. The reader accepts any head width but rejects indefinite lengths, tags,
+// floats, byte strings, other simple values and text that is not valid UTF-8.
+
+typedef enum {
+    CBOR_UINT = 0,
+    CBOR_NINT = 1,
+    CBOR_BYTES = 2,
+    CBOR_TEXT = 3,
+    CBOR_ARRAY = 4,
+    CBOR_MAP = 5,
+    CBOR_TAG = 6,
+    CBOR_SIMPLE = 7
+} cbor_major_t;
+
+// Writes into a caller buffer. Once something does not fit nothing more is
+// written, but len keeps counting, so it ends up as the size needed.
+typedef struct {
+    uint8_t* buf;
+    size_t size;
+    size_t len;
+} cbor_writer_t;
+
+static inline void cbor_writer_init(cbor_writer_t* w, uint8_t* buf, size_t size) {
+    w->buf = buf;
+    w->size = size;
+    w->len = 0;
+}
+
+// true if everything written so far fits the buffer
+static inline bool cbor_writer_ok(const cbor_writer_t* w) {
+    return w->len <= w->size;
+}
+
+void cbor_put_int(cbor_writer_t* w, int64_t v);
+void cbor_put_bool(cbor_writer_t* w, bool v);
+void cbor_put_text(cbor_writer_t* w, const char* s, size_t len);
+void cbor_put_array(cbor_writer_t* w, size_t count);
+void cbor_put_map(cbor_writer_t* w, size_t pairs);
+
+typedef struct {
+    const uint8_t* p;
+    const uint8_t* end;
+} cbor_reader_t;
+
+static inline void cbor_reader_init(cbor_reader_t* r, const void* data, size_t len) {
+    r->p = (const uint8_t*)data;
+    r->end = r->p + len;
+}
+
+static inline bool cbor_at_end(const cbor_reader_t* r) {
+    return r->p == r->end;
+}
+
+// Major type of the next item, -1 at the end of the input
+static inline int cbor_peek(const cbor_reader_t* r) {
+    return r->p < r->end ? *r->p >> 5 : -1;
+}
+
+// Each returns false, without a guarantee on how far it advanced, if the next
+// item is malformed or of another type.
+bool cbor_get_int(cbor_reader_t* r, int64_t* v);
+bool cbor_get_bool(cbor_reader_t* r, bool* v);
+// *s points into the input and is not NUL terminated
+bool cbor_get_text(cbor_reader_t* r, const char** s, size_t* len);
+// Counts are checked against the bytes left, so they are safe to loop on
+bool cbor_get_array(cbor_reader_t* r, size_t* count);
+bool cbor_get_map(cbor_reader_t* r, size_t* pairs);
+
+// RFC 3629 UTF-8 (no overlong forms, surrogates or code points past U+10FFFF)
+bool cbor_utf8_valid(const char* s, size_t len);
+
+#endif // CBOR_H
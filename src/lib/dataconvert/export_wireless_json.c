@@ -1,62 +1,173 @@
 #include "export_wireless_json.h"
+#include "wireless_codec.h"
 #include "bcml_types.h"
 #include "bcml_log.h"
+#include "bcml_probe.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
 #include <cjson/cJSON.h>
 
+// Serialized form of one radio or SSID, valid for the item copy it was made from
+typedef struct {
+    char* json;
+    size_t len;
+    bool valid;
+} export_frag_t;
+
+// Fragments by position. Polling consumers export nearly the same config over
+// and over, so only the items that differ from the last export of the same
+// thread are serialized again; the rest is spliced in from here.
+typedef struct {
+    bcml_wireless_radio_t radio[BCML_RADIO_LIMIT];
+    bcml_wireless_ssid_t ssid[BCML_SSID_LIMIT];
+    export_frag_t radio_frag[BCML_RADIO_LIMIT];
+    export_frag_t ssid_frag[BCML_SSID_LIMIT];
+} export_frag_cache_t;
+
+static __thread export_frag_cache_t* t_frag_cache;
+// Frees the cache of exiting threads
+static pthread_key_t g_frag_cache_key;
+static bool g_frag_cache_key_ok;
+static pthread_once_t g_frag_cache_once = PTHREAD_ONCE_INIT;
+
+static const char k_json_head[] = "{\"wireless\":{\"radio\":[";
+static const char k_json_mid[] = "],\"ssid\":[";
+static const char k_json_tail[] = "]}}";
+
+static void frag_cache_free(void* p) {
+    export_frag_cache_t* cache = (export_frag_cache_t*)p;
+    if (!cache)
+        return;
+    for (int i = 0; i < BCML_RADIO_LIMIT; ++i)
+        free(cache->radio_frag[i].json);
+    for (int i = 0; i < BCML_SSID_LIMIT; ++i)
+        free(cache->ssid_frag[i].json);
+    free(cache);
+}
+
+static void frag_cache_key_create(void) {
+    g_frag_cache_key_ok = (pthread_key_create(&g_frag_cache_key, frag_cache_free) == 0);
+}
+
+static export_frag_cache_t* frag_cache_get(void) {
+    if (t_frag_cache)
+        return t_frag_cache;
+    pthread_once(&g_frag_cache_once, frag_cache_key_create);
+    export_frag_cache_t* cache = calloc(1, sizeof(*cache));
+    if (!cache)
+        return NULL;
+    if (g_frag_cache_key_ok)
+        pthread_setspecific(g_frag_cache_key, cache);
+    t_frag_cache = cache;
+    return cache;
+}
+
+void export_wireless_json_release(void) {
+    if (!t_frag_cache)
+        return;
+    if (g_frag_cache_key_ok)
+        pthread_setspecific(g_frag_cache_key, NULL);
+    frag_cache_free(t_frag_cache);
+    t_frag_cache = NULL;
+}
+
 /**
- * @brief Serialize a radio config structure to a cJSON object.
- * @param radio_cfg Pointer to the radio config structure.
- * @return cJSON object pointer or NULL if input is invalid.
+ * @brief Bring the fragment of one item up to date.
+ * @param cached Copy of the item the fragment was made from, updated with it.
+ * @param dirty  Incremented when the item had to be serialized.
+ * @return false on allocation failure (fragment invalid).
  */
-static cJSON* export_radio_json(const bcml_wireless_radio_t* radio_cfg) {
-    if (!radio_cfg) {
-        BCML_LOG_WARN("export_radio_json: radio_cfg is NULL");
-        return NULL;
-    }
-    BCML_LOG_DEBUG("export_radio_json: serializing radio at %p", radio_cfg);
-    cJSON* obj = cJSON_CreateObject();
-    cJSON_AddNumberToObject(obj, "power", radio_cfg->power);
-    cJSON_AddNumberToObject(obj, "channel2g", radio_cfg->channel2g);
-    cJSON_AddNumberToObject(obj, "channel5g", radio_cfg->channel5g);
-    cJSON_AddNumberToObject(obj, "bandwidth2g", radio_cfg->bandwidth2g);
-    cJSON_AddNumberToObject(obj, "bandwidth5g", radio_cfg->bandwidth5g);
-    cJSON_AddBoolToObject(obj, "dfs", radio_cfg->dfs);
-    cJSON_AddBoolToObject(obj, "atf", radio_cfg->atf);
-    cJSON_AddBoolToObject(obj, "bandsteering", radio_cfg->bandsteering);
-    cJSON_AddBoolToObject(obj, "zerowait", radio_cfg->zerowait);
-    return obj;
+static bool frag_update(export_frag_t* frag, void* cached, const void* item, unsigned section, int* dirty) {
+    if (frag->valid && wireless_item_equal(section, cached, item))
+        return true;
+
+    frag->valid = false;
+    free(frag->json);
+    frag->json = NULL;
+    cJSON* obj = (section == WIRELESS_SECTION_RADIO)
+        ? wireless_radio_to_json((const bcml_wireless_radio_t*)item, WIRELESS_KEYS_NB)
+        : wireless_ssid_to_json((const bcml_wireless_ssid_t*)item, WIRELESS_KEYS_NB);
+    if (!obj)
+        return false;
+    frag->json = cJSON_PrintUnformatted(obj);
+    cJSON_Delete(obj);
+    if (!frag->json)
+        return false;
+    frag->len = strlen(frag->json);
+    frag->valid = true;
+    memcpy(cached, item, section == WIRELESS_SECTION_RADIO ? sizeof(bcml_wireless_radio_t) : sizeof(bcml_wireless_ssid_t));
+    ++*dirty;
+    return true;
+}
+
+static char* put(char* p, const char* s, size_t len) {
+    memcpy(p, s, len);
+    return p + len;
 }
 
 /**
- * @brief Serialize an ssid config structure to a cJSON object.
- * @param ssid_cfg Pointer to the ssid config structure.
- * @return cJSON object pointer or NULL if input is invalid.
+ * @brief Export from the per-thread fragment cache.
+ * @param json_len Set to the length of the JSON (written only if it fits buffer_size).
+ * @return false if the cache is unusable for this config; json_len is then 0.
  */
-static cJSON* export_ssid_json(const bcml_wireless_ssid_t* ssid_cfg) {
-    if (!ssid_cfg) {
-        BCML_LOG_WARN("export_ssid_json: ssid_cfg is NULL\n");
-        return NULL;
+static bool export_cached(const bcml_wireless_cfg_t* cfg, char* json_buffer, size_t buffer_size, size_t* json_len) {
+    *json_len = 0;
+    if (cfg->radio_count > BCML_RADIO_LIMIT || cfg->ssid_count > BCML_SSID_LIMIT)
+        return false;
+    export_frag_cache_t* cache = frag_cache_get();
+    if (!cache)
+        return false;
+
+    int dirty = 0;
+    int radio_count = cfg->radio_count > 0 ? cfg->radio_count : 0;
+    int ssid_count = cfg->ssid_count > 0 ? cfg->ssid_count : 0;
+    size_t len = sizeof(k_json_head) - 1 + sizeof(k_json_mid) - 1 + sizeof(k_json_tail) - 1;
+    size_t items = 0;
+    for (int i = 0; i < radio_count; ++i) {
+        if (!frag_update(&cache->radio_frag[i], &cache->radio[i], &cfg->radio[i], WIRELESS_SECTION_RADIO, &dirty))
+            return false;
+        len += cache->radio_frag[i].len + (items++ ? 1 : 0);
+    }
+    items = 0;
+    for (int i = 0; i < ssid_count; ++i) {
+        /* Only non-empty ssid entries are exported */
+        if (cfg->ssid[i].ssid[0] == '\0')
+            continue;
+        if (!frag_update(&cache->ssid_frag[i], &cache->ssid[i], &cfg->ssid[i], WIRELESS_SECTION_SSID, &dirty))
+            return false;
+        len += cache->ssid_frag[i].len + (items++ ? 1 : 0);
+    }
+    BCML_LOG_DEBUG("export_wireless_json: %d of %d items serialized, length=%zu\n", dirty, radio_count + ssid_count, len);
+
+    *json_len = len;
+    if (len >= buffer_size)
+        return true;
+
+    char* p = put(json_buffer, k_json_head, sizeof(k_json_head) - 1);
+    for (int i = 0; i < radio_count; ++i) {
+        if (i)
+            *p++ = ',';
+        p = put(p, cache->radio_frag[i].json, cache->radio_frag[i].len);
+    }
+    p = put(p, k_json_mid, sizeof(k_json_mid) - 1);
+    items = 0;
+    for (int i = 0; i < ssid_count; ++i) {
+        if (cfg->ssid[i].ssid[0] == '\0')
+            continue;
+        if (items++)
+            *p++ = ',';
+        p = put(p, cache->ssid_frag[i].json, cache->ssid_frag[i].len);
     }
-    BCML_LOG_DEBUG("export_ssid_json: serializing ssid at %p (ssid: %s)\n", ssid_cfg, ssid_cfg->ssid);
-    cJSON* obj = cJSON_CreateObject();
-    cJSON_AddStringToObject(obj, "ssid", ssid_cfg->ssid);
-    cJSON_AddBoolToObject(obj, "hide", ssid_cfg->hide);
-    cJSON_AddNumberToObject(obj, "security", ssid_cfg->security);
-    cJSON_AddStringToObject(obj, "password", ssid_cfg->password);
-    cJSON_AddBoolToObject(obj, "password_onscreen", ssid_cfg->password_onscreen);
-    cJSON_AddBoolToObject(obj, "enable2g", ssid_cfg->enable2g);
-    cJSON_AddBoolToObject(obj, "enable5g", ssid_cfg->enable5g);
-    cJSON_AddBoolToObject(obj, "isolation", ssid_cfg->isolation);
-    cJSON_AddBoolToObject(obj, "hopping", ssid_cfg->hopping);
-    return obj;
+    p = put(p, k_json_tail, sizeof(k_json_tail));
+    return true;
 }
 
 /**
  * @brief Export wireless config to JSON string.
  *        Only non-empty ssid entries will be exported (to support multiple SSID).
+ *        Items unchanged since the calling thread's last export are not serialized again.
  * @param sdata Pointer to wireless config.
  * @param json_buffer Output buffer for JSON string.
  * @param buffer_size Size of output buffer.
@@ -71,41 +182,41 @@ bool export_wireless_json(const void* sdata, char* json_buffer, size_t buffer_si
     }
 
     const bcml_wireless_cfg_t* cfg = (const bcml_wireless_cfg_t*)sdata;
+    BCML_PROBE1(export__start, "wireless");
+
+    size_t json_len = 0;
+    if (!export_cached(cfg, json_buffer, buffer_size, &json_len)) {
+        BCML_LOG_WARN("export_wireless_json: fragment cache unusable, exporting in full\n");
+        bool ok = export_wireless_json_full(sdata, json_buffer, buffer_size);
+        BCML_PROBE3(export__done, "wireless", ok ? strlen(json_buffer) : (size_t)0, ok);
+        return ok;
+    }
+
+    bool ok = (json_len < buffer_size);
+    if (ok) {
+        BCML_LOG_INFO("export_wireless_json: JSON exported successfully (length=%zu)\n", json_len);
+    } else {
+        json_buffer[0] = '\0';
+        BCML_LOG_ERROR("export_wireless_json: Buffer too small (required=%zu, given=%zu)\n", json_len + 1, buffer_size);
+    }
+    BCML_PROBE3(export__done, "wireless", ok ? json_len : 0, ok);
+    return ok;
+}
 
-    cJSON* wireless_obj = cJSON_CreateObject();
-
-    /* Serialize radio array */
-    cJSON* radio_array = cJSON_CreateArray();
-    for (int i = 0; i < MAX_RADIO_NUM; ++i) {
-        // Export all radios (assuming all are valid, if not, add additional check here)
-        BCML_LOG_DEBUG("export_wireless_json: serializing radio[%d]\n", i);
-        cJSON* radio_obj = export_radio_json(&cfg->radio[i]);
-        if (radio_obj) {
-            cJSON_AddItemToArray(radio_array, radio_obj);
-        } else {
-            BCML_LOG_WARN("export_wireless_json: radio_obj is NULL for radio[%d]\n", i);
-        }
+bool export_wireless_json_full(const void* sdata, char* json_buffer, size_t buffer_size) {
+    if (!sdata || !json_buffer || buffer_size == 0) {
+        BCML_LOG_ERROR("export_wireless_json_full: Invalid input. sdata=%p, json_buffer=%p, buffer_size=%zu\n", sdata, json_buffer, buffer_size);
+        return false;
     }
-    cJSON_AddItemToObject(wireless_obj, "radio", radio_array);
-
-    /* Serialize ssid array: only add ssid with non-empty string */
-    cJSON* ssid_array = cJSON_CreateArray();
-    int ssid_count = 0;
-    for (int i = 0; i < MAX_SSID_NUM; ++i) {
-        if (cfg->ssid[i].ssid[0] != '\0') {
-            BCML_LOG_DEBUG("export_wireless_json: serializing ssid[%d] (ssid: %s)\n", i, cfg->ssid[i].ssid);
-            cJSON* ssid_obj = export_ssid_json(&cfg->ssid[i]);
-            if (ssid_obj) {
-                cJSON_AddItemToArray(ssid_array, ssid_obj);
-                ssid_count++;
-            } else {
-                BCML_LOG_WARN("export_wireless_json: ssid_obj is NULL for ssid[%d]\n", i);
-            }
-        } else {
-            BCML_LOG_DEBUG("export_wireless_json: skip empty ssid[%d]\n", i);
-        }
+
+    const bcml_wireless_cfg_t* cfg = (const bcml_wireless_cfg_t*)sdata;
+
+    /* Serialize radio array and non-empty ssid entries */
+    cJSON* wireless_obj = wireless_cfg_to_json(cfg, WIRELESS_SECTION_ALL, WIRELESS_KEYS_NB);
+    if (!wireless_obj) {
+        BCML_LOG_ERROR("export_wireless_json: wireless_cfg_to_json failed\n");
+        return false;
     }
-    cJSON_AddItemToObject(wireless_obj, "ssid", ssid_array);
 
     /* Create root and add "wireless" object */
     cJSON* root = cJSON_CreateObject();
@@ -119,17 +230,18 @@ bool export_wireless_json(const void* sdata, char* json_buffer, size_t buffer_si
         return false;
     }
 
-    BCML_LOG_DEBUG("export_wireless_json: generated JSON string length=%zu\n", strlen(json_str));
-    bool ok = (strlen(json_str) < buffer_size);
+    size_t json_len = strlen(json_str);
+    BCML_LOG_DEBUG("export_wireless_json: generated JSON string length=%zu\n", json_len);
+    bool ok = (json_len < buffer_size);
     if (ok) {
-        strcpy(json_buffer, json_str);
-        BCML_LOG_INFO("export_wireless_json: JSON exported successfully (length=%zu)\n", strlen(json_str));
+        memcpy(json_buffer, json_str, json_len + 1);
+        BCML_LOG_INFO("export_wireless_json: JSON exported successfully (length=%zu)\n", json_len);
     } else {
         json_buffer[0] = '\0';
-        BCML_LOG_ERROR("export_wireless_json: Buffer too small (required=%zu, given=%zu)\n", strlen(json_str) + 1, buffer_size);
+        BCML_LOG_ERROR("export_wireless_json: Buffer too small (required=%zu, given=%zu)\n", json_len + 1, buffer_size);
     }
 
     free(json_str);
     cJSON_Delete(root);
     return ok;
-}
\ No newline at end of file
+}
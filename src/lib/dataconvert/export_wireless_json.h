@@ -9,6 +9,14 @@
 // sdata: pointer to bcml_wireless_cfg_t
 // json_buffer: output buffer to store the JSON string
 // buffer_size: size of the output buffer
+// Each thread keeps the serialized radios/SSIDs of its last export, so only the
+// items that changed since are serialized again.
 bool export_wireless_json(const void* sdata, char* json_buffer, size_t buffer_size);
 
-#endif // EXPORT_WIRELESS_JSON_H
\ No newline at end of file
+// Same output, serialized from scratch through cJSON (no cache)
+bool export_wireless_json_full(const void* sdata, char* json_buffer, size_t buffer_size);
+
+// Free the calling thread's fragment cache (other threads' are freed when they exit)
+void export_wireless_json_release(void);
+
+#endif // EXPORT_WIRELESS_JSON_H
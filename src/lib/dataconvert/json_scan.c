@@ -0,0 +1,609 @@
+#include "json_scan.h"
+#include <stdlib.h>
+#include <string.h>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define JSON_SCAN_X86 1
+#include <immintrin.h>
+#endif
+
+// Per-64-byte-block character classes, bit i = byte i of the block
+typedef struct {
+    uint64_t quote;      // '"'
+    uint64_t backslash;  // '\\'
+    uint64_t op;         // { } [ ] : ,
+    uint64_t ws;         // space, \t, \n, \r
+    uint64_t ctrl;       // < 0x20
+    uint64_t nonascii;   // >= 0x80
+} scan_block_t;
+
+typedef void (*scan_classify_fn)(const unsigned char* p, scan_block_t* b);
+
+// ---- Classification: scalar ----
+
+static void classify_scalar(const unsigned char* p, scan_block_t* b) {
+    memset(b, 0, sizeof(*b));
+    for (int i = 0; i < 64; ++i) {
+        uint64_t bit = 1ULL << i;
+        unsigned char c = p[i];
+        switch (c) {
+            case '"':  b->quote |= bit; break;
+            case '\\': b->backslash |= bit; break;
+            case '{': case '}': case '[': case ']': case ':': case ',':
+                b->op |= bit;
+                break;
+            case ' ': case '\t': case '\n': case '\r':
+                b->ws |= bit;
+                break;
+            default:
+                break;
+        }
+        if (c < 0x20)
+            b->ctrl |= bit;
+        if (c >= 0x80)
+            b->nonascii |= bit;
+    }
+}
+
+#ifdef JSON_SCAN_X86
+
+// ---- Classification: SSE2, 4 x 16 bytes ----
+
+#define SSE2_EQ(v, ch) _mm_cmpeq_epi8((v), _mm_set1_epi8(ch))
+
+static void classify_sse2(const unsigned char* p, scan_block_t* b) {
+    memset(b, 0, sizeof(*b));
+    const __m128i ctrl_max = _mm_set1_epi8(0x1f);
+    for (int k = 0; k < 4; ++k) {
+        __m128i v = _mm_loadu_si128((const __m128i*)(p + 16 * k));
+        __m128i op = _mm_or_si128(_mm_or_si128(SSE2_EQ(v, '{'), SSE2_EQ(v, '}')),
+                                  _mm_or_si128(SSE2_EQ(v, '['), SSE2_EQ(v, ']')));
+        op = _mm_or_si128(op, _mm_or_si128(SSE2_EQ(v, ':'), SSE2_EQ(v, ',')));
+        __m128i ws = _mm_or_si128(_mm_or_si128(SSE2_EQ(v, ' '), SSE2_EQ(v, '\t')),
+                                  _mm_or_si128(SSE2_EQ(v, '\n'), SSE2_EQ(v, '\r')));
+        // Unsigned v <= 0x1f  <=>  max(v, 0x1f) == 0x1f
+        __m128i ctrl = _mm_cmpeq_epi8(_mm_max_epu8(v, ctrl_max), ctrl_max);
+        int shift = 16 * k;
+        b->quote     |= (uint64_t)(uint16_t)_mm_movemask_epi8(SSE2_EQ(v, '"')) << shift;
+        b->backslash |= (uint64_t)(uint16_t)_mm_movemask_epi8(SSE2_EQ(v, '\\')) << shift;
+        b->op        |= (uint64_t)(uint16_t)_mm_movemask_epi8(op) << shift;
+        b->ws        |= (uint64_t)(uint16_t)_mm_movemask_epi8(ws) << shift;
+        b->ctrl      |= (uint64_t)(uint16_t)_mm_movemask_epi8(ctrl) << shift;
+        b->nonascii  |= (uint64_t)(uint16_t)_mm_movemask_epi8(v) << shift;
+    }
+}
+
+// ---- Classification: AVX2, 2 x 32 bytes ----
+
+#define AVX2_EQ(v, ch) _mm256_cmpeq_epi8((v), _mm256_set1_epi8(ch))
+
+__attribute__((target("avx2")))
+static void classify_avx2(const unsigned char* p, scan_block_t* b) {
+    memset(b, 0, sizeof(*b));
+    const __m256i ctrl_max = _mm256_set1_epi8(0x1f);
+    for (int k = 0; k < 2; ++k) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(p + 32 * k));
+        __m256i op = _mm256_or_si256(_mm256_or_si256(AVX2_EQ(v, '{'), AVX2_EQ(v, '}')),
+                                     _mm256_or_si256(AVX2_EQ(v, '['), AVX2_EQ(v, ']')));
+        op = _mm256_or_si256(op, _mm256_or_si256(AVX2_EQ(v, ':'), AVX2_EQ(v, ',')));
+        __m256i ws = _mm256_or_si256(_mm256_or_si256(AVX2_EQ(v, ' '), AVX2_EQ(v, '\t')),
+                                     _mm256_or_si256(AVX2_EQ(v, '\n'), AVX2_EQ(v, '\r')));
+        __m256i ctrl = _mm256_cmpeq_epi8(_mm256_max_epu8(v, ctrl_max), ctrl_max);
+        int shift = 32 * k;
+        b->quote     |= (uint64_t)(uint32_t)_mm256_movemask_epi8(AVX2_EQ(v, '"')) << shift;
+        b->backslash |= (uint64_t)(uint32_t)_mm256_movemask_epi8(AVX2_EQ(v, '\\')) << shift;
+        b->op        |= (uint64_t)(uint32_t)_mm256_movemask_epi8(op) << shift;
+        b->ws        |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ws) << shift;
+        b->ctrl      |= (uint64_t)(uint32_t)_mm256_movemask_epi8(ctrl) << shift;
+        b->nonascii  |= (uint64_t)(uint32_t)_mm256_movemask_epi8(v) << shift;
+    }
+}
+
+#endif // JSON_SCAN_X86
+
+json_scan_impl_t json_scan_best_impl(void) {
+#ifdef JSON_SCAN_X86
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return JSON_SCAN_AVX2;
+    if (__builtin_cpu_supports("sse2"))
+        return JSON_SCAN_SSE2;
+#endif
+    return JSON_SCAN_SCALAR;
+}
+
+const char* json_scan_impl_name(json_scan_impl_t impl) {
+    switch (impl) {
+        case JSON_SCAN_AUTO:   return "auto";
+        case JSON_SCAN_SCALAR: return "scalar";
+        case JSON_SCAN_SSE2:   return "sse2";
+        case JSON_SCAN_AVX2:   return "avx2";
+    }
+    return "unknown";
+}
+
+static scan_classify_fn classify_for(json_scan_impl_t impl) {
+    if (impl == JSON_SCAN_AUTO)
+        impl = json_scan_best_impl();
+#ifdef JSON_SCAN_X86
+    if (impl == JSON_SCAN_AVX2 && __builtin_cpu_supports("avx2"))
+        return classify_avx2;
+    if (impl == JSON_SCAN_SSE2 && __builtin_cpu_supports("sse2"))
+        return classify_sse2;
+#endif
+    return classify_scalar;
+}
+
+// ---- Shared mask arithmetic (identical for every classifier) ----
+
+// Bits of characters preceded by an unescaped backslash. *carry: the block ended
+// with a backslash that escapes the first byte of the next block.
+static uint64_t scan_escaped(uint64_t bs, uint64_t* carry) {
+    uint64_t escaped = 0;
+    if (*carry) {
+        escaped = 1;
+        bs &= ~1ULL;    // That byte is escaped, so it cannot start an escape itself
+        *carry = 0;
+    }
+    // Backslashes are rare in config documents, so walk them one by one
+    while (bs) {
+        int i = __builtin_ctzll(bs);
+        if (i == 63) {
+            *carry = 1;
+            break;
+        }
+        escaped |= 1ULL << (i + 1);
+        bs &= ~(3ULL << i);
+    }
+    return escaped;
+}
+
+// Bit i = XOR of bits 0..i
+static uint64_t prefix_xor(uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+// UTF-8 validation states: 0 accept, 1..3 continuation bytes left, 4..7 first
+// continuation byte restricted (E0, ED, F0, F4 lead bytes), 8 error
+#define UTF8_ACCEPT 0
+#define UTF8_REJECT 8
+
+static uint8_t utf8_step(uint8_t st, unsigned char c) {
+    bool cont = (c & 0xc0) == 0x80;
+    switch (st) {
+        case 0:
+            if (c < 0x80) return 0;
+            if (c < 0xc2) return UTF8_REJECT;
+            if (c < 0xe0) return 1;
+            if (c == 0xe0) return 4;
+            if (c == 0xed) return 5;
+            if (c < 0xf0) return 2;
+            if (c == 0xf0) return 6;
+            if (c < 0xf4) return 3;
+            if (c == 0xf4) return 7;
+            return UTF8_REJECT;
+        case 1: return cont ? 0 : UTF8_REJECT;
+        case 2: return cont ? 1 : UTF8_REJECT;
+        case 3: return cont ? 2 : UTF8_REJECT;
+        case 4: return (c >= 0xa0 && c <= 0xbf) ? 1 : UTF8_REJECT;
+        case 5: return (c >= 0x80 && c <= 0x9f) ? 1 : UTF8_REJECT;
+        case 6: return (c >= 0x90 && c <= 0xbf) ? 2 : UTF8_REJECT;
+        case 7: return (c >= 0x80 && c <= 0x8f) ? 2 : UTF8_REJECT;
+        default: return UTF8_REJECT;
+    }
+}
+
+void json_scan_init(json_scan_t* s) {
+    memset(s, 0, sizeof(*s));
+}
+
+void json_scan_free(json_scan_t* s) {
+    free(s->pos);
+    memset(s, 0, sizeof(*s));
+}
+
+static bool scan_reserve(json_scan_t* s, size_t extra) {
+    if (s->count + extra <= s->cap)
+        return true;
+    size_t cap = s->cap ? s->cap : 256;
+    while (cap < s->count + extra)
+        cap *= 2;
+    uint32_t* pos = realloc(s->pos, cap * sizeof(*pos));
+    if (!pos)
+        return false;
+    s->pos = pos;
+    s->cap = cap;
+    return true;
+}
+
+bool json_scan(json_scan_t* s, const char* buf, size_t len, json_scan_impl_t impl) {
+    s->buf = buf;
+    s->len = len;
+    s->count = 0;
+    if (!buf || len >= UINT32_MAX)
+        return false;
+
+    scan_classify_fn classify = classify_for(impl);
+    const unsigned char* p = (const unsigned char*)buf;
+    uint64_t escape_carry = 0;
+    uint64_t in_string_carry = 0;   // All ones if the previous block ended inside a string
+    uint64_t scalar_carry = 0;      // 1 if the previous block ended in a number/literal byte
+    uint8_t utf8 = UTF8_ACCEPT;
+
+    for (size_t base = 0; base < len; base += 64) {
+        size_t n = len - base;
+        const unsigned char* block = p + base;
+        unsigned char tail[64];
+        if (n < 64) {
+            // Pad with whitespace, which never creates a token
+            memset(tail, ' ', sizeof(tail));
+            memcpy(tail, block, n);
+            block = tail;
+        } else {
+            n = 64;
+        }
+
+        scan_block_t b;
+        classify(block, &b);
+
+        if (b.nonascii || utf8 != UTF8_ACCEPT) {
+            // Only the span from the first to the last non-ASCII byte (plus any
+            // sequence still open after it) needs the byte-wise check
+            size_t i = (utf8 == UTF8_ACCEPT) ? (size_t)__builtin_ctzll(b.nonascii) : 0;
+            size_t last = b.nonascii ? 64 - (size_t)__builtin_clzll(b.nonascii) : 0;
+            for (; i < n && (i < last || utf8 != UTF8_ACCEPT) && utf8 != UTF8_REJECT; ++i)
+                utf8 = utf8_step(utf8, block[i]);
+            if (utf8 == UTF8_REJECT)
+                return false;
+        }
+
+        uint64_t escaped = scan_escaped(b.backslash, &escape_carry);
+        uint64_t quote = b.quote & ~escaped;
+        // Inside-string mask: includes the opening quote, excludes the closing one
+        uint64_t in_string = prefix_xor(quote) ^ in_string_carry;
+        in_string_carry = (uint64_t)((int64_t)in_string >> 63);
+
+        if (b.ctrl & in_string)
+            return false;
+
+        uint64_t scalar = ~(b.op | b.ws | b.quote | in_string);
+        uint64_t structural = (b.op & ~in_string) |
+                              (quote & in_string) |
+                              (scalar & ~((scalar << 1) | scalar_carry));
+        scalar_carry = scalar >> 63;
+
+        if (!structural)
+            continue;
+        if (!scan_reserve(s, (size_t)__builtin_popcountll(structural)))
+            return false;
+        while (structural) {
+            s->pos[s->count++] = (uint32_t)(base + (size_t)__builtin_ctzll(structural));
+            structural &= structural - 1;
+        }
+    }
+
+    if (in_string_carry || utf8 != UTF8_ACCEPT)
+        return false;
+    return true;
+}
+
+// ---- Stage 2 ----
+
+// Offset one past the current token's last byte for numbers/literals
+static size_t scalar_end(const json_scan_t* s, size_t start) {
+    size_t e = start;
+    while (e < s->len) {
+        char ch = s->buf[e];
+        if (ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r' || ch == ',' ||
+            ch == '}' || ch == ']' || ch == ':' || ch == '{' || ch == '[' || ch == '"')
+            break;
+        ++e;
+    }
+    return e;
+}
+
+static int hex4(const char* p) {
+    int v = 0;
+    for (int i = 0; i < 4; ++i) {
+        char ch = p[i];
+        v <<= 4;
+        if (ch >= '0' && ch <= '9')      v |= ch - '0';
+        else if (ch >= 'a' && ch <= 'f') v |= ch - 'a' + 10;
+        else if (ch >= 'A' && ch <= 'F') v |= ch - 'A' + 10;
+        else return -1;
+    }
+    return v;
+}
+
+// Append decoded bytes until the first NUL; later bytes are validated but dropped
+static void str_put(char* dst, size_t dst_size, size_t* n, bool* nul, const char* bytes, size_t count) {
+    for (size_t k = 0; k < count && !*nul; ++k) {
+        if (bytes[k] == '\0') {
+            *nul = true;
+            break;
+        }
+        if (dst && *n + 1 < dst_size)
+            dst[*n] = bytes[k];
+        ++*n;
+    }
+}
+
+bool json_cur_string(json_cur_t* c, char* dst, size_t dst_size, size_t* len) {
+    if (dst && dst_size)
+        dst[0] = '\0';
+    if (json_cur_peek(c) != '"')
+        return false;
+
+    const json_scan_t* s = c->s;
+    size_t i = (size_t)s->pos[c->i] + 1;
+    size_t n = 0;
+    bool nul = false;
+
+    // Stage 1 guarantees a closing quote and no raw control characters
+    while (s->buf[i] != '"') {
+        const char* run = s->buf + i;
+        size_t run_len = 0;
+        while (run[run_len] != '"' && run[run_len] != '\\')
+            ++run_len;
+        str_put(dst, dst_size, &n, &nul, run, run_len);
+        i += run_len;
+        if (s->buf[i] != '\\')
+            continue;
+
+        char esc = s->buf[i + 1];
+        char out[4];
+        size_t out_len = 1;
+        i += 2;
+        switch (esc) {
+            case '"': out[0] = '"'; break;
+            case '\\': out[0] = '\\'; break;
+            case '/': out[0] = '/'; break;
+            case 'b': out[0] = '\b'; break;
+            case 'f': out[0] = '\f'; break;
+            case 'n': out[0] = '\n'; break;
+            case 'r': out[0] = '\r'; break;
+            case 't': out[0] = '\t'; break;
+            case 'u': {
+                if (i + 4 > s->len)
+                    return false;
+                int hi = hex4(s->buf + i);
+                if (hi < 0)
+                    return false;
+                i += 4;
+                unsigned long cp = (unsigned long)hi;
+                if (hi >= 0xdc00 && hi <= 0xdfff)
+                    return false;
+                if (hi >= 0xd800 && hi <= 0xdbff) {
+                    if (i + 6 > s->len || s->buf[i] != '\\' || s->buf[i + 1] != 'u')
+                        return false;
+                    int lo = hex4(s->buf + i + 2);
+                    if (lo < 0xdc00 || lo > 0xdfff)
+                        return false;
+                    i += 6;
+                    cp = 0x10000 + (((unsigned long)hi - 0xd800) << 10) + ((unsigned long)lo - 0xdc00);
+                }
+                if (cp < 0x80) {
+                    out[0] = (char)cp;
+                } else if (cp < 0x800) {
+                    out[0] = (char)(0xc0 | (cp >> 6));
+                    out[1] = (char)(0x80 | (cp & 0x3f));
+                    out_len = 2;
+                } else if (cp < 0x10000) {
+                    out[0] = (char)(0xe0 | (cp >> 12));
+                    out[1] = (char)(0x80 | ((cp >> 6) & 0x3f));
+                    out[2] = (char)(0x80 | (cp & 0x3f));
+                    out_len = 3;
+                } else {
+                    out[0] = (char)(0xf0 | (cp >> 18));
+                    out[1] = (char)(0x80 | ((cp >> 12) & 0x3f));
+                    out[2] = (char)(0x80 | ((cp >> 6) & 0x3f));
+                    out[3] = (char)(0x80 | (cp & 0x3f));
+                    out_len = 4;
+                }
+                break;
+            }
+            default:
+                return false;
+        }
+        str_put(dst, dst_size, &n, &nul, out, out_len);
+    }
+
+    if (dst && dst_size)
+        dst[n < dst_size ? n : dst_size - 1] = '\0';
+    if (len)
+        *len = n;
+    c->i++;
+    return true;
+}
+
+static bool is_digit(char ch) {
+    return ch >= '0' && ch <= '9';
+}
+
+bool json_cur_number(json_cur_t* c, double* out) {
+    char ch = json_cur_peek(c);
+    if (ch != '-' && !is_digit(ch))
+        return false;
+
+    const json_scan_t* s = c->s;
+    size_t start = s->pos[c->i];
+    size_t end = scalar_end(s, start);
+    const char* p = s->buf + start;
+    size_t n = end - start;
+    size_t k = 0;
+
+    // -?(0|[1-9][0-9]*)(\.[0-9]+)?([eE][+-]?[0-9]+)?
+    if (k < n && p[k] == '-')
+        ++k;
+    if (k < n && p[k] == '0') {
+        ++k;
+    } else if (k < n && is_digit(p[k])) {
+        while (k < n && is_digit(p[k]))
+            ++k;
+    } else {
+        return false;
+    }
+    size_t int_end = k;
+    if (k < n && p[k] == '.') {
+        ++k;
+        if (k >= n || !is_digit(p[k]))
+            return false;
+        while (k < n && is_digit(p[k]))
+            ++k;
+    }
+    if (k < n && (p[k] == 'e' || p[k] == 'E')) {
+        ++k;
+        if (k < n && (p[k] == '+' || p[k] == '-'))
+            ++k;
+        if (k >= n || !is_digit(p[k]))
+            return false;
+        while (k < n && is_digit(p[k]))
+            ++k;
+    }
+    if (k != n)
+        return false;
+
+    // Plain integers of up to 15 digits are exact in a double: skip strtod()
+    size_t sign = (p[0] == '-') ? 1 : 0;
+    if (int_end == n && n - sign <= 15) {
+        int64_t v = 0;
+        for (size_t d = sign; d < n; ++d)
+            v = v * 10 + (p[d] - '0');
+        if (out)
+            *out = sign ? -(double)v : (double)v;
+        c->i++;
+        return true;
+    }
+
+    char tmp[128];
+    if (n >= sizeof(tmp))
+        return false;
+    memcpy(tmp, p, n);
+    tmp[n] = '\0';
+    if (out)
+        *out = strtod(tmp, NULL);
+    c->i++;
+    return true;
+}
+
+static bool literal_is(const json_cur_t* c, const char* lit) {
+    const json_scan_t* s = c->s;
+    size_t start = s->pos[c->i];
+    size_t n = strlen(lit);
+    return scalar_end(s, start) - start == n && memcmp(s->buf + start, lit, n) == 0;
+}
+
+bool json_cur_bool(json_cur_t* c, bool* out) {
+    char ch = json_cur_peek(c);
+    if (ch == 't' && literal_is(c, "true")) {
+        if (out)
+            *out = true;
+    } else if (ch == 'f' && literal_is(c, "false")) {
+        if (out)
+            *out = false;
+    } else {
+        return false;
+    }
+    c->i++;
+    return true;
+}
+
+static bool cur_take(json_cur_t* c, char ch) {
+    if (json_cur_peek(c) != ch)
+        return false;
+    c->i++;
+    return true;
+}
+
+bool json_cur_object_begin(json_cur_t* c) {
+    if (c->depth >= JSON_SCAN_MAX_DEPTH || !cur_take(c, '{'))
+        return false;
+    c->depth++;
+    return true;
+}
+
+int json_cur_member(json_cur_t* c, bool* first, char* key, size_t key_size, size_t* key_len) {
+    if (*first) {
+        *first = false;
+        if (cur_take(c, '}')) {
+            c->depth--;
+            return 0;
+        }
+    } else {
+        if (cur_take(c, '}')) {
+            c->depth--;
+            return 0;
+        }
+        if (!cur_take(c, ','))
+            return -1;
+    }
+    if (!json_cur_string(c, key, key_size, key_len) || !cur_take(c, ':'))
+        return -1;
+    return 1;
+}
+
+bool json_cur_array_begin(json_cur_t* c) {
+    if (c->depth >= JSON_SCAN_MAX_DEPTH || !cur_take(c, '['))
+        return false;
+    c->depth++;
+    return true;
+}
+
+int json_cur_element(json_cur_t* c, bool* first) {
+    if (*first) {
+        *first = false;
+        if (cur_take(c, ']')) {
+            c->depth--;
+            return 0;
+        }
+        return 1;
+    }
+    if (cur_take(c, ']')) {
+        c->depth--;
+        return 0;
+    }
+    return cur_take(c, ',') ? 1 : -1;
+}
+
+bool json_cur_skip(json_cur_t* c) {
+    bool first = true;
+    int r;
+    switch (json_cur_peek(c)) {
+        case '{':
+            if (!json_cur_object_begin(c))
+                return false;
+            while ((r = json_cur_member(c, &first, NULL, 0, NULL)) == 1) {
+                if (!json_cur_skip(c))
+                    return false;
+            }
+            return r == 0;
+        case '[':
+            if (!json_cur_array_begin(c))
+                return false;
+            while ((r = json_cur_element(c, &first)) == 1) {
+                if (!json_cur_skip(c))
+                    return false;
+            }
+            return r == 0;
+        case '"':
+            return json_cur_string(c, NULL, 0, NULL);
+        case 't':
+        case 'f':
+            return json_cur_bool(c, NULL);
+        case 'n':
+            if (!literal_is(c, "null"))
+                return false;
+            c->i++;
+            return true;
+        case '\0':
+            return false;
+        default:
+            return json_cur_number(c, NULL);
+    }
+}
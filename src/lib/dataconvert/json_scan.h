@@ -0,0 +1,115 @@
+#ifndef JSON_SCAN_H
+#define JSON_SCAN_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Two-stage JSON reader used by the wireless validate/parse/decode paths.
+//
+// Stage 1 (json_scan) classifies the document 64 bytes at a time with SIMD
+// (AVX2 or SSE2, scalar fallback) and records the offset of every structural
+// token: { } [ ] : , the opening quote of each string and the first byte of
+// each number/literal. It also rejects invalid UTF-8, unterminated strings and
+// raw control characters inside strings. All implementations produce the same
+// index for the same input.
+//
+// Stage 2 (json_cur_*) walks that index to check the grammar and decode values
+// without building a tree.
+
+typedef enum {
+    JSON_SCAN_AUTO = 0,   // Best implementation supported by the CPU
+    JSON_SCAN_SCALAR,
+    JSON_SCAN_SSE2,
+    JSON_SCAN_AVX2
+} json_scan_impl_t;
+
+typedef struct {
+    const char* buf;
+    size_t len;
+    uint32_t* pos;   // Offsets of structural tokens, in document order
+    size_t count;
+    size_t cap;
+} json_scan_t;
+
+#define JSON_SCAN_MAX_DEPTH 64
+
+void json_scan_init(json_scan_t* s);
+void json_scan_free(json_scan_t* s);
+
+/**
+ * @brief Stage 1: build the structural index of buf.
+ * @param impl Implementation to use; JSON_SCAN_AUTO picks the best available,
+ *             an unsupported one falls back to scalar.
+ * @return false on malformed input (bad UTF-8, unterminated string, control
+ *         character in a string, document >= 4 GiB) or allocation failure.
+ */
+bool json_scan(json_scan_t* s, const char* buf, size_t len, json_scan_impl_t impl);
+
+// Implementation JSON_SCAN_AUTO resolves to on this CPU
+json_scan_impl_t json_scan_best_impl(void);
+const char* json_scan_impl_name(json_scan_impl_t impl);
+
+// ---- Stage 2: cursor over the structural index ----
+
+typedef struct {
+    const json_scan_t* s;
+    size_t i;       // Next token
+    int depth;
+} json_cur_t;
+
+static inline void json_cur_init(json_cur_t* c, const json_scan_t* s) {
+    c->s = s;
+    c->i = 0;
+    c->depth = 0;
+}
+
+// First byte of the next token, '\0' at end of document
+static inline char json_cur_peek(const json_cur_t* c) {
+    return (c->i < c->s->count) ? c->s->buf[c->s->pos[c->i]] : '\0';
+}
+
+static inline bool json_cur_at_end(const json_cur_t* c) {
+    return c->i >= c->s->count;
+}
+
+/**
+ * @brief Decode a string token.
+ * @param dst      Output buffer (may be NULL to only validate), always NUL terminated.
+ * @param dst_size Size of dst.
+ * @param len      Out: C-string length of the value, i.e. bytes before the first
+ *                 NUL (from \u0000) or the end; may exceed dst_size - 1.
+ */
+bool json_cur_string(json_cur_t* c, char* dst, size_t dst_size, size_t* len);
+bool json_cur_number(json_cur_t* c, double* out);
+bool json_cur_bool(json_cur_t* c, bool* out);
+
+// Skip one value of any type, checking its grammar
+bool json_cur_skip(json_cur_t* c);
+
+/**
+ * @brief Object iteration. Call json_cur_object_begin() on '{', then
+ *        json_cur_member() until it returns 0.
+ * @return 1: key decoded and ':' consumed, cursor is on the value;
+ *         0: '}' consumed; -1: malformed.
+ */
+bool json_cur_object_begin(json_cur_t* c);
+int json_cur_member(json_cur_t* c, bool* first, char* key, size_t key_size, size_t* key_len);
+
+/**
+ * @brief Array iteration, same protocol as objects.
+ * @return 1: cursor on the next element; 0: ']' consumed; -1: malformed.
+ */
+bool json_cur_array_begin(json_cur_t* c);
+int json_cur_element(json_cur_t* c, bool* first);
+
+// Saturating double -> int conversion, same as cJSON's valueint
+static inline int json_number_to_int(double d) {
+    if (d >= 2147483647.0)
+        return 2147483647;
+    if (d <= -2147483648.0)
+        return (-2147483647 - 1);
+    return (int)d;
+}
+
+#endif // JSON_SCAN_H
@@ -1,4 +1,7 @@
 #include "parse_wireless_json.h"
+#include "wireless_codec.h"
+#include "json_scan.h"
+#include "bcml_wireless.h"
 #include <string.h>
 #include <stdbool.h>
 #include <stdlib.h>
@@ -6,44 +9,17 @@
 #include <cjson/cJSON.h>
 #include "bcml_log.h"
 
-#ifndef MAX_RADIO_NUM
-#define MAX_RADIO_NUM 4
-#endif
-
-#ifndef MAX_SSID_NUM
-#define MAX_SSID_NUM 8
-#endif
-
-static int get_json_int(const cJSON *obj, const char *key, int defval) {
-    const cJSON *item = cJSON_GetObjectItemCaseSensitive(obj, key);
-    return (cJSON_IsNumber(item)) ? item->valueint : defval;
-}
-
-static bool get_json_bool(const cJSON *obj, const char *key, bool defval) {
-    const cJSON *item = cJSON_GetObjectItemCaseSensitive(obj, key);
-    return (cJSON_IsBool(item)) ? cJSON_IsTrue(item) : defval;
-}
-
-static void get_json_string(const cJSON *obj, const char *key, char *dst, size_t dst_sz) {
-    const cJSON *item = cJSON_GetObjectItemCaseSensitive(obj, key);
-    if (cJSON_IsString(item) && (item->valuestring != NULL)) {
-        strncpy(dst, item->valuestring, dst_sz - 1);
-        dst[dst_sz - 1] = '\0';
-    } else {
-        if (dst_sz > 0) dst[0] = '\0';
-    }
-}
-
-bool parse_wireless_json(const char* json, void* sdata) {
-    BCML_LOG_DEBUG("parse_wireless_json: called with json=%p, sdata=%p\n", json, sdata);
-
+bool parse_wireless_json_cjson(const char* json, void* sdata) {
     bcml_wireless_cfg_t* cfg = (bcml_wireless_cfg_t*)sdata;
 
     if (!json || !cfg) {
         BCML_LOG_WARN("parse_wireless_json: Invalid input. json=%p, sdata=%p\n", json, sdata);
         return false;
     }
-    memset(cfg, 0, sizeof(bcml_wireless_cfg_t));
+    bcml_wireless_cfg_resize(cfg, 0, 0);
+
+    bcml_wireless_limits_t limits;
+    bcml_wireless_get_limits(&limits);
 
     cJSON *root = cJSON_Parse(json);
     if (!root) {
@@ -64,19 +40,17 @@ bool parse_wireless_json(const char* json, void* sdata) {
     if (cJSON_IsArray(radios)) {
         int radio_count = cJSON_GetArraySize(radios);
         BCML_LOG_DEBUG("parse_wireless_json: Found radio array with %d elements.\n", radio_count);
-        for (int i = 0; i < radio_count && i < MAX_RADIO_NUM; ++i) {
+        if (radio_count > limits.max_radio)
+            radio_count = limits.max_radio;
+        if (!bcml_wireless_cfg_resize(cfg, radio_count, 0)) {
+            cJSON_Delete(root);
+            return false;
+        }
+        for (int i = 0; i < radio_count; ++i) {
             cJSON *radio_obj = cJSON_GetArrayItem(radios, i);
             if (!cJSON_IsObject(radio_obj)) continue;
             bcml_wireless_radio_t *radio = &cfg->radio[i];
-            radio->power         = get_json_int(radio_obj, "power", 0);
-            radio->channel2g     = get_json_int(radio_obj, "channel2g", 0);
-            radio->channel5g     = get_json_int(radio_obj, "channel5g", 0);
-            radio->bandwidth2g   = get_json_int(radio_obj, "bandwidth2g", 0);
-            radio->bandwidth5g   = get_json_int(radio_obj, "bandwidth5g", 0);
-            radio->dfs           = get_json_bool(radio_obj, "dfs", false);
-            radio->atf           = get_json_bool(radio_obj, "atf", false);
-            radio->bandsteering  = get_json_bool(radio_obj, "bandsteering", false);
-            radio->zerowait      = get_json_bool(radio_obj, "zerowait", false);
+            wireless_radio_from_json(radio_obj, radio, WIRELESS_KEYS_NB);
             BCML_LOG_DEBUG("parse_wireless_json: radio[%d] parsed: power=%d, channel2g=%d, channel5g=%d, bandwidth2g=%d, bandwidth5g=%d, dfs=%d, atf=%d, bandsteering=%d, zerowait=%d\n",
                 i, radio->power, radio->channel2g, radio->channel5g, radio->bandwidth2g, radio->bandwidth5g,
                 radio->dfs, radio->atf, radio->bandsteering, radio->zerowait);
@@ -90,19 +64,17 @@ bool parse_wireless_json(const char* json, void* sdata) {
     if (cJSON_IsArray(ssids)) {
         int ssid_count = cJSON_GetArraySize(ssids);
         BCML_LOG_DEBUG("parse_wireless_json: Found ssid array with %d elements.\n", ssid_count);
-        for (int i = 0; i < ssid_count && i < MAX_SSID_NUM; ++i) {
+        if (ssid_count > limits.max_ssid)
+            ssid_count = limits.max_ssid;
+        if (!bcml_wireless_cfg_resize(cfg, cfg->radio_count, ssid_count)) {
+            cJSON_Delete(root);
+            return false;
+        }
+        for (int i = 0; i < ssid_count; ++i) {
             cJSON *ssid_obj = cJSON_GetArrayItem(ssids, i);
             if (!cJSON_IsObject(ssid_obj)) continue;
             bcml_wireless_ssid_t *ssid = &cfg->ssid[i];
-            get_json_string(ssid_obj, "ssid", ssid->ssid, sizeof(ssid->ssid));
-            ssid->hide              = get_json_bool(ssid_obj, "hide", false);
-            ssid->security          = get_json_int(ssid_obj, "security", 0);
-            get_json_string(ssid_obj, "password", ssid->password, sizeof(ssid->password));
-            ssid->password_onscreen = get_json_bool(ssid_obj, "password_onscreen", false);
-            ssid->enable2g          = get_json_bool(ssid_obj, "enable2g", false);
-            ssid->enable5g          = get_json_bool(ssid_obj, "enable5g", false);
-            ssid->isolation         = get_json_bool(ssid_obj, "isolation", false);
-            ssid->hopping           = get_json_bool(ssid_obj, "hopping", false);
+            wireless_ssid_from_json(ssid_obj, ssid, WIRELESS_KEYS_NB);
             BCML_LOG_DEBUG("parse_wireless_json: ssid[%d] parsed: ssid='%s', hide=%d, security=%d, password='%s', password_onscreen=%d, enable2g=%d, enable5g=%d, isolation=%d, hopping=%d\n",
                 i, ssid->ssid, ssid->hide, ssid->security, ssid->password, ssid->password_onscreen,
                 ssid->enable2g, ssid->enable5g, ssid->isolation, ssid->hopping);
@@ -115,3 +87,76 @@ bool parse_wireless_json(const char* json, void* sdata) {
     BCML_LOG_DEBUG("parse_wireless_json: JSON parsed successfully.\n");
     return true;
 }
+
+bool parse_wireless_json_scan(const char* json, void* sdata) {
+    bcml_wireless_cfg_t* cfg = (bcml_wireless_cfg_t*)sdata;
+
+    if (!json || !cfg) {
+        BCML_LOG_WARN("parse_wireless_json: Invalid input. json=%p, sdata=%p\n", json, sdata);
+        return false;
+    }
+    bcml_wireless_cfg_resize(cfg, 0, 0);
+
+    json_scan_t scan;
+    json_cur_t cur;
+    char key[16];
+    size_t key_len;
+    bool first = true;
+    bool found = false;
+    bool ok = false;
+    int r;
+
+    json_scan_init(&scan);
+    if (!json_scan(&scan, json, strlen(json), JSON_SCAN_AUTO)) {
+        BCML_LOG_ERROR("parse_wireless_json: Failed to parse JSON.\n");
+        goto out;
+    }
+
+    json_cur_init(&cur, &scan);
+    if (!json_cur_object_begin(&cur)) {
+        BCML_LOG_ERROR("parse_wireless_json: 'wireless' object not found or not an object\n");
+        goto out;
+    }
+    while ((r = json_cur_member(&cur, &first, key, sizeof(key), &key_len)) == 1) {
+        // Only the first "wireless" member counts; everything else is skipped
+        if (found || key_len >= sizeof(key) || strcmp(key, "wireless") != 0) {
+            if (!json_cur_skip(&cur))
+                goto malformed;
+            continue;
+        }
+        found = true;
+        if (json_cur_peek(&cur) != '{') {
+            BCML_LOG_ERROR("parse_wireless_json: 'wireless' object not found or not an object\n");
+            goto out;
+        }
+        if (!wireless_cfg_from_scan(&cur, cfg, WIRELESS_SECTION_ALL, WIRELESS_KEYS_NB, false))
+            goto malformed;
+    }
+    if (r < 0 || !json_cur_at_end(&cur))
+        goto malformed;
+    if (!found) {
+        BCML_LOG_ERROR("parse_wireless_json: 'wireless' object not found or not an object\n");
+        goto out;
+    }
+
+    ok = true;
+    BCML_LOG_DEBUG("parse_wireless_json: JSON parsed successfully.\n");
+    goto out;
+
+malformed:
+    BCML_LOG_ERROR("parse_wireless_json: Failed to parse JSON.\n");
+out:
+    if (!ok)
+        bcml_wireless_cfg_resize(cfg, 0, 0);
+    json_scan_free(&scan);
+    return ok;
+}
+
+bool parse_wireless_json(const char* json, void* sdata) {
+    BCML_LOG_DEBUG("parse_wireless_json: called with json=%p, sdata=%p\n", json, sdata);
+#ifdef BCML_JSON_SCAN
+    return parse_wireless_json_scan(json, sdata);
+#else
+    return parse_wireless_json_cjson(json, sdata);
+#endif
+}
@@ -6,4 +6,9 @@
 
 bool parse_wireless_json(const char* json, void* sdata);
 
+// Implementations behind parse_wireless_json(), selected by BCML_JSON_SCAN.
+// The cJSON one is kept as the reference for differential fuzzing.
+bool parse_wireless_json_cjson(const char* json, void* sdata);
+bool parse_wireless_json_scan(const char* json, void* sdata);
+
 #endif // PARSE_WIRELESS_JSON_H
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "wireless_cbor.h"
+#include "wireless_codec.h"
+#include "cbor.h"
+#include "bcml_types.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <string.h>
+
+// Top level: a map holding exactly "wireless", nothing after it
+static bool decode(const uint8_t* data, size_t len, bcml_wireless_cfg_t* cfg) {
+    cbor_reader_t r;
+    const char* key;
+    size_t key_len;
+    size_t pairs;
+
+    if (!data || len == 0) {
+        BCML_LOG_ERROR("wireless_cbor: no data\n");
+        return false;
+    }
+    cbor_reader_init(&r, data, len);
+    if (!cbor_get_map(&r, &pairs) || pairs != 1 || !cbor_get_text(&r, &key, &key_len) ||
+        key_len != 8 || memcmp(key, "wireless", 8) != 0) {
+        BCML_LOG_ERROR("wireless_cbor: root must be a map holding only 'wireless'\n");
+        return false;
+    }
+    if (!wireless_cfg_from_cbor(&r, cfg, WIRELESS_SECTION_ALL, WIRELESS_KEYS_NB)) {
+        BCML_LOG_ERROR("wireless_cbor: Missing or invalid 'wireless' map\n");
+        return false;
+    }
+    if (!cbor_at_end(&r)) {
+        BCML_LOG_ERROR("wireless_cbor: trailing data\n");
+        return false;
+    }
+    return true;
+}
+
+bool validate_wireless_cbor(const uint8_t* data, size_t len) {
+    // Decode target, kept per thread so its block is reused across calls
+    static __thread bcml_wireless_cfg_t scratch;
+    bool ok = decode(data, len, &scratch);
+    if (ok)
+        BCML_LOG_INFO("validate_wireless_cbor: validation successful\n");
+    return ok;
+}
+
+bool parse_wireless_cbor(const uint8_t* data, size_t len, void* sdata) {
+    // Decoded aside and swapped in, so a rejected document leaves sdata as it was
+    static __thread bcml_wireless_cfg_t scratch;
+    bcml_wireless_cfg_t* cfg = (bcml_wireless_cfg_t*)sdata;
+
+    if (!cfg) {
+        BCML_LOG_WARN("parse_wireless_cbor: sdata is NULL\n");
+        return false;
+    }
+    if (!decode(data, len, &scratch))
+        return false;
+    bcml_wireless_cfg_t tmp = *cfg;
+    *cfg = scratch;
+    scratch = tmp;
+    BCML_LOG_DEBUG("parse_wireless_cbor: %d radios, %d ssids\n", cfg->radio_count, cfg->ssid_count);
+    return true;
+}
+
+bool export_wireless_cbor(const void* sdata, uint8_t* buffer, size_t buffer_size, size_t* len) {
+    const bcml_wireless_cfg_t* cfg = (const bcml_wireless_cfg_t*)sdata;
+    cbor_writer_t w;
+
+    if (!cfg || !buffer || !len) {
+        BCML_LOG_ERROR("export_wireless_cbor: Invalid input. sdata=%p, buffer=%p\n", sdata, (void*)buffer);
+        return false;
+    }
+    cbor_writer_init(&w, buffer, buffer_size);
+    cbor_put_map(&w, 1);
+    cbor_put_text(&w, "wireless", 8);
+    wireless_cfg_to_cbor(&w, cfg, WIRELESS_SECTION_ALL, WIRELESS_KEYS_NB);
+    *len = w.len;
+    if (!cbor_writer_ok(&w)) {
+        BCML_LOG_ERROR("export_wireless_cbor: Buffer too small (required=%zu, given=%zu)\n", w.len, buffer_size);
+        return false;
+    }
+    BCML_LOG_INFO("export_wireless_cbor: exported %zu bytes\n", w.len);
+    return true;
+}
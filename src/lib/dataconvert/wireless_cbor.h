@@ -0,0 +1,26 @@
+#ifndef WIRELESS_CBOR_H
+#define WIRELESS_CBOR_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary (CBOR, RFC 8949) northbound form of the wireless config: the same
+// document as the JSON form, {"wireless":{"radio":[...],"ssid":[...]}}, with the
+// same keys, written as CBOR maps, arrays, integers, booleans and text strings.
+// Accepted under the same schema rules as the JSON form.
+
+// Schema check only (decodes into a per-thread scratch config)
+bool validate_wireless_cbor(const uint8_t* data, size_t len);
+
+// Validate and decode into sdata (bcml_wireless_cfg_t), which is left untouched on failure
+bool parse_wireless_cbor(const uint8_t* data, size_t len, void* sdata);
+
+/**
+ * @brief Encode sdata (bcml_wireless_cfg_t); SSID entries with an empty name are skipped.
+ * @param len  Set to the encoded size, also when it does not fit buffer_size.
+ * @return false if the buffer is too small.
+ */
+bool export_wireless_cbor(const void* sdata, uint8_t* buffer, size_t buffer_size, size_t* len);
+
+#endif // WIRELESS_CBOR_H
@@ -0,0 +1,121 @@
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Block layout: radio_count radios, padding to 8 bytes, ssid_count SSIDs
+#define SSID_OFFSET(nr) (((size_t)(nr) * sizeof(bcml_wireless_radio_t) + 7) & ~(size_t)7)
+
+// Device limits, when known, take precedence over the schema's. Each pair is
+// packed into one word (radios high, SSIDs low; 0 = no device limits) so a
+// bcml_sb_select() on one thread never hands a concurrent get a torn pair.
+#define LIMITS_PACK(r, s) ((uint32_t)(r) << 16 | (uint32_t)(s))
+static uint32_t g_schema_limits = LIMITS_PACK(MAX_RADIO_NUM, MAX_SSID_NUM);
+static uint32_t g_device_limits;
+
+void bcml_wireless_cfg_init(bcml_wireless_cfg_t* cfg) {
+    if (cfg)
+        memset(cfg, 0, sizeof(*cfg));
+}
+
+void bcml_wireless_cfg_free(bcml_wireless_cfg_t* cfg) {
+    if (!cfg)
+        return;
+    free(cfg->arena);
+    memset(cfg, 0, sizeof(*cfg));
+}
+
+bool bcml_wireless_cfg_resize(bcml_wireless_cfg_t* cfg, int radio_count, int ssid_count) {
+    if (!cfg || radio_count < 0 || ssid_count < 0 ||
+        radio_count > BCML_RADIO_LIMIT || ssid_count > BCML_SSID_LIMIT) {
+        BCML_LOG_WARN("bcml_wireless_cfg_resize: invalid counts %d/%d\n", radio_count, ssid_count);
+        return false;
+    }
+
+    size_t need = SSID_OFFSET(radio_count) + (size_t)ssid_count * sizeof(bcml_wireless_ssid_t);
+    if (need > cfg->arena_size) {
+        void* p = realloc(cfg->arena, need);
+        if (!p)
+            return false;
+        cfg->arena = p;
+        cfg->arena_size = need;
+    }
+
+    char* base = (char*)cfg->arena;
+    size_t old_ssid_off = SSID_OFFSET(cfg->radio_count);
+    size_t new_ssid_off = SSID_OFFSET(radio_count);
+    int keep_radio = cfg->radio_count < radio_count ? cfg->radio_count : radio_count;
+    int keep_ssid = cfg->ssid_count < ssid_count ? cfg->ssid_count : ssid_count;
+
+    // Move the SSIDs first: growing radios overwrite their old place
+    if (keep_ssid && old_ssid_off != new_ssid_off)
+        memmove(base + new_ssid_off, base + old_ssid_off, (size_t)keep_ssid * sizeof(bcml_wireless_ssid_t));
+    if (radio_count > keep_radio)
+        memset(base + (size_t)keep_radio * sizeof(bcml_wireless_radio_t), 0,
+               (size_t)(radio_count - keep_radio) * sizeof(bcml_wireless_radio_t));
+    if (ssid_count > keep_ssid)
+        memset(base + new_ssid_off + (size_t)keep_ssid * sizeof(bcml_wireless_ssid_t), 0,
+               (size_t)(ssid_count - keep_ssid) * sizeof(bcml_wireless_ssid_t));
+
+    cfg->radio = radio_count ? (bcml_wireless_radio_t*)base : NULL;
+    cfg->ssid = ssid_count ? (bcml_wireless_ssid_t*)(base + new_ssid_off) : NULL;
+    cfg->radio_count = radio_count;
+    cfg->ssid_count = ssid_count;
+    return true;
+}
+
+bool bcml_wireless_cfg_copy(bcml_wireless_cfg_t* dst, const bcml_wireless_cfg_t* src) {
+    if (!dst || !src)
+        return false;
+    if (dst == src)
+        return true;
+    // Counts to zero first so resize does not move entries that are about to be overwritten
+    if (!bcml_wireless_cfg_resize(dst, 0, 0) ||
+        !bcml_wireless_cfg_resize(dst, src->radio_count, src->ssid_count))
+        return false;
+    if (src->radio_count)
+        memcpy(dst->radio, src->radio, (size_t)src->radio_count * sizeof(*src->radio));
+    if (src->ssid_count)
+        memcpy(dst->ssid, src->ssid, (size_t)src->ssid_count * sizeof(*src->ssid));
+    return true;
+}
+
+void bcml_wireless_get_limits(bcml_wireless_limits_t* limits) {
+    if (!limits)
+        return;
+    uint32_t packed = __atomic_load_n(&g_device_limits, __ATOMIC_RELAXED);
+    if (!packed)
+        packed = __atomic_load_n(&g_schema_limits, __ATOMIC_RELAXED);
+    limits->max_radio = (int)(packed >> 16);
+    limits->max_ssid = (int)(packed & 0xffff);
+}
+
+static bool limits_usable(const bcml_wireless_limits_t* limits) {
+    return limits->max_radio >= 1 && limits->max_radio <= BCML_RADIO_LIMIT &&
+           limits->max_ssid >= 1 && limits->max_ssid <= BCML_SSID_LIMIT;
+}
+
+bool bcml_wireless_set_limits(const bcml_wireless_limits_t* limits) {
+    if (!limits) {
+        __atomic_store_n(&g_device_limits, 0, __ATOMIC_RELAXED);
+        return true;
+    }
+    if (!limits_usable(limits)) {
+        BCML_LOG_ERROR("bcml_wireless_set_limits: limits out of range\n");
+        return false;
+    }
+    __atomic_store_n(&g_device_limits, LIMITS_PACK(limits->max_radio, limits->max_ssid), __ATOMIC_RELAXED);
+    BCML_LOG_INFO("bcml_wireless_set_limits: radio<=%d ssid<=%d\n", limits->max_radio, limits->max_ssid);
+    return true;
+}
+
+bool bcml_wireless_set_schema_limits(const bcml_wireless_limits_t* limits) {
+    if (!limits || !limits_usable(limits)) {
+        BCML_LOG_ERROR("bcml_wireless_set_schema_limits: limits out of range\n");
+        return false;
+    }
+    __atomic_store_n(&g_schema_limits, LIMITS_PACK(limits->max_radio, limits->max_ssid), __ATOMIC_RELAXED);
+    BCML_LOG_INFO("bcml_wireless_set_schema_limits: radio<=%d ssid<=%d\n", limits->max_radio, limits->max_ssid);
+    return true;
+}
@@ -0,0 +1,909 @@
+#include "wireless_codec.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <limits.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef enum {
+    WFIELD_INT,
+    WFIELD_BOOL,
+    WFIELD_STRING
+} wireless_field_type_t;
+
+typedef struct {
+    const char* key;        // Northbound key
+    const char* rest_key;   // REST backend key, NULL if identical
+    wireless_field_type_t type;
+    size_t offset;
+    size_t size;            // Buffer size for WFIELD_STRING
+    int min;                // Schema range: value for WFIELD_INT, length for WFIELD_STRING
+    int max;
+} wireless_field_t;
+
+#define WFIELD(st, name, t, lo, hi) \
+    { #name, NULL, t, offsetof(st, name), sizeof(((st*)0)->name), lo, hi }
+#define WFIELD_REST(st, name, rk, t, lo, hi) \
+    { #name, rk, t, offsetof(st, name), sizeof(((st*)0)->name), lo, hi }
+
+static const wireless_field_t radio_fields[] = {
+    WFIELD(bcml_wireless_radio_t, power,        WFIELD_INT, 0, 100),
+    WFIELD(bcml_wireless_radio_t, channel2g,    WFIELD_INT, 0, INT_MAX),
+    WFIELD(bcml_wireless_radio_t, channel5g,    WFIELD_INT, 0, INT_MAX),
+    WFIELD(bcml_wireless_radio_t, bandwidth2g,  WFIELD_INT, 0, INT_MAX),
+    WFIELD(bcml_wireless_radio_t, bandwidth5g,  WFIELD_INT, 0, INT_MAX),
+    WFIELD(bcml_wireless_radio_t, dfs,          WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_radio_t, atf,          WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_radio_t, bandsteering, WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_radio_t, zerowait,     WFIELD_BOOL, 0, 0),
+};
+
+static const wireless_field_t ssid_fields[] = {
+    WFIELD(bcml_wireless_ssid_t, ssid,     WFIELD_STRING, 1, BCML_SSID_MAX_LEN),
+    WFIELD(bcml_wireless_ssid_t, hide,     WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_ssid_t, security, WFIELD_INT, 0, INT_MAX),
+    WFIELD(bcml_wireless_ssid_t, password, WFIELD_STRING, 0, BCML_PASSWORD_MAX_LEN),
+    WFIELD_REST(bcml_wireless_ssid_t, password_onscreen, "password-onscreen", WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_ssid_t, enable2g,  WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_ssid_t, enable5g,  WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_ssid_t, isolation, WFIELD_BOOL, 0, 0),
+    WFIELD(bcml_wireless_ssid_t, hopping,   WFIELD_BOOL, 0, 0),
+};
+
+#define NUM_FIELDS(t) (sizeof(t) / sizeof((t)[0]))
+
+static const char* field_key(const wireless_field_t* f, wireless_keyset_t keys) {
+    return (keys == WIRELESS_KEYS_REST && f->rest_key) ? f->rest_key : f->key;
+}
+
+static cJSON* item_to_json(const wireless_field_t* fields, size_t n, const void* item, wireless_keyset_t keys) {
+    cJSON* obj = cJSON_CreateObject();
+    if (!obj)
+        return NULL;
+    const char* base = (const char*)item;
+    for (size_t i = 0; i < n; ++i) {
+        const wireless_field_t* f = &fields[i];
+        const char* key = field_key(f, keys);
+        switch (f->type) {
+            case WFIELD_INT:    cJSON_AddNumberToObject(obj, key, *(const int*)(base + f->offset)); break;
+            case WFIELD_BOOL:   cJSON_AddBoolToObject(obj, key, *(const bool*)(base + f->offset)); break;
+            case WFIELD_STRING: cJSON_AddStringToObject(obj, key, base + f->offset); break;
+        }
+    }
+    return obj;
+}
+
+static void item_from_json(const wireless_field_t* fields, size_t n, const cJSON* obj, void* item, wireless_keyset_t keys) {
+    char* base = (char*)item;
+    for (size_t i = 0; i < n; ++i) {
+        const wireless_field_t* f = &fields[i];
+        const cJSON* v = cJSON_GetObjectItemCaseSensitive(obj, field_key(f, keys));
+        switch (f->type) {
+            case WFIELD_INT:
+                *(int*)(base + f->offset) = cJSON_IsNumber(v) ? v->valueint : 0;
+                break;
+            case WFIELD_BOOL:
+                *(bool*)(base + f->offset) = cJSON_IsBool(v) ? cJSON_IsTrue(v) : false;
+                break;
+            case WFIELD_STRING: {
+                char* dst = base + f->offset;
+                if (cJSON_IsString(v) && v->valuestring) {
+                    strncpy(dst, v->valuestring, f->size - 1);
+                    dst[f->size - 1] = '\0';
+                } else {
+                    dst[0] = '\0';
+                }
+                break;
+            }
+        }
+    }
+}
+
+cJSON* wireless_radio_to_json(const bcml_wireless_radio_t* radio, wireless_keyset_t keys) {
+    if (!radio) {
+        BCML_LOG_WARN("wireless_radio_to_json: radio is NULL\n");
+        return NULL;
+    }
+    return item_to_json(radio_fields, NUM_FIELDS(radio_fields), radio, keys);
+}
+
+cJSON* wireless_ssid_to_json(const bcml_wireless_ssid_t* ssid, wireless_keyset_t keys) {
+    if (!ssid) {
+        BCML_LOG_WARN("wireless_ssid_to_json: ssid is NULL\n");
+        return NULL;
+    }
+    return item_to_json(ssid_fields, NUM_FIELDS(ssid_fields), ssid, keys);
+}
+
+void wireless_radio_from_json(const cJSON* obj, bcml_wireless_radio_t* radio, wireless_keyset_t keys) {
+    item_from_json(radio_fields, NUM_FIELDS(radio_fields), obj, radio, keys);
+}
+
+void wireless_ssid_from_json(const cJSON* obj, bcml_wireless_ssid_t* ssid, wireless_keyset_t keys) {
+    item_from_json(ssid_fields, NUM_FIELDS(ssid_fields), obj, ssid, keys);
+}
+
+cJSON* wireless_cfg_to_json(const bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys) {
+    if (!cfg)
+        return NULL;
+
+    cJSON* obj = cJSON_CreateObject();
+    if (!obj)
+        return NULL;
+
+    if (sections & WIRELESS_SECTION_RADIO) {
+        cJSON* radio_array = cJSON_AddArrayToObject(obj, "radio");
+        for (int i = 0; i < cfg->radio_count; ++i) {
+            cJSON* radio_obj = wireless_radio_to_json(&cfg->radio[i], keys);
+            if (!radio_obj) {
+                BCML_LOG_WARN("wireless_cfg_to_json: radio_obj is NULL for radio[%d]\n", i);
+                continue;
+            }
+            cJSON_AddItemToArray(radio_array, radio_obj);
+        }
+    }
+
+    if (sections & WIRELESS_SECTION_SSID) {
+        cJSON* ssid_array = cJSON_AddArrayToObject(obj, "ssid");
+        for (int i = 0; i < cfg->ssid_count; ++i) {
+            if (cfg->ssid[i].ssid[0] == '\0') {
+                BCML_LOG_DEBUG("wireless_cfg_to_json: skip empty ssid[%d]\n", i);
+                continue;
+            }
+            cJSON* ssid_obj = wireless_ssid_to_json(&cfg->ssid[i], keys);
+            if (!ssid_obj) {
+                BCML_LOG_WARN("wireless_cfg_to_json: ssid_obj is NULL for ssid[%d]\n", i);
+                continue;
+            }
+            cJSON_AddItemToArray(ssid_array, ssid_obj);
+        }
+    }
+    return obj;
+}
+
+void wireless_cfg_from_json(const cJSON* obj, bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys) {
+    bcml_wireless_limits_t limits;
+    if (!cfg)
+        return;
+    bcml_wireless_get_limits(&limits);
+
+    if (sections & WIRELESS_SECTION_RADIO) {
+        const cJSON* radios = cJSON_GetObjectItemCaseSensitive(obj, "radio");
+        int count = cJSON_IsArray(radios) ? cJSON_GetArraySize(radios) : 0;
+        if (count > limits.max_radio)
+            count = limits.max_radio;
+        // Shrink to zero first so every entry starts out cleared
+        if (!bcml_wireless_cfg_resize(cfg, 0, cfg->ssid_count) ||
+            !bcml_wireless_cfg_resize(cfg, count, cfg->ssid_count))
+            return;
+        for (int i = 0; i < count; ++i) {
+            const cJSON* item = cJSON_GetArrayItem(radios, i);
+            if (cJSON_IsObject(item))
+                wireless_radio_from_json(item, &cfg->radio[i], keys);
+        }
+    }
+
+    if (sections & WIRELESS_SECTION_SSID) {
+        const cJSON* ssids = cJSON_GetObjectItemCaseSensitive(obj, "ssid");
+        int count = cJSON_IsArray(ssids) ? cJSON_GetArraySize(ssids) : 0;
+        if (count > limits.max_ssid)
+            count = limits.max_ssid;
+        if (!bcml_wireless_cfg_resize(cfg, cfg->radio_count, 0) ||
+            !bcml_wireless_cfg_resize(cfg, cfg->radio_count, count))
+            return;
+        for (int i = 0; i < count; ++i) {
+            const cJSON* item = cJSON_GetArrayItem(ssids, i);
+            if (cJSON_IsObject(item))
+                wireless_ssid_from_json(item, &cfg->ssid[i], keys);
+        }
+    }
+}
+
+// ---- Decoding from the structural index (json_scan.h) ----
+
+#define WFIELD_KEY_MAX 32
+
+static bool scan_is_number(char ch) {
+    return ch == '-' || (ch >= '0' && ch <= '9');
+}
+
+// Decode one field value; a value of the wrong type is skipped (lenient) or rejected (strict)
+static bool field_from_scan(const wireless_field_t* f, json_cur_t* c, char* base, bool strict) {
+    char ch = json_cur_peek(c);
+    switch (f->type) {
+        case WFIELD_INT:
+            if (scan_is_number(ch)) {
+                double d;
+                if (!json_cur_number(c, &d))
+                    return false;
+                int v = json_number_to_int(d);
+                if (strict && (v < f->min || v > f->max)) {
+                    BCML_LOG_WARN("wireless_cfg_from_scan: invalid %s value\n", f->key);
+                    return false;
+                }
+                *(int*)(base + f->offset) = v;
+                return true;
+            }
+            break;
+        case WFIELD_BOOL:
+            if (ch == 't' || ch == 'f')
+                return json_cur_bool(c, (bool*)(base + f->offset));
+            break;
+        case WFIELD_STRING:
+            if (ch == '"') {
+                size_t len;
+                if (!json_cur_string(c, base + f->offset, f->size, &len))
+                    return false;
+                if (strict && (len < (size_t)f->min || len > (size_t)f->max)) {
+                    BCML_LOG_WARN("wireless_cfg_from_scan: invalid %s string\n", f->key);
+                    return false;
+                }
+                return true;
+            }
+            break;
+    }
+    if (strict) {
+        BCML_LOG_WARN("wireless_cfg_from_scan: invalid type for field %s\n", f->key);
+        return false;
+    }
+    return json_cur_skip(c);
+}
+
+static bool item_from_scan(const wireless_field_t* fields, size_t n, json_cur_t* c, void* item,
+                           size_t item_size, wireless_keyset_t keys, bool strict) {
+    char* base = (char*)item;
+    char key[WFIELD_KEY_MAX];
+    size_t key_len;
+    uint32_t seen = 0;
+    bool first = true;
+    int r;
+
+    memset(item, 0, item_size);
+    if (!json_cur_object_begin(c))
+        return false;
+    while ((r = json_cur_member(c, &first, key, sizeof(key), &key_len)) == 1) {
+        size_t idx = n;
+        if (key_len < sizeof(key)) {
+            for (idx = 0; idx < n; ++idx) {
+                if (strcmp(key, field_key(&fields[idx], keys)) == 0)
+                    break;
+            }
+        }
+        // Like cJSON_GetObjectItemCaseSensitive, only the first occurrence of a key counts
+        if (idx == n || (seen & (1u << idx))) {
+            if (strict) {
+                BCML_LOG_WARN("wireless_cfg_from_scan: unknown or duplicate field '%s'\n", key);
+                return false;
+            }
+            if (!json_cur_skip(c))
+                return false;
+            continue;
+        }
+        seen |= 1u << idx;
+        if (!field_from_scan(&fields[idx], c, base, strict))
+            return false;
+    }
+    if (r < 0)
+        return false;
+    if (strict && seen != (1u << n) - 1) {
+        BCML_LOG_WARN("wireless_cfg_from_scan: missing required fields\n");
+        return false;
+    }
+    return true;
+}
+
+// Entry `index` of a section, resizing the section to index + 1 entries
+static void* section_append(bcml_wireless_cfg_t* cfg, unsigned section, int index) {
+    if (section == WIRELESS_SECTION_RADIO)
+        return bcml_wireless_cfg_resize(cfg, index + 1, cfg->ssid_count) ? &cfg->radio[index] : NULL;
+    return bcml_wireless_cfg_resize(cfg, cfg->radio_count, index + 1) ? &cfg->ssid[index] : NULL;
+}
+
+static bool section_clear(bcml_wireless_cfg_t* cfg, unsigned section) {
+    if (section == WIRELESS_SECTION_RADIO)
+        return bcml_wireless_cfg_resize(cfg, 0, cfg->ssid_count);
+    return bcml_wireless_cfg_resize(cfg, cfg->radio_count, 0);
+}
+
+static bool section_from_scan(json_cur_t* c, bcml_wireless_cfg_t* cfg, unsigned section,
+                              wireless_keyset_t keys, bool strict) {
+    bool radio = section == WIRELESS_SECTION_RADIO;
+    const wireless_field_t* fields = radio ? radio_fields : ssid_fields;
+    size_t n = radio ? NUM_FIELDS(radio_fields) : NUM_FIELDS(ssid_fields);
+    size_t item_size = radio ? sizeof(bcml_wireless_radio_t) : sizeof(bcml_wireless_ssid_t);
+    const char* name = radio ? "radio" : "ssid";
+    bcml_wireless_limits_t limits;
+    bool first = true;
+    int count = 0;
+    int r;
+
+    bcml_wireless_get_limits(&limits);
+    int max = radio ? limits.max_radio : limits.max_ssid;
+    if (!section_clear(cfg, section))
+        return false;
+
+    if (json_cur_peek(c) != '[') {
+        if (strict) {
+            BCML_LOG_ERROR("wireless_cfg_from_scan: invalid '%s' array\n", name);
+            return false;
+        }
+        return json_cur_skip(c);
+    }
+
+    if (!json_cur_array_begin(c))
+        return false;
+    while ((r = json_cur_element(c, &first)) == 1) {
+        if (count >= max) {
+            if (strict) {
+                BCML_LOG_ERROR("wireless_cfg_from_scan: '%s' array size out of bounds\n", name);
+                return false;
+            }
+            if (!json_cur_skip(c))
+                return false;
+            continue;
+        }
+        void* item = section_append(cfg, section, count);
+        if (!item)
+            return false;
+        if (json_cur_peek(c) == '{') {
+            if (!item_from_scan(fields, n, c, item, item_size, keys, strict)) {
+                if (strict)
+                    BCML_LOG_ERROR("wireless_cfg_from_scan: invalid '%s' item at index %d\n", name, count);
+                return false;
+            }
+        } else {
+            if (strict) {
+                BCML_LOG_ERROR("wireless_cfg_from_scan: '%s' item %d is not an object\n", name, count);
+                return false;
+            }
+            if (!json_cur_skip(c))
+                return false;
+        }
+        ++count;
+    }
+    if (r < 0)
+        return false;
+    if (strict && count < 1) {
+        BCML_LOG_ERROR("wireless_cfg_from_scan: '%s' array is empty\n", name);
+        return false;
+    }
+    return true;
+}
+
+bool wireless_cfg_from_scan(json_cur_t* c, bcml_wireless_cfg_t* cfg, unsigned sections,
+                            wireless_keyset_t keys, bool strict) {
+    char key[WFIELD_KEY_MAX];
+    size_t key_len;
+    unsigned seen = 0;
+    bool first = true;
+    int r;
+
+    if (!cfg || !json_cur_object_begin(c))
+        return false;
+    while ((r = json_cur_member(c, &first, key, sizeof(key), &key_len)) == 1) {
+        unsigned section = 0;
+        if (key_len < sizeof(key)) {
+            if (strcmp(key, "radio") == 0)
+                section = WIRELESS_SECTION_RADIO;
+            else if (strcmp(key, "ssid") == 0)
+                section = WIRELESS_SECTION_SSID;
+        }
+        if (!(section & sections) || (seen & section)) {
+            if (strict) {
+                BCML_LOG_WARN("wireless_cfg_from_scan: unknown or duplicate field '%s'\n", key);
+                return false;
+            }
+            if (!json_cur_skip(c))
+                return false;
+            continue;
+        }
+        seen |= section;
+        if (!section_from_scan(c, cfg, section, keys, strict))
+            return false;
+    }
+    if (r < 0)
+        return false;
+
+    unsigned missing = sections & ~seen;
+    if (missing && strict) {
+        BCML_LOG_ERROR("wireless_cfg_from_scan: missing '%s' array\n",
+                       (missing & WIRELESS_SECTION_RADIO) ? "radio" : "ssid");
+        return false;
+    }
+    if (missing & WIRELESS_SECTION_RADIO)
+        section_clear(cfg, WIRELESS_SECTION_RADIO);
+    if (missing & WIRELESS_SECTION_SSID)
+        section_clear(cfg, WIRELESS_SECTION_SSID);
+    return true;
+}
+
+// ---- CBOR (cbor.h) ----
+
+static bool key_is(const char* key, size_t key_len, const char* name) {
+    return strlen(name) == key_len && memcmp(key, name, key_len) == 0;
+}
+
+static void item_to_cbor(cbor_writer_t* w, const wireless_field_t* fields, size_t n, const void* item,
+                         wireless_keyset_t keys) {
+    const char* base = (const char*)item;
+    cbor_put_map(w, n);
+    for (size_t i = 0; i < n; ++i) {
+        const wireless_field_t* f = &fields[i];
+        const char* key = field_key(f, keys);
+        cbor_put_text(w, key, strlen(key));
+        switch (f->type) {
+            case WFIELD_INT:    cbor_put_int(w, *(const int*)(base + f->offset)); break;
+            case WFIELD_BOOL:   cbor_put_bool(w, *(const bool*)(base + f->offset)); break;
+            case WFIELD_STRING: cbor_put_text(w, base + f->offset, strnlen(base + f->offset, f->size)); break;
+        }
+    }
+}
+
+void wireless_cfg_to_cbor(cbor_writer_t* w, const bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys) {
+    cbor_put_map(w, (size_t)__builtin_popcount(sections & WIRELESS_SECTION_ALL));
+    if (sections & WIRELESS_SECTION_RADIO) {
+        cbor_put_text(w, "radio", 5);
+        cbor_put_array(w, (size_t)cfg->radio_count);
+        for (int i = 0; i < cfg->radio_count; ++i)
+            item_to_cbor(w, radio_fields, NUM_FIELDS(radio_fields), &cfg->radio[i], keys);
+    }
+    if (sections & WIRELESS_SECTION_SSID) {
+        size_t count = 0;
+        for (int i = 0; i < cfg->ssid_count; ++i)
+            count += cfg->ssid[i].ssid[0] != '\0';
+        cbor_put_text(w, "ssid", 4);
+        cbor_put_array(w, count);
+        for (int i = 0; i < cfg->ssid_count; ++i) {
+            // Empty entries are skipped, as in wireless_cfg_to_json()
+            if (cfg->ssid[i].ssid[0] != '\0')
+                item_to_cbor(w, ssid_fields, NUM_FIELDS(ssid_fields), &cfg->ssid[i], keys);
+        }
+    }
+}
+
+static bool field_from_cbor(const wireless_field_t* f, cbor_reader_t* r, char* base) {
+    switch (f->type) {
+        case WFIELD_INT: {
+            int64_t v;
+            if (cbor_peek(r) != CBOR_UINT && cbor_peek(r) != CBOR_NINT)
+                break;
+            if (!cbor_get_int(r, &v) || v < f->min || v > f->max) {
+                BCML_LOG_WARN("wireless_cfg_from_cbor: invalid %s value\n", f->key);
+                return false;
+            }
+            *(int*)(base + f->offset) = (int)v;
+            return true;
+        }
+        case WFIELD_BOOL:
+            if (cbor_get_bool(r, (bool*)(base + f->offset)))
+                return true;
+            break;
+        case WFIELD_STRING: {
+            const char* s;
+            size_t len;
+            if (cbor_peek(r) != CBOR_TEXT)
+                break;
+            // No embedded NUL: the struct could not hold the string
+            if (!cbor_get_text(r, &s, &len) || len < (size_t)f->min || len > (size_t)f->max ||
+                memchr(s, '\0', len)) {
+                BCML_LOG_WARN("wireless_cfg_from_cbor: invalid %s string\n", f->key);
+                return false;
+            }
+            memcpy(base + f->offset, s, len);
+            base[f->offset + len] = '\0';
+            return true;
+        }
+    }
+    BCML_LOG_WARN("wireless_cfg_from_cbor: invalid type for field %s\n", f->key);
+    return false;
+}
+
+static bool item_from_cbor(const wireless_field_t* fields, size_t n, cbor_reader_t* r, void* item,
+                           wireless_keyset_t keys) {
+    char* base = (char*)item;
+    uint32_t seen = 0;
+    size_t pairs;
+
+    if (!cbor_get_map(r, &pairs))
+        return false;
+    for (size_t p = 0; p < pairs; ++p) {
+        const char* key;
+        size_t key_len;
+        size_t idx;
+        if (!cbor_get_text(r, &key, &key_len))
+            return false;
+        for (idx = 0; idx < n; ++idx) {
+            if (key_is(key, key_len, field_key(&fields[idx], keys)))
+                break;
+        }
+        if (idx == n || (seen & (1u << idx))) {
+            BCML_LOG_WARN("wireless_cfg_from_cbor: unknown or duplicate field '%.*s'\n", (int)key_len, key);
+            return false;
+        }
+        seen |= 1u << idx;
+        if (!field_from_cbor(&fields[idx], r, base))
+            return false;
+    }
+    if (seen != (1u << n) - 1) {
+        BCML_LOG_WARN("wireless_cfg_from_cbor: missing required fields\n");
+        return false;
+    }
+    return true;
+}
+
+static bool section_from_cbor(cbor_reader_t* r, bcml_wireless_cfg_t* cfg, unsigned section, wireless_keyset_t keys) {
+    bool radio = section == WIRELESS_SECTION_RADIO;
+    const char* name = radio ? "radio" : "ssid";
+    bcml_wireless_limits_t limits;
+    size_t count;
+
+    bcml_wireless_get_limits(&limits);
+    size_t max = (size_t)(radio ? limits.max_radio : limits.max_ssid);
+    if (!cbor_get_array(r, &count)) {
+        BCML_LOG_ERROR("wireless_cfg_from_cbor: invalid '%s' array\n", name);
+        return false;
+    }
+    if (count < 1 || count > max) {
+        BCML_LOG_ERROR("wireless_cfg_from_cbor: '%s' array size out of bounds: %zu\n", name, count);
+        return false;
+    }
+    // Clear first so every entry starts out zeroed
+    if (!section_clear(cfg, section) ||
+        !bcml_wireless_cfg_resize(cfg, radio ? (int)count : cfg->radio_count, radio ? cfg->ssid_count : (int)count))
+        return false;
+    for (size_t i = 0; i < count; ++i) {
+        bool ok = radio ? item_from_cbor(radio_fields, NUM_FIELDS(radio_fields), r, &cfg->radio[i], keys)
+                        : item_from_cbor(ssid_fields, NUM_FIELDS(ssid_fields), r, &cfg->ssid[i], keys);
+        if (!ok) {
+            BCML_LOG_ERROR("wireless_cfg_from_cbor: invalid '%s' item at index %zu\n", name, i);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool wireless_cfg_from_cbor(cbor_reader_t* r, bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys) {
+    unsigned seen = 0;
+    size_t pairs;
+
+    if (!cfg || !cbor_get_map(r, &pairs))
+        return false;
+    for (size_t p = 0; p < pairs; ++p) {
+        const char* key;
+        size_t key_len;
+        unsigned section = 0;
+        if (!cbor_get_text(r, &key, &key_len))
+            return false;
+        if (key_is(key, key_len, "radio"))
+            section = WIRELESS_SECTION_RADIO;
+        else if (key_is(key, key_len, "ssid"))
+            section = WIRELESS_SECTION_SSID;
+        if (!(section & sections) || (seen & section)) {
+            BCML_LOG_WARN("wireless_cfg_from_cbor: unknown or duplicate field '%.*s'\n", (int)key_len, key);
+            return false;
+        }
+        seen |= section;
+        if (!section_from_cbor(r, cfg, section, keys))
+            return false;
+    }
+    unsigned missing = sections & ~seen;
+    if (missing) {
+        BCML_LOG_ERROR("wireless_cfg_from_cbor: missing '%s' array\n",
+                       (missing & WIRELESS_SECTION_RADIO) ? "radio" : "ssid");
+        return false;
+    }
+    return true;
+}
+
+static bool item_equal(const wireless_field_t* fields, size_t n, const void* a, const void* b) {
+    const char* pa = (const char*)a;
+    const char* pb = (const char*)b;
+    for (size_t i = 0; i < n; ++i) {
+        const wireless_field_t* f = &fields[i];
+        switch (f->type) {
+            case WFIELD_INT:
+                if (*(const int*)(pa + f->offset) != *(const int*)(pb + f->offset))
+                    return false;
+                break;
+            case WFIELD_BOOL:
+                if (*(const bool*)(pa + f->offset) != *(const bool*)(pb + f->offset))
+                    return false;
+                break;
+            case WFIELD_STRING:
+                if (strncmp(pa + f->offset, pb + f->offset, f->size) != 0)
+                    return false;
+                break;
+        }
+    }
+    return true;
+}
+
+bool wireless_item_equal(unsigned section, const void* a, const void* b) {
+    if (section == WIRELESS_SECTION_RADIO)
+        return item_equal(radio_fields, NUM_FIELDS(radio_fields), a, b);
+    return item_equal(ssid_fields, NUM_FIELDS(ssid_fields), a, b);
+}
+
+bool wireless_cfg_equal(const bcml_wireless_cfg_t* a, const bcml_wireless_cfg_t* b) {
+    if (a == b)
+        return true;
+    if (!a || !b || a->radio_count != b->radio_count || a->ssid_count != b->ssid_count)
+        return false;
+    for (int i = 0; i < a->radio_count; ++i) {
+        if (!item_equal(radio_fields, NUM_FIELDS(radio_fields), &a->radio[i], &b->radio[i]))
+            return false;
+    }
+    for (int i = 0; i < a->ssid_count; ++i) {
+        if (!item_equal(ssid_fields, NUM_FIELDS(ssid_fields), &a->ssid[i], &b->ssid[i]))
+            return false;
+    }
+    return true;
+}
+
+// FNV-1a, 64 bit
+#define FNV64_OFFSET 0xcbf29ce484222325ULL
+#define FNV64_PRIME  0x100000001b3ULL
+
+static uint64_t fnv64(uint64_t h, const void* data, size_t len) {
+    const unsigned char* p = (const unsigned char*)data;
+    for (size_t i = 0; i < len; ++i) {
+        h ^= p[i];
+        h *= FNV64_PRIME;
+    }
+    return h;
+}
+
+static uint64_t item_hash(uint64_t h, const wireless_field_t* fields, size_t n, const void* item) {
+    const char* base = (const char*)item;
+    for (size_t i = 0; i < n; ++i) {
+        const wireless_field_t* f = &fields[i];
+        switch (f->type) {
+            case WFIELD_INT:
+                h = fnv64(h, base + f->offset, sizeof(int));
+                break;
+            case WFIELD_BOOL: {
+                unsigned char b = *(const bool*)(base + f->offset) ? 1 : 0;
+                h = fnv64(h, &b, 1);
+                break;
+            }
+            case WFIELD_STRING:
+                // Hash the terminator too so adjacent strings cannot alias
+                h = fnv64(h, base + f->offset, strnlen(base + f->offset, f->size));
+                h = fnv64(h, "", 1);
+                break;
+        }
+    }
+    return h;
+}
+
+uint64_t wireless_section_hash(const bcml_wireless_cfg_t* cfg, unsigned section) {
+    uint64_t h = FNV64_OFFSET;
+    if (!cfg)
+        return h;
+    if (section & WIRELESS_SECTION_RADIO) {
+        for (int i = 0; i < cfg->radio_count; ++i)
+            h = item_hash(h, radio_fields, NUM_FIELDS(radio_fields), &cfg->radio[i]);
+    }
+    if (section & WIRELESS_SECTION_SSID) {
+        for (int i = 0; i < cfg->ssid_count; ++i) {
+            // Empty entries are never sent, so they do not contribute
+            if (cfg->ssid[i].ssid[0] == '\0')
+                continue;
+            h = item_hash(h, ssid_fields, NUM_FIELDS(ssid_fields), &cfg->ssid[i]);
+        }
+    }
+    return h;
+}
+
+// ---- Compact packing ----
+// Item layout: one byte of flags (WFIELD_BOOL fields in table order, bit 0 first),
+// then the other fields in table order: WFIELD_INT as a zigzag varint,
+// WFIELD_STRING as a length byte followed by the bytes (no terminator).
+// Only minimal encodings are accepted when unpacking, so packed bytes are canonical.
+
+static size_t item_pack(const wireless_field_t* fields, size_t n, const void* item, uint8_t* out) {
+    const char* base = (const char*)item;
+    uint8_t flags = 0;
+    unsigned bit = 0;
+    size_t len = 1;
+    for (size_t i = 0; i < n; ++i) {
+        const wireless_field_t* f = &fields[i];
+        switch (f->type) {
+            case WFIELD_BOOL:
+                if (*(const bool*)(base + f->offset))
+                    flags |= (uint8_t)(1u << bit);
+                ++bit;
+                break;
+            case WFIELD_INT: {
+                int v = *(const int*)(base + f->offset);
+                uint32_t z = ((uint32_t)v << 1) ^ (uint32_t)(v >> 31);
+                while (z >= 0x80) {
+                    out[len++] = (uint8_t)(z | 0x80);
+                    z >>= 7;
+                }
+                out[len++] = (uint8_t)z;
+                break;
+            }
+            case WFIELD_STRING: {
+                size_t sl = strnlen(base + f->offset, f->size - 1);
+                out[len++] = (uint8_t)sl;
+                memcpy(out + len, base + f->offset, sl);
+                len += sl;
+                break;
+            }
+        }
+    }
+    out[0] = flags;
+    return len;
+}
+
+static size_t item_unpack(const wireless_field_t* fields, size_t n, const uint8_t* in, size_t avail, void* item) {
+    char* base = (char*)item;
+    unsigned bit = 0;
+    size_t pos = 1;
+    if (avail < 1)
+        return 0;
+    for (size_t i = 0; i < n; ++i) {
+        const wireless_field_t* f = &fields[i];
+        switch (f->type) {
+            case WFIELD_BOOL:
+                *(bool*)(base + f->offset) = (in[0] >> bit) & 1;
+                ++bit;
+                break;
+            case WFIELD_INT: {
+                uint32_t z = 0;
+                for (unsigned shift = 0;; shift += 7) {
+                    if (pos >= avail || shift > 28)
+                        return 0;
+                    uint8_t b = in[pos++];
+                    if (shift == 28 && b > 0x0f)
+                        return 0;
+                    z |= (uint32_t)(b & 0x7f) << shift;
+                    if (!(b & 0x80)) {
+                        if (b == 0 && shift > 0)
+                            return 0;   // Overlong
+                        break;
+                    }
+                }
+                *(int*)(base + f->offset) = (int)((z >> 1) ^ (0u - (z & 1)));
+                break;
+            }
+            case WFIELD_STRING: {
+                if (pos >= avail)
+                    return 0;
+                size_t sl = in[pos++];
+                if (sl > f->size - 1 || sl > avail - pos || memchr(in + pos, '\0', sl))
+                    return 0;
+                memcpy(base + f->offset, in + pos, sl);
+                memset(base + f->offset + sl, 0, f->size - sl);
+                pos += sl;
+                break;
+            }
+        }
+    }
+    if (in[0] >> bit)
+        return 0;   // Unknown flag bits
+    return pos;
+}
+
+size_t wireless_item_pack(unsigned section, const void* item, uint8_t* out) {
+    if (section == WIRELESS_SECTION_RADIO)
+        return item_pack(radio_fields, NUM_FIELDS(radio_fields), item, out);
+    return item_pack(ssid_fields, NUM_FIELDS(ssid_fields), item, out);
+}
+
+size_t wireless_item_unpack(unsigned section, const uint8_t* in, size_t len, void* item) {
+    if (section == WIRELESS_SECTION_RADIO)
+        return item_unpack(radio_fields, NUM_FIELDS(radio_fields), in, len, item);
+    return item_unpack(ssid_fields, NUM_FIELDS(ssid_fields), in, len, item);
+}
+
+// FNV-1a over (section, index, bytes), then a 64-bit finalizer so that
+// per-entry hashes mix well when summed
+uint64_t wireless_item_hash(unsigned section, int index, const uint8_t* p, size_t len) {
+    size_t i = 0;
+    while (i < len && p[i] == 0)
+        ++i;
+    if (i == len)
+        return 0;   // Zeroed entry
+
+    uint64_t h = 0xcbf29ce484222325ULL;
+    const uint8_t tag[2] = { (uint8_t)section, (uint8_t)index };
+    for (i = 0; i < sizeof(tag); ++i)
+        h = (h ^ tag[i]) * 0x100000001b3ULL;
+    for (i = 0; i < len; ++i)
+        h = (h ^ p[i]) * 0x100000001b3ULL;
+
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint64_t wireless_count_hash(int nradio, int nssid) {
+    uint64_t h = ((uint64_t)nradio << 32 | (uint64_t)nssid) * 0x9e3779b97f4a7c15ULL;
+    return h ^ (h >> 29);
+}
+
+// ---- Deltas ----
+
+static void put_le32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        p[i] = (uint8_t)(v >> (8 * i));
+}
+
+static uint32_t get_le32(const uint8_t* p) {
+    return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16 | (uint32_t)p[3] << 24;
+}
+
+// Pack the entries of one section that differ from base; returns bytes written
+static size_t delta_section(unsigned section, const void* base, int base_count,
+                            const void* items, int count, uint32_t* mask, uint8_t* out) {
+    size_t item_size = section == WIRELESS_SECTION_RADIO ? sizeof(bcml_wireless_radio_t)
+                                                         : sizeof(bcml_wireless_ssid_t);
+    uint8_t old[WIRELESS_SSID_PACK_MAX];
+    size_t len = 0;
+    *mask = 0;
+    for (int i = 0; i < count; ++i) {
+        size_t n = wireless_item_pack(section, (const char*)items + (size_t)i * item_size, out + len);
+        if (i < base_count) {
+            size_t m = wireless_item_pack(section, (const char*)base + (size_t)i * item_size, old);
+            if (m == n && memcmp(old, out + len, n) == 0)
+                continue;
+        }
+        *mask |= 1u << i;
+        len += n;
+    }
+    return len;
+}
+
+size_t wireless_delta_encode(const bcml_wireless_cfg_t* base, const bcml_wireless_cfg_t* cfg, uint8_t* out) {
+    uint32_t radios, ssids;
+    if (!cfg || !out || cfg->radio_count < 0 || cfg->radio_count > BCML_RADIO_LIMIT ||
+        cfg->ssid_count < 0 || cfg->ssid_count > BCML_SSID_LIMIT)
+        return 0;
+
+    size_t len = 10;
+    len += delta_section(WIRELESS_SECTION_RADIO, base ? base->radio : NULL, base ? base->radio_count : 0,
+                         cfg->radio, cfg->radio_count, &radios, out + len);
+    len += delta_section(WIRELESS_SECTION_SSID, base ? base->ssid : NULL, base ? base->ssid_count : 0,
+                         cfg->ssid, cfg->ssid_count, &ssids, out + len);
+    out[0] = (uint8_t)cfg->radio_count;
+    out[1] = (uint8_t)cfg->ssid_count;
+    put_le32(out + 2, radios);
+    put_le32(out + 6, ssids);
+    return len;
+}
+
+bool wireless_delta_apply(bcml_wireless_cfg_t* cfg, const uint8_t* in, size_t len) {
+    if (!cfg || !in || len < 10)
+        return false;
+    int nr = in[0], ns = in[1];
+    uint32_t radios = get_le32(in + 2), ssids = get_le32(in + 6);
+    if (nr > BCML_RADIO_LIMIT || ns > BCML_SSID_LIMIT ||
+        (nr < 32 && (radios >> nr)) || (ns < 32 && (ssids >> ns)))
+        return false;
+    if (!bcml_wireless_cfg_resize(cfg, nr, ns))
+        return false;
+
+    size_t off = 10;
+    for (int i = 0; i < nr; ++i) {
+        if (!(radios & (1u << i)))
+            continue;
+        size_t n = wireless_item_unpack(WIRELESS_SECTION_RADIO, in + off, len - off, &cfg->radio[i]);
+        if (!n)
+            return false;
+        off += n;
+    }
+    for (int i = 0; i < ns; ++i) {
+        if (!(ssids & (1u << i)))
+            continue;
+        size_t n = wireless_item_unpack(WIRELESS_SECTION_SSID, in + off, len - off, &cfg->ssid[i]);
+        if (!n)
+            return false;
+        off += n;
+    }
+    return off == len;
+}
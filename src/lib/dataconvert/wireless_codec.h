@@ -0,0 +1,131 @@
+#ifndef WIRELESS_CODEC_H
+#define WIRELESS_CODEC_H
+
+#include "bcml_types.h"
+#include "json_scan.h"
+#include "cbor.h"
+#include <stdbool.h>
+#include <stdint.h>
+#include <cjson/cJSON.h>
+
+// Table-driven conversion between bcml_wireless_* structures and cJSON objects
+// (or, for decoding, the json_scan structural index).
+// Shared by the northbound parser/exporter and the southbound backends so every
+// field is described exactly once.
+
+// Key naming used on the wire
+typedef enum {
+    WIRELESS_KEYS_NB,   // Northbound schema keys (e.g. "password_onscreen")
+    WIRELESS_KEYS_REST  // REST backend keys (e.g. "password-onscreen")
+} wireless_keyset_t;
+
+// Sections of a wireless config, usable as a bit mask
+#define WIRELESS_SECTION_RADIO  (1u << 0)
+#define WIRELESS_SECTION_SSID   (1u << 1)
+#define WIRELESS_SECTION_ALL    (WIRELESS_SECTION_RADIO | WIRELESS_SECTION_SSID)
+
+cJSON* wireless_radio_to_json(const bcml_wireless_radio_t* radio, wireless_keyset_t keys);
+cJSON* wireless_ssid_to_json(const bcml_wireless_ssid_t* ssid, wireless_keyset_t keys);
+
+// Missing or mistyped fields are set to 0/false/"" (strings are always NUL terminated).
+void wireless_radio_from_json(const cJSON* obj, bcml_wireless_radio_t* radio, wireless_keyset_t keys);
+void wireless_ssid_from_json(const cJSON* obj, bcml_wireless_ssid_t* ssid, wireless_keyset_t keys);
+
+/**
+ * @brief Build {"radio":[...],"ssid":[...]} for the requested sections.
+ *        All radios are emitted; SSID entries with an empty name are skipped.
+ * @param cfg      Wireless config.
+ * @param sections WIRELESS_SECTION_* mask.
+ * @param keys     Key naming to use.
+ * @return New cJSON object (caller deletes) or NULL on failure.
+ */
+cJSON* wireless_cfg_to_json(const bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys);
+
+/**
+ * @brief Fill the requested sections of cfg from a {"radio":[...],"ssid":[...]} object.
+ *        Each section is resized to its array length, capped at the runtime limit
+ *        (bcml_wireless.h); a missing array empties the section.
+ */
+void wireless_cfg_from_json(const cJSON* obj, bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys);
+
+/**
+ * @brief Same as wireless_cfg_from_json(), reading from a json_scan_t cursor positioned
+ *        on the object. Consumes the whole object.
+ * @param strict Enforce the schema instead of defaulting: exactly the requested arrays,
+ *               1..limit entries, every field present once with the right type and range.
+ * @return false on malformed JSON, or on a schema violation when strict.
+ */
+bool wireless_cfg_from_scan(json_cur_t* c, bcml_wireless_cfg_t* cfg, unsigned sections,
+                            wireless_keyset_t keys, bool strict);
+
+/**
+ * @brief Write {"radio":[...],"ssid":[...]} as a CBOR map, with the keys and
+ *        value types of the JSON form. SSID entries with an empty name are skipped.
+ *        Check cbor_writer_ok() afterwards.
+ */
+void wireless_cfg_to_cbor(cbor_writer_t* w, const bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys);
+
+/**
+ * @brief Decode a CBOR map written by wireless_cfg_to_cbor(), enforcing the schema
+ *        like wireless_cfg_from_scan() strict: exactly the requested arrays, 1..limit
+ *        entries, every field present once with the right type and range. Integers
+ *        must be CBOR integers (no floats); strings valid UTF-8 without NUL.
+ * @return false on malformed CBOR or a schema violation (cfg partly decoded).
+ */
+bool wireless_cfg_from_cbor(cbor_reader_t* r, bcml_wireless_cfg_t* cfg, unsigned sections, wireless_keyset_t keys);
+
+// Field-by-field equality (ignores padding and bytes after string terminators)
+bool wireless_cfg_equal(const bcml_wireless_cfg_t* a, const bcml_wireless_cfg_t* b);
+
+// Same, for one radio (section WIRELESS_SECTION_RADIO) or SSID (WIRELESS_SECTION_SSID)
+bool wireless_item_equal(unsigned section, const void* a, const void* b);
+
+// 64-bit content hash of one section (field values only, independent of padding/unused bytes)
+uint64_t wireless_section_hash(const bcml_wireless_cfg_t* cfg, unsigned section);
+
+// Upper bounds of wireless_item_pack() output
+#define WIRELESS_RADIO_PACK_MAX (1 + 5 * 5)
+#define WIRELESS_SSID_PACK_MAX  (1 + 5 + (1 + BCML_SSID_MAX_LEN) + (1 + BCML_PASSWORD_MAX_LEN))
+
+/**
+ * @brief Canonical compact encoding of one radio or SSID (see bcml_compact.h):
+ *        equal field values give identical bytes, and a zeroed item packs to all zero bytes.
+ * @param section WIRELESS_SECTION_RADIO or WIRELESS_SECTION_SSID.
+ * @return Bytes written (at most WIRELESS_*_PACK_MAX).
+ */
+size_t wireless_item_pack(unsigned section, const void* item, uint8_t* out);
+
+// Inverse of wireless_item_pack(); returns bytes consumed, 0 if not a canonical encoding
+size_t wireless_item_unpack(unsigned section, const uint8_t* in, size_t len, void* item);
+
+// Content hash terms (bcml_compact.h): a config hashes to wireless_count_hash() of
+// its counts plus the sum of wireless_item_hash() over its packed entries.
+// A zeroed entry hashes to 0.
+uint64_t wireless_item_hash(unsigned section, int index, const uint8_t* p, size_t len);
+uint64_t wireless_count_hash(int nradio, int nssid);
+
+// ---- Deltas ----
+// Delta layout: radio count, SSID count (one byte each), changed-radio mask,
+// changed-SSID mask (32-bit little endian), then the changed entries packed
+// with wireless_item_pack(), radios first, in index order.
+
+#define WIRELESS_DELTA_MAX (2 + 4 + 4 + BCML_RADIO_LIMIT * WIRELESS_RADIO_PACK_MAX + \
+                            BCML_SSID_LIMIT * WIRELESS_SSID_PACK_MAX)
+
+/**
+ * @brief Encode cfg as a delta against base: only entries that differ (or that
+ *        base does not have) are stored.
+ * @param base  Previous config, or NULL for a self-contained delta holding every entry.
+ * @param out   At least WIRELESS_DELTA_MAX bytes.
+ * @return Bytes written, 0 if cfg has out-of-range counts.
+ */
+size_t wireless_delta_encode(const bcml_wireless_cfg_t* base, const bcml_wireless_cfg_t* cfg, uint8_t* out);
+
+/**
+ * @brief Apply a delta to the config it was encoded against (any config for a
+ *        self-contained one).
+ * @return false on a malformed delta; cfg is then unspecified.
+ */
+bool wireless_delta_apply(bcml_wireless_cfg_t* cfg, const uint8_t* in, size_t len);
+
+#endif // WIRELESS_CODEC_H
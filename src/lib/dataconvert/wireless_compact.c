@@ -0,0 +1,234 @@
+#include "bcml_compact.h"
+#include "wireless_codec.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+// data[] holds nradio packed radios followed by nssid packed SSIDs
+// (wireless_item_pack() encoding). The counts are part of the content:
+// the hash is wireless_count_hash() plus the sum of wireless_item_hash().
+struct bcml_wireless_compact {
+    uint64_t hash;
+    uint16_t len;
+    uint8_t nradio;
+    uint8_t nssid;
+    uint8_t data[];
+};
+
+typedef union {
+    bcml_wireless_radio_t radio;
+    bcml_wireless_ssid_t ssid;
+} wireless_entry_t;
+
+static int section_max(unsigned section) {
+    return section == WIRELESS_SECTION_RADIO ? BCML_RADIO_LIMIT : BCML_SSID_LIMIT;
+}
+
+static int section_count(const bcml_wireless_compact_t* c, unsigned section) {
+    return section == WIRELESS_SECTION_RADIO ? c->nradio : c->nssid;
+}
+
+// Packed length of a zeroed entry (all zero bytes)
+static size_t zero_len(unsigned section) {
+    wireless_entry_t e;
+    uint8_t buf[WIRELESS_SSID_PACK_MAX];
+    memset(&e, 0, sizeof(e));
+    return wireless_item_pack(section, &e, buf);
+}
+
+// Offset of entry `index` of a section (index == count gives the section end)
+static size_t entry_offset(const bcml_wireless_compact_t* c, unsigned section, int index) {
+    wireless_entry_t scratch;
+    size_t off = 0;
+    if (section == WIRELESS_SECTION_SSID) {
+        for (int i = 0; i < c->nradio; ++i)
+            off += wireless_item_unpack(WIRELESS_SECTION_RADIO, c->data + off, c->len - off, &scratch);
+    }
+    for (int i = 0; i < index; ++i)
+        off += wireless_item_unpack(section, c->data + off, c->len - off, &scratch);
+    return off;
+}
+
+static size_t entry_len(const bcml_wireless_compact_t* c, unsigned section, size_t off) {
+    wireless_entry_t scratch;
+    return wireless_item_unpack(section, c->data + off, c->len - off, &scratch);
+}
+
+bcml_wireless_compact_t* bcml_wireless_compact_encode(const bcml_wireless_cfg_t* cfg) {
+    uint8_t buf[BCML_RADIO_LIMIT * WIRELESS_RADIO_PACK_MAX + BCML_SSID_LIMIT * WIRELESS_SSID_PACK_MAX];
+    size_t len = 0;
+
+    if (!cfg || cfg->radio_count < 0 || cfg->radio_count > BCML_RADIO_LIMIT ||
+        cfg->ssid_count < 0 || cfg->ssid_count > BCML_SSID_LIMIT)
+        return NULL;
+    uint64_t hash = wireless_count_hash(cfg->radio_count, cfg->ssid_count);
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        size_t n = wireless_item_pack(WIRELESS_SECTION_RADIO, &cfg->radio[i], buf + len);
+        hash += wireless_item_hash(WIRELESS_SECTION_RADIO, i, buf + len, n);
+        len += n;
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        size_t n = wireless_item_pack(WIRELESS_SECTION_SSID, &cfg->ssid[i], buf + len);
+        hash += wireless_item_hash(WIRELESS_SECTION_SSID, i, buf + len, n);
+        len += n;
+    }
+
+    bcml_wireless_compact_t* c = malloc(sizeof(*c) + len);
+    if (!c)
+        return NULL;
+    c->hash = hash;
+    c->len = (uint16_t)len;
+    c->nradio = (uint8_t)cfg->radio_count;
+    c->nssid = (uint8_t)cfg->ssid_count;
+    memcpy(c->data, buf, len);
+    return c;
+}
+
+bool bcml_wireless_compact_decode(const bcml_wireless_compact_t* c, bcml_wireless_cfg_t* cfg) {
+    size_t off = 0;
+    if (!c || !cfg)
+        return false;
+    if (!bcml_wireless_cfg_resize(cfg, 0, 0) || !bcml_wireless_cfg_resize(cfg, c->nradio, c->nssid))
+        return false;
+    for (int i = 0; i < c->nradio; ++i) {
+        size_t n = wireless_item_unpack(WIRELESS_SECTION_RADIO, c->data + off, c->len - off, &cfg->radio[i]);
+        if (!n)
+            return false;
+        off += n;
+    }
+    for (int i = 0; i < c->nssid; ++i) {
+        size_t n = wireless_item_unpack(WIRELESS_SECTION_SSID, c->data + off, c->len - off, &cfg->ssid[i]);
+        if (!n)
+            return false;
+        off += n;
+    }
+    return off == c->len;
+}
+
+void bcml_wireless_compact_free(bcml_wireless_compact_t* c) {
+    free(c);
+}
+
+uint64_t bcml_wireless_compact_hash(const bcml_wireless_compact_t* c) {
+    return c ? c->hash : 0;
+}
+
+size_t bcml_wireless_compact_size(const bcml_wireless_compact_t* c) {
+    return c ? sizeof(*c) + c->len : 0;
+}
+
+uint64_t bcml_wireless_cfg_hash(const bcml_wireless_cfg_t* cfg) {
+    uint8_t buf[WIRELESS_SSID_PACK_MAX];
+    if (!cfg)
+        return 0;
+    uint64_t hash = wireless_count_hash(cfg->radio_count, cfg->ssid_count);
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        size_t n = wireless_item_pack(WIRELESS_SECTION_RADIO, &cfg->radio[i], buf);
+        hash += wireless_item_hash(WIRELESS_SECTION_RADIO, i, buf, n);
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        size_t n = wireless_item_pack(WIRELESS_SECTION_SSID, &cfg->ssid[i], buf);
+        hash += wireless_item_hash(WIRELESS_SECTION_SSID, i, buf, n);
+    }
+    return hash;
+}
+
+// Replace entry `index`, or append it (zeroed entries fill any gap)
+static bool set_entry(bcml_wireless_compact_t** pc, unsigned section, int index, const void* item) {
+    bcml_wireless_compact_t* c = pc ? *pc : NULL;
+    uint8_t nb[WIRELESS_SSID_PACK_MAX];
+    if (!c || !item || index < 0 || index >= section_max(section))
+        return false;
+
+    size_t nlen = wireless_item_pack(section, item, nb);
+    uint64_t new_h = wireless_item_hash(section, index, nb, nlen);
+    int count = section_count(c, section);
+    size_t off, old_len = 0, pad = 0;
+    uint64_t old_h = 0;
+
+    if (index < count) {
+        off = entry_offset(c, section, index);
+        old_len = entry_len(c, section, off);
+        old_h = wireless_item_hash(section, index, c->data + off, old_len);
+        if (old_len == nlen && memcmp(c->data + off, nb, nlen) == 0)
+            return true;
+    } else {
+        off = entry_offset(c, section, count);
+        pad = (size_t)(index - count) * zero_len(section);
+        count = index + 1;
+    }
+
+    size_t tail = c->len - (off + old_len);
+    size_t len = off + pad + nlen + tail;
+    bcml_wireless_compact_t* n = malloc(sizeof(*n) + len);
+    if (!n)
+        return false;
+    memcpy(n->data, c->data, off);
+    memset(n->data + off, 0, pad);
+    memcpy(n->data + off + pad, nb, nlen);
+    memcpy(n->data + off + pad + nlen, c->data + off + old_len, tail);
+    n->len = (uint16_t)len;
+    n->nradio = section == WIRELESS_SECTION_RADIO ? (uint8_t)count : c->nradio;
+    n->nssid = section == WIRELESS_SECTION_SSID ? (uint8_t)count : c->nssid;
+    n->hash = c->hash - wireless_count_hash(c->nradio, c->nssid) + wireless_count_hash(n->nradio, n->nssid) - old_h + new_h;
+    free(c);
+    *pc = n;
+    return true;
+}
+
+bool bcml_wireless_compact_set_radio(bcml_wireless_compact_t** c, int index, const bcml_wireless_radio_t* radio) {
+    return set_entry(c, WIRELESS_SECTION_RADIO, index, radio);
+}
+
+bool bcml_wireless_compact_set_ssid(bcml_wireless_compact_t** c, int index, const bcml_wireless_ssid_t* ssid) {
+    return set_entry(c, WIRELESS_SECTION_SSID, index, ssid);
+}
+
+bool bcml_wireless_compact_equal(const bcml_wireless_compact_t* a, const bcml_wireless_compact_t* b) {
+    if (a == b)
+        return true;
+    if (!a || !b || a->hash != b->hash || a->len != b->len ||
+        a->nradio != b->nradio || a->nssid != b->nssid)
+        return false;
+    return memcmp(a->data, b->data, a->len) == 0;
+}
+
+// Changed-entry mask of one section; *ao/*bo advance past it.
+// An entry that exists on one side only is changed.
+static uint32_t section_diff(const bcml_wireless_compact_t* a, size_t* ao,
+                             const bcml_wireless_compact_t* b, size_t* bo, unsigned section) {
+    int na = section_count(a, section), nb = section_count(b, section);
+    uint32_t mask = 0;
+    for (int i = 0; i < na || i < nb; ++i) {
+        size_t la = 0, lb = 0;
+        if (i < na) {
+            la = entry_len(a, section, *ao);
+            *ao += la;
+        }
+        if (i < nb) {
+            lb = entry_len(b, section, *bo);
+            *bo += lb;
+        }
+        if (i >= na || i >= nb || la != lb || memcmp(a->data + *ao - la, b->data + *bo - lb, la) != 0)
+            mask |= 1u << i;
+    }
+    return mask;
+}
+
+bool bcml_wireless_compact_diff(const bcml_wireless_compact_t* a, const bcml_wireless_compact_t* b,
+                                bcml_wireless_diff_t* diff) {
+    bcml_wireless_diff_t d = { 0, 0 };
+    if (!a || !b) {
+        BCML_LOG_WARN("bcml_wireless_compact_diff: NULL input\n");
+        return a != b;
+    }
+    if (!bcml_wireless_compact_equal(a, b)) {
+        size_t ao = 0, bo = 0;
+        d.radios = section_diff(a, &ao, b, &bo, WIRELESS_SECTION_RADIO);
+        d.ssids = section_diff(a, &ao, b, &bo, WIRELESS_SECTION_SSID);
+    }
+    if (diff)
+        *diff = d;
+    return d.radios || d.ssids;
+}
@@ -0,0 +1,610 @@
+#include "bcml_store.h"
+#include "wireless_codec.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <stdlib.h>
+#include <string.h>
+
+// Items and configs live in intern tables: an id-indexed array of entries
+// plus an open-addressing index (linear probing, backward-shift deletion)
+// from content hash to id. Id 0 is never handed out, so it means "none".
+// An item is referenced once per slot of every config that holds it; a
+// config is referenced once per device.
+
+#define STORE_ITEMS_MAX     (BCML_RADIO_LIMIT + BCML_SSID_LIMIT)
+#define INDEX_MIN_CAP       64
+
+typedef struct {
+    uint32_t refs;
+    uint8_t section;            // WIRELESS_SECTION_RADIO/SSID
+    uint8_t len;
+    uint8_t data[];             // wireless_item_pack() bytes
+} store_item_t;
+
+typedef struct {
+    uint64_t hash;              // Content hash, as bcml_wireless_cfg_hash()
+    uint32_t devices;
+    uint8_t nradio;
+    uint8_t nssid;
+    uint32_t item[];            // nradio radio ids, then nssid SSID ids
+} store_cfg_t;
+
+typedef struct {
+    uint64_t hash;
+    uint32_t id;                // 0: empty slot
+} index_slot_t;
+
+typedef struct {
+    void** entry;               // By id
+    uint64_t* hash;             // Index key of each entry, by id
+    uint32_t n;                 // Ids handed out, plus id 0
+    uint32_t cap;
+    uint32_t* free_ids;
+    uint32_t nfree;
+    index_slot_t* slots;
+    size_t slot_cap;            // Power of two
+    size_t live;
+} intern_table_t;
+
+struct bcml_wireless_store {
+    intern_table_t items;
+    intern_table_t configs;
+    uint32_t* device;           // Config id by device number
+    unsigned ndevice;
+    unsigned used;              // Devices with a config
+    size_t radios;
+    size_t ssids;
+    size_t entry_bytes;         // Items and configs
+};
+
+// Lookup keys
+typedef struct {
+    uint8_t section;
+    uint8_t len;
+    const uint8_t* data;
+} item_key_t;
+
+typedef struct {
+    int nradio;
+    int nssid;
+    const uint32_t* item;
+} cfg_key_t;
+
+// ---- Intern tables ----
+
+static bool item_matches(const void* entry, const void* key) {
+    const store_item_t* it = entry;
+    const item_key_t* k = key;
+    return it->section == k->section && it->len == k->len && memcmp(it->data, k->data, k->len) == 0;
+}
+
+static bool cfg_matches(const void* entry, const void* key) {
+    const store_cfg_t* c = entry;
+    const cfg_key_t* k = key;
+    return c->nradio == k->nradio && c->nssid == k->nssid &&
+           memcmp(c->item, k->item, (size_t)(k->nradio + k->nssid) * sizeof(uint32_t)) == 0;
+}
+
+static uint32_t table_find(const intern_table_t* t, uint64_t hash,
+                           bool (*matches)(const void* entry, const void* key), const void* key) {
+    if (!t->slot_cap)
+        return 0;
+    size_t mask = t->slot_cap - 1;
+    for (size_t i = (size_t)hash & mask; t->slots[i].id; i = (i + 1) & mask) {
+        if (t->slots[i].hash == hash && matches(t->entry[t->slots[i].id], key))
+            return t->slots[i].id;
+    }
+    return 0;
+}
+
+static void index_insert(index_slot_t* slots, size_t cap, uint64_t hash, uint32_t id) {
+    size_t i = (size_t)hash & (cap - 1);
+    while (slots[i].id)
+        i = (i + 1) & (cap - 1);
+    slots[i].hash = hash;
+    slots[i].id = id;
+}
+
+// Index at most 3/4 full
+static bool index_reserve(intern_table_t* t) {
+    if ((t->live + 1) * 4 <= t->slot_cap * 3)
+        return true;
+    size_t cap = t->slot_cap ? 2 * t->slot_cap : INDEX_MIN_CAP;
+    index_slot_t* slots = calloc(cap, sizeof(*slots));
+    if (!slots)
+        return false;
+    for (size_t i = 0; i < t->slot_cap; ++i) {
+        if (t->slots[i].id)
+            index_insert(slots, cap, t->slots[i].hash, t->slots[i].id);
+    }
+    free(t->slots);
+    t->slots = slots;
+    t->slot_cap = cap;
+    return true;
+}
+
+// Add an entry (owned by the table from now on); 0 on allocation failure
+static uint32_t table_add(intern_table_t* t, uint64_t hash, void* entry) {
+    if (!index_reserve(t))
+        return 0;
+    uint32_t id;
+    if (t->nfree) {
+        id = t->free_ids[--t->nfree];
+    } else {
+        if (t->n == t->cap) {
+            uint32_t cap = t->cap ? 2 * t->cap : 64;
+            void** e = realloc(t->entry, cap * sizeof(*e));
+            if (!e)
+                return 0;
+            t->entry = e;
+            uint64_t* h = realloc(t->hash, cap * sizeof(*h));
+            if (!h)
+                return 0;
+            t->hash = h;
+            uint32_t* f = realloc(t->free_ids, cap * sizeof(*f));
+            if (!f)
+                return 0;
+            t->free_ids = f;
+            t->cap = cap;
+        }
+        if (t->n == 0)
+            t->entry[t->n++] = NULL;    // Id 0
+        id = t->n++;
+    }
+    t->entry[id] = entry;
+    t->hash[id] = hash;
+    index_insert(t->slots, t->slot_cap, hash, id);
+    t->live++;
+    return id;
+}
+
+// Remove and free an entry; backward shift keeps every probe run unbroken
+static void table_del(intern_table_t* t, uint32_t id) {
+    size_t mask = t->slot_cap - 1;
+    size_t i = (size_t)t->hash[id] & mask;
+    while (t->slots[i].id != id)
+        i = (i + 1) & mask;
+    for (size_t j = i;;) {
+        j = (j + 1) & mask;
+        if (!t->slots[j].id)
+            break;
+        size_t home = (size_t)t->slots[j].hash & mask;
+        // Entries whose home lies in (i, j] stay put
+        if (i <= j ? (i < home && home <= j) : (i < home || home <= j))
+            continue;
+        t->slots[i] = t->slots[j];
+        i = j;
+    }
+    t->slots[i].id = 0;
+
+    free(t->entry[id]);
+    t->entry[id] = NULL;
+    t->free_ids[t->nfree++] = id;
+    t->live--;
+}
+
+static void table_free(intern_table_t* t) {
+    for (uint32_t id = 1; id < t->n; ++id)
+        free(t->entry[id]);
+    free(t->entry);
+    free(t->hash);
+    free(t->free_ids);
+    free(t->slots);
+    memset(t, 0, sizeof(*t));
+}
+
+static size_t table_bytes(const intern_table_t* t) {
+    return t->cap * (sizeof(void*) + sizeof(uint64_t) + sizeof(uint32_t)) + t->slot_cap * sizeof(index_slot_t);
+}
+
+// ---- Items ----
+
+static store_item_t* item_at(const bcml_wireless_store_t* s, uint32_t id) {
+    return s->items.entry[id];
+}
+
+static store_cfg_t* cfg_at(const bcml_wireless_store_t* s, uint32_t id) {
+    return s->configs.entry[id];
+}
+
+// Slot-independent key: the same SSID in any slot of any device is one item
+static uint64_t item_key_hash(const item_key_t* k) {
+    return wireless_item_hash(k->section, 0, k->data, k->len);
+}
+
+static uint32_t item_find(const bcml_wireless_store_t* s, const item_key_t* k) {
+    return table_find(&s->items, item_key_hash(k), item_matches, k);
+}
+
+// Find or add an item; a new one has no references yet. 0 on allocation failure.
+static uint32_t item_intern(bcml_wireless_store_t* s, const item_key_t* k) {
+    uint64_t hash = item_key_hash(k);
+    uint32_t id = table_find(&s->items, hash, item_matches, k);
+    if (id)
+        return id;
+    store_item_t* it = malloc(sizeof(*it) + k->len);
+    if (!it)
+        return 0;
+    it->refs = 0;
+    it->section = k->section;
+    it->len = k->len;
+    memcpy(it->data, k->data, k->len);
+    id = table_add(&s->items, hash, it);
+    if (!id) {
+        free(it);
+        return 0;
+    }
+    s->entry_bytes += sizeof(*it) + k->len;
+    if (k->section == WIRELESS_SECTION_RADIO)
+        s->radios++;
+    else
+        s->ssids++;
+    return id;
+}
+
+static void item_drop(bcml_wireless_store_t* s, uint32_t id) {
+    store_item_t* it = item_at(s, id);
+    s->entry_bytes -= sizeof(*it) + it->len;
+    if (it->section == WIRELESS_SECTION_RADIO)
+        s->radios--;
+    else
+        s->ssids--;
+    table_del(&s->items, id);
+}
+
+// Drop items interned for a config that was not created after all
+static void items_drop_unused(bcml_wireless_store_t* s, const uint32_t* ids, int n) {
+    for (int i = 0; i < n; ++i) {
+        if (ids[i] && s->items.entry[ids[i]] && item_at(s, ids[i])->refs == 0)
+            item_drop(s, ids[i]);
+    }
+}
+
+// Hash term of the item in slot `index` of its section
+static uint64_t item_slot_hash(const bcml_wireless_store_t* s, uint32_t id, int index) {
+    const store_item_t* it = item_at(s, id);
+    return wireless_item_hash(it->section, index, it->data, it->len);
+}
+
+// ---- Configs ----
+
+// Find or add the config made of these items; a new one takes a reference on
+// each and has no devices yet. 0 on allocation failure (unused items dropped).
+static uint32_t cfg_intern(bcml_wireless_store_t* s, int nradio, int nssid, const uint32_t* ids, uint64_t hash) {
+    int n = nradio + nssid;
+    cfg_key_t k = { nradio, nssid, ids };
+    uint32_t id = table_find(&s->configs, hash, cfg_matches, &k);
+    if (id)
+        return id;
+
+    size_t size = sizeof(store_cfg_t) + (size_t)n * sizeof(uint32_t);
+    store_cfg_t* c = malloc(size);
+    if (c) {
+        c->hash = hash;
+        c->devices = 0;
+        c->nradio = (uint8_t)nradio;
+        c->nssid = (uint8_t)nssid;
+        memcpy(c->item, ids, (size_t)n * sizeof(uint32_t));
+        id = table_add(&s->configs, hash, c);
+        if (!id)
+            free(c);
+    }
+    if (!id) {
+        items_drop_unused(s, ids, n);
+        return 0;
+    }
+    for (int i = 0; i < n; ++i)
+        item_at(s, ids[i])->refs++;
+    s->entry_bytes += size;
+    return id;
+}
+
+static void cfg_release(bcml_wireless_store_t* s, uint32_t id) {
+    store_cfg_t* c = cfg_at(s, id);
+    if (--c->devices)
+        return;
+    for (int i = 0; i < c->nradio + c->nssid; ++i) {
+        if (--item_at(s, c->item[i])->refs == 0)
+            item_drop(s, c->item[i]);
+    }
+    s->entry_bytes -= sizeof(*c) + (size_t)(c->nradio + c->nssid) * sizeof(uint32_t);
+    table_del(&s->configs, id);
+}
+
+// ---- Devices ----
+
+static bool device_reserve(bcml_wireless_store_t* s, unsigned device) {
+    if (device < s->ndevice)
+        return true;
+    unsigned n = s->ndevice ? s->ndevice : 64;
+    while (n <= device)
+        n *= 2;
+    uint32_t* d = realloc(s->device, n * sizeof(*d));
+    if (!d)
+        return false;
+    memset(d + s->ndevice, 0, (n - s->ndevice) * sizeof(*d));
+    s->device = d;
+    s->ndevice = n;
+    return true;
+}
+
+static uint32_t device_cfg(const bcml_wireless_store_t* s, unsigned device) {
+    return device < s->ndevice ? s->device[device] : 0;
+}
+
+// Point a (reserved) device at a config, releasing the one it had
+static void device_assign(bcml_wireless_store_t* s, unsigned device, uint32_t id) {
+    uint32_t old = s->device[device];
+    if (old == id)
+        return;     // Same content as before
+    cfg_at(s, id)->devices++;
+    s->device[device] = id;
+    if (old)
+        cfg_release(s, old);
+    else
+        s->used++;
+}
+
+// ---- API ----
+
+bcml_wireless_store_t* bcml_wireless_store_new(void) {
+    return calloc(1, sizeof(bcml_wireless_store_t));
+}
+
+void bcml_wireless_store_free(bcml_wireless_store_t* s) {
+    if (!s)
+        return;
+    table_free(&s->items);
+    table_free(&s->configs);
+    free(s->device);
+    free(s);
+}
+
+bool bcml_wireless_store_put(bcml_wireless_store_t* s, unsigned device, const bcml_wireless_cfg_t* cfg) {
+    uint8_t buf[WIRELESS_SSID_PACK_MAX];
+    uint32_t ids[STORE_ITEMS_MAX];
+
+    if (!s || !cfg || cfg->radio_count < 0 || cfg->radio_count > BCML_RADIO_LIMIT ||
+        cfg->ssid_count < 0 || cfg->ssid_count > BCML_SSID_LIMIT) {
+        BCML_LOG_WARN("bcml_wireless_store_put: bad config for device %u\n", device);
+        return false;
+    }
+    if (!device_reserve(s, device))
+        return false;
+
+    int n = 0;
+    uint64_t hash = wireless_count_hash(cfg->radio_count, cfg->ssid_count);
+    for (int i = 0; i < cfg->radio_count + cfg->ssid_count; ++i) {
+        bool radio = i < cfg->radio_count;
+        int index = radio ? i : i - cfg->radio_count;
+        item_key_t k;
+        k.section = radio ? WIRELESS_SECTION_RADIO : WIRELESS_SECTION_SSID;
+        k.len = (uint8_t)wireless_item_pack(k.section, radio ? (const void*)&cfg->radio[index]
+                                                             : (const void*)&cfg->ssid[index], buf);
+        k.data = buf;
+        ids[n] = item_intern(s, &k);
+        if (!ids[n]) {
+            items_drop_unused(s, ids, n);
+            return false;
+        }
+        hash += wireless_item_hash(k.section, index, buf, k.len);
+        ++n;
+    }
+
+    uint32_t id = cfg_intern(s, cfg->radio_count, cfg->ssid_count, ids, hash);
+    if (!id)
+        return false;
+    device_assign(s, device, id);
+    return true;
+}
+
+static bool set_entry(bcml_wireless_store_t* s, unsigned device, unsigned section, int index, const void* item) {
+    uint8_t buf[WIRELESS_SSID_PACK_MAX];
+    uint32_t ids[STORE_ITEMS_MAX];
+    uint32_t cur = s ? device_cfg(s, device) : 0;
+    if (!cur || !item)
+        return false;
+    const store_cfg_t* c = cfg_at(s, cur);
+    int count = section == WIRELESS_SECTION_RADIO ? c->nradio : c->nssid;
+    if (index < 0 || index >= count)
+        return false;
+
+    int slot = section == WIRELESS_SECTION_RADIO ? index : c->nradio + index;
+    item_key_t k = { (uint8_t)section, 0, buf };
+    k.len = (uint8_t)wireless_item_pack(section, item, buf);
+    uint32_t new_item = item_intern(s, &k);
+    if (!new_item)
+        return false;
+    uint32_t old_item = c->item[slot];
+    if (new_item == old_item)
+        return true;
+
+    int n = c->nradio + c->nssid;
+    memcpy(ids, c->item, (size_t)n * sizeof(uint32_t));
+    ids[slot] = new_item;
+    uint64_t hash = c->hash - item_slot_hash(s, old_item, index) + wireless_item_hash(section, index, buf, k.len);
+    uint32_t id = cfg_intern(s, c->nradio, c->nssid, ids, hash);
+    if (!id)
+        return false;
+    device_assign(s, device, id);
+    return true;
+}
+
+bool bcml_wireless_store_set_radio(bcml_wireless_store_t* s, unsigned device, int index,
+                                   const bcml_wireless_radio_t* radio) {
+    return set_entry(s, device, WIRELESS_SECTION_RADIO, index, radio);
+}
+
+bool bcml_wireless_store_set_ssid(bcml_wireless_store_t* s, unsigned device, int index,
+                                  const bcml_wireless_ssid_t* ssid) {
+    return set_entry(s, device, WIRELESS_SECTION_SSID, index, ssid);
+}
+
+bool bcml_wireless_store_get(const bcml_wireless_store_t* s, unsigned device, bcml_wireless_cfg_t* cfg) {
+    uint32_t id = s ? device_cfg(s, device) : 0;
+    if (!id || !cfg)
+        return false;
+    const store_cfg_t* c = cfg_at(s, id);
+    if (!bcml_wireless_cfg_resize(cfg, 0, 0) || !bcml_wireless_cfg_resize(cfg, c->nradio, c->nssid))
+        return false;
+    for (int i = 0; i < c->nradio + c->nssid; ++i) {
+        const store_item_t* it = item_at(s, c->item[i]);
+        void* dst = i < c->nradio ? (void*)&cfg->radio[i] : (void*)&cfg->ssid[i - c->nradio];
+        if (wireless_item_unpack(it->section, it->data, it->len, dst) != it->len)
+            return false;
+    }
+    return true;
+}
+
+void bcml_wireless_store_remove(bcml_wireless_store_t* s, unsigned device) {
+    uint32_t id = s ? device_cfg(s, device) : 0;
+    if (!id)
+        return;
+    s->device[device] = 0;
+    s->used--;
+    cfg_release(s, id);
+}
+
+uint32_t bcml_wireless_store_config(const bcml_wireless_store_t* s, unsigned device) {
+    return s ? device_cfg(s, device) : 0;
+}
+
+uint64_t bcml_wireless_store_hash(const bcml_wireless_store_t* s, unsigned device) {
+    uint32_t id = s ? device_cfg(s, device) : 0;
+    return id ? cfg_at(s, id)->hash : 0;
+}
+
+bool bcml_wireless_store_equal(const bcml_wireless_store_t* s, unsigned a, unsigned b) {
+    uint32_t id = s ? device_cfg(s, a) : 0;
+    return id && id == device_cfg(s, b);
+}
+
+// Changed entries of a config against the profile's item ids (0: not in the store)
+static bcml_wireless_diff_t cfg_diff(const store_cfg_t* c, int nradio, int nssid, const uint32_t* ids) {
+    bcml_wireless_diff_t d = { 0, 0 };
+    for (int i = 0; i < c->nradio || i < nradio; ++i) {
+        if (i >= c->nradio || i >= nradio || !ids[i] || c->item[i] != ids[i])
+            d.radios |= 1u << i;
+    }
+    for (int i = 0; i < c->nssid || i < nssid; ++i) {
+        if (i >= c->nssid || i >= nssid || !ids[nradio + i] || c->item[c->nradio + i] != ids[nradio + i])
+            d.ssids |= 1u << i;
+    }
+    return d;
+}
+
+size_t bcml_wireless_store_differ(const bcml_wireless_store_t* s, const bcml_wireless_cfg_t* profile,
+                                  unsigned* devices, bcml_wireless_diff_t* diffs, size_t max) {
+    uint8_t buf[WIRELESS_SSID_PACK_MAX];
+    uint32_t ids[STORE_ITEMS_MAX];
+    if (!s || !profile || profile->radio_count < 0 || profile->radio_count > BCML_RADIO_LIMIT ||
+        profile->ssid_count < 0 || profile->ssid_count > BCML_SSID_LIMIT)
+        return 0;
+
+    // Resolve the profile to ids without adding anything
+    int nradio = profile->radio_count, nssid = profile->ssid_count;
+    bool known = true;
+    uint64_t hash = wireless_count_hash(nradio, nssid);
+    for (int i = 0; i < nradio + nssid; ++i) {
+        bool radio = i < nradio;
+        int index = radio ? i : i - nradio;
+        item_key_t k;
+        k.section = radio ? WIRELESS_SECTION_RADIO : WIRELESS_SECTION_SSID;
+        k.len = (uint8_t)wireless_item_pack(k.section, radio ? (const void*)&profile->radio[index]
+                                                             : (const void*)&profile->ssid[index], buf);
+        k.data = buf;
+        ids[i] = item_find(s, &k);
+        known = known && ids[i];
+        hash += wireless_item_hash(k.section, index, buf, k.len);
+    }
+    cfg_key_t key = { nradio, nssid, ids };
+    uint32_t pid = known ? table_find(&s->configs, hash, cfg_matches, &key) : 0;
+
+    // Devices share configs, so each config's diff is worked out once
+    typedef struct {
+        bcml_wireless_diff_t diff;
+        bool done;
+    } diff_memo_t;
+    diff_memo_t* memo = diffs && max ? calloc(s->configs.n, sizeof(*memo)) : NULL;
+
+    size_t count = 0;
+    for (unsigned d = 0; d < s->ndevice; ++d) {
+        uint32_t id = s->device[d];
+        if (!id || id == pid)
+            continue;
+        if (count < max) {
+            devices[count] = d;
+            if (memo && !memo[id].done) {
+                memo[id].diff = cfg_diff(cfg_at(s, id), nradio, nssid, ids);
+                memo[id].done = true;
+            }
+            if (diffs)
+                diffs[count] = memo ? memo[id].diff : cfg_diff(cfg_at(s, id), nradio, nssid, ids);
+        }
+        ++count;
+    }
+    free(memo);
+    return count;
+}
+
+// Largest group first, then by lowest member
+static int group_cmp(const void* a, const void* b) {
+    const bcml_wireless_group_t* x = a;
+    const bcml_wireless_group_t* y = b;
+    if (x->devices != y->devices)
+        return x->devices < y->devices ? 1 : -1;
+    return (x->first > y->first) - (x->first < y->first);
+}
+
+size_t bcml_wireless_store_groups(const bcml_wireless_store_t* s, bcml_wireless_group_t* groups, size_t max) {
+    if (!s || !s->configs.live)
+        return 0;
+    size_t total = s->configs.live;
+    if (max == 0 || !groups)
+        return total;
+
+    // First member of each config, in one pass over the devices
+    unsigned* first = malloc(s->configs.n * sizeof(*first));
+    bcml_wireless_group_t* all = malloc(total * sizeof(*all));
+    if (!first || !all) {
+        free(first);
+        free(all);
+        return 0;
+    }
+    memset(first, 0xff, s->configs.n * sizeof(*first));
+    for (unsigned d = 0; d < s->ndevice; ++d) {
+        uint32_t id = s->device[d];
+        if (id && first[id] == (unsigned)-1)
+            first[id] = d;
+    }
+    size_t n = 0;
+    for (uint32_t id = 1; id < s->configs.n; ++id) {
+        const store_cfg_t* c = s->configs.entry[id];
+        if (!c)
+            continue;
+        all[n].config = id;
+        all[n].hash = c->hash;
+        all[n].devices = c->devices;
+        all[n].first = first[id];
+        ++n;
+    }
+    qsort(all, n, sizeof(*all), group_cmp);
+    memcpy(groups, all, (n < max ? n : max) * sizeof(*all));
+    free(first);
+    free(all);
+    return total;
+}
+
+void bcml_wireless_store_stats(const bcml_wireless_store_t* s, bcml_wireless_store_stats_t* stats) {
+    if (!stats)
+        return;
+    memset(stats, 0, sizeof(*stats));
+    if (!s)
+        return;
+    stats->devices = s->used;
+    stats->configs = s->configs.live;
+    stats->radios = s->radios;
+    stats->ssids = s->ssids;
+    stats->bytes = sizeof(*s) + s->entry_bytes + table_bytes(&s->items) + table_bytes(&s->configs) +
+                   s->ndevice * sizeof(*s->device);
+}
@@ -0,0 +1,73 @@
+#ifndef BCML_IPC_H
+#define BCML_IPC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+// Framed request/response protocol between bcmld and libbcml_client over a
+// Unix domain socket. Both ends run on the same host, so integers are in
+// native byte order.
+//
+// Frame: 12-byte header followed by `len` payload bytes.
+//   Request payload:  <type>\0<json>   (json empty for GET/PING;
+//                     ROLLBACK: <type>\0<generations in decimal>\0;
+//                     SET_BIN: <type>\0<CBOR>, GET_BIN: <type>\0)
+//   Response payload: GET: exported JSON (no terminator); GET_BIN: CBOR;
+//                     others: empty
+// Requests may be pipelined: a client can send any number of frames before
+// reading. Responses come back in request order and echo the request id.
+
+#ifndef BCMLD_SOCKET_PATH
+#define BCMLD_SOCKET_PATH "/var/run/bcml/bcmld.sock"
+#endif
+
+#define BCML_IPC_MAGIC        0xbc
+#define BCML_IPC_VERSION      1
+#define BCML_IPC_HDR_SIZE     12
+#define BCML_IPC_MAX_PAYLOAD  (1u << 20)
+
+typedef enum {
+    BCML_IPC_OP_SET = 1,
+    BCML_IPC_OP_GET = 2,
+    BCML_IPC_OP_PING = 3,
+    BCML_IPC_OP_ROLLBACK = 4,
+    BCML_IPC_OP_SET_BIN = 5,    // bcml_config_set_bin()
+    BCML_IPC_OP_GET_BIN = 6     // bcml_config_get_bin()
+} bcml_ipc_op_t;
+
+typedef enum {
+    BCML_IPC_OK = 0,
+    BCML_IPC_FAILED = 1,        // bcml_config_set/get/rollback(_bin) returned false
+    BCML_IPC_BAD_REQUEST = 2    // Unknown op or malformed payload
+} bcml_ipc_status_t;
+
+typedef struct {
+    uint8_t op;
+    uint8_t status;     // Responses only
+    uint32_t id;
+    uint32_t len;
+} bcml_ipc_hdr_t;
+
+static inline void bcml_ipc_put_hdr(uint8_t* out, const bcml_ipc_hdr_t* h) {
+    out[0] = BCML_IPC_MAGIC;
+    out[1] = BCML_IPC_VERSION;
+    out[2] = h->op;
+    out[3] = h->status;
+    memcpy(out + 4, &h->id, 4);
+    memcpy(out + 8, &h->len, 4);
+}
+
+// false if the bytes are not a frame header of this protocol version
+static inline bool bcml_ipc_get_hdr(const uint8_t* in, bcml_ipc_hdr_t* h) {
+    if (in[0] != BCML_IPC_MAGIC || in[1] != BCML_IPC_VERSION)
+        return false;
+    h->op = in[2];
+    h->status = in[3];
+    memcpy(&h->id, in + 4, 4);
+    memcpy(&h->len, in + 8, 4);
+    return h->len <= BCML_IPC_MAX_PAYLOAD;
+}
+
+#endif // BCML_IPC_H
@@ -1,9 +1,75 @@
 #include "rest_client.h"
 #include <curl/curl.h>
+#include <pthread.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdio.h>
+#include <strings.h>
 #include "bcml_log.h"
+#include "bcml_probe.h"
+
+// Idle easy handles. A handle keeps its connection cache, so reusing one
+// skips the TCP (and TLS) handshake of the next request to the same host.
+#define REST_POOL_SIZE 4
+
+static CURL *g_pool[REST_POOL_SIZE];
+static size_t g_pool_count;
+static bool g_global_inited;
+static pthread_mutex_t g_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+
+static CURL *rest_handle_get(void) {
+    CURL *curl = NULL;
+    pthread_mutex_lock(&g_pool_lock);
+    if (g_pool_count > 0)
+        curl = g_pool[--g_pool_count];
+    pthread_mutex_unlock(&g_pool_lock);
+    if (curl) {
+        curl_easy_reset(curl);
+        return curl;
+    }
+    return curl_easy_init();
+}
+
+static void rest_handle_put(CURL *curl) {
+    pthread_mutex_lock(&g_pool_lock);
+    if (g_pool_count < REST_POOL_SIZE) {
+        g_pool[g_pool_count++] = curl;
+        curl = NULL;
+    }
+    pthread_mutex_unlock(&g_pool_lock);
+    if (curl)
+        curl_easy_cleanup(curl);
+}
+
+bool rest_client_init(void) {
+    pthread_mutex_lock(&g_pool_lock);
+    bool ok = g_global_inited;
+    if (!ok) {
+        // Not thread-safe in older libcurl, hence done here rather than implicitly by curl_easy_init()
+        CURLcode res = curl_global_init(CURL_GLOBAL_DEFAULT);
+        if (res != CURLE_OK)
+            BCML_LOG_ERROR("rest_client_init: curl_global_init failed: %s\n", curl_easy_strerror(res));
+        ok = g_global_inited = res == CURLE_OK;
+    }
+    if (ok && g_pool_count == 0) {
+        CURL *curl = curl_easy_init();
+        if (curl)
+            g_pool[g_pool_count++] = curl;
+    }
+    pthread_mutex_unlock(&g_pool_lock);
+    return ok;
+}
+
+void rest_client_cleanup(void) {
+    pthread_mutex_lock(&g_pool_lock);
+    while (g_pool_count > 0)
+        curl_easy_cleanup(g_pool[--g_pool_count]);
+    if (g_global_inited) {
+        curl_global_cleanup();
+        g_global_inited = false;
+    }
+    pthread_mutex_unlock(&g_pool_lock);
+}
 
 struct memory {
     char *response;
@@ -21,17 +87,51 @@ static size_t write_callback(void *contents, size_t size, size_t nmemb, void *us
     return realsize;
 }
 
-bool rest_client_request(
+// Discard response body when the caller does not want it (libcurl writes to stdout by default)
+static size_t discard_callback(void *contents, size_t size, size_t nmemb, void *userp) {
+    (void)contents;
+    (void)userp;
+    return size * nmemb;
+}
+
+typedef struct {
+    char *etag;
+    size_t etag_size;
+} etag_capture_t;
+
+// Capture the ETag response header (value kept verbatim, including quotes)
+static size_t header_callback(char *buffer, size_t size, size_t nitems, void *userp) {
+    size_t len = size * nitems;
+    etag_capture_t *cap = (etag_capture_t *)userp;
+    if (len > 5 && strncasecmp(buffer, "ETag:", 5) == 0 && cap->etag_size > 0) {
+        const char *v = buffer + 5;
+        const char *end = buffer + len;
+        while (v < end && (*v == ' ' || *v == '\t')) v++;
+        while (end > v && (end[-1] == '\r' || end[-1] == '\n' || end[-1] == ' ')) end--;
+        size_t n = (size_t)(end - v);
+        if (n >= cap->etag_size) n = cap->etag_size - 1;
+        memcpy(cap->etag, v, n);
+        cap->etag[n] = '\0';
+    }
+    return len;
+}
+
+// Perform one request. Returns false on transport failure; *http_code holds the status otherwise.
+static bool rest_perform(
     rest_method_t method,
     const char *url,
     const char *json_body,
+    const char *if_none_match,
     char *response_buf,
-    size_t response_buf_size
+    size_t response_buf_size,
+    char *etag_out,
+    size_t etag_out_size,
+    long *http_code
 ) {
     BCML_LOG_DEBUG("rest_client_request: called. method=%d, url=%s, json_body=%p, response_buf=%p, response_buf_size=%zu\n", 
         method, url ? url : "(null)", json_body, response_buf, response_buf_size);
 
-    CURL *curl = curl_easy_init();
+    CURL *curl = rest_handle_get();
     if (!curl) {
         BCML_LOG_ERROR("rest_client_request: curl_easy_init failed!\n");
         return false;
@@ -40,7 +140,6 @@ bool rest_client_request(
     struct curl_slist *headers = NULL;
     CURLcode res;
     bool ret = false;
-    long http_code = 0;
 
     // cURL Method
     const char *method_str = NULL;
@@ -55,6 +154,12 @@ bool rest_client_request(
     BCML_LOG_DEBUG("rest_client_request: HTTP method set to %s\n", method_str);
 
     headers = curl_slist_append(headers, "Content-Type: application/json");
+    if (if_none_match && if_none_match[0]) {
+        char inm[REST_ETAG_MAX + 16];
+        snprintf(inm, sizeof(inm), "If-None-Match: %s", if_none_match);
+        headers = curl_slist_append(headers, inm);
+        BCML_LOG_DEBUG("rest_client_request: %s\n", inm);
+    }
     curl_easy_setopt(curl, CURLOPT_URL, url);
     curl_easy_setopt(curl, CURLOPT_CUSTOMREQUEST, method_str);
     curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
@@ -70,26 +175,77 @@ bool rest_client_request(
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, write_callback);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&chunk);
         BCML_LOG_DEBUG("rest_client_request: Write callback set for response.\n");
+    } else {
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_callback);
     }
 
+    etag_capture_t cap = { etag_out, etag_out ? etag_out_size : 0 };
+    if (cap.etag_size > 0) {
+        cap.etag[0] = '\0';
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, header_callback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, (void *)&cap);
+    }
+
+    BCML_PROBE3(rest__start, method_str, url, json_body && BCML_PROBE_ENABLED(rest__start) ? strlen(json_body) : 0);
     res = curl_easy_perform(curl);
     if (res == CURLE_OK) {
-        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
-        BCML_LOG_DEBUG("rest_client_request: curl_easy_perform OK, HTTP code: %ld\n", http_code);
-        ret = (http_code == 200);
-        // Copy response to buffer if needed
+        curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, http_code);
+        BCML_LOG_DEBUG("rest_client_request: curl_easy_perform OK, HTTP code: %ld\n", *http_code);
+        ret = true;
+        // Copy response to buffer if needed; a body that does not fit is an error, not a cut document
         if (response_buf && chunk.response) {
-            strncpy(response_buf, chunk.response, response_buf_size-1);
-            response_buf[response_buf_size-1] = '\0';
-            BCML_LOG_DEBUG("rest_client_request: Response copied to buffer. response=[%s]\n", response_buf);
+            if (chunk.size < response_buf_size) {
+                memcpy(response_buf, chunk.response, chunk.size + 1);
+                BCML_LOG_DEBUG("rest_client_request: Response copied to buffer. response=[%s]\n", response_buf);
+            } else {
+                BCML_LOG_ERROR("rest_client_request: response of %zu bytes exceeds buffer (%zu)\n",
+                               chunk.size, response_buf_size);
+                response_buf[0] = '\0';
+                ret = false;
+            }
         }
     } else {
         BCML_LOG_ERROR("rest_client_request: curl_easy_perform failed! CURLcode=%d, %s\n", res, curl_easy_strerror(res));
     }
+    BCML_PROBE3(rest__done, method_str, ret ? *http_code : 0L, chunk.size);
     free(chunk.response);
     curl_slist_free_all(headers);
-    curl_easy_cleanup(curl);
+    rest_handle_put(curl);
 
     BCML_LOG_DEBUG("rest_client_request: done. ret=%d\n", ret);
     return ret;
 }
+
+bool rest_client_request(
+    rest_method_t method,
+    const char *url,
+    const char *json_body,
+    char *response_buf,
+    size_t response_buf_size
+) {
+    long http_code = 0;
+    if (!rest_perform(method, url, json_body, NULL, response_buf, response_buf_size, NULL, 0, &http_code))
+        return false;
+    return (http_code == 200);
+}
+
+rest_cond_result_t rest_client_get_conditional(
+    const char *url,
+    char *etag,
+    size_t etag_size,
+    char *response_buf,
+    size_t response_buf_size
+) {
+    char new_etag[REST_ETAG_MAX] = {0};
+    long http_code = 0;
+    if (!rest_perform(REST_GET, url, NULL, etag, response_buf, response_buf_size,
+                      new_etag, sizeof(new_etag), &http_code))
+        return REST_COND_ERROR;
+    if (http_code == 304)
+        return REST_COND_NOT_MODIFIED;
+    if (http_code != 200)
+        return REST_COND_ERROR;
+    if (etag && etag_size > 0)
+        snprintf(etag, etag_size, "%s", new_etag);
+    return REST_COND_OK;
+}
@@ -22,5 +22,37 @@ bool rest_client_request(
     size_t response_buf_size // Size of response_buf
 );
 
+// Max ETag length kept by callers (including NUL)
+#define REST_ETAG_MAX 128
+
+typedef enum {
+    REST_COND_ERROR = -1,       // Transport failure or unexpected HTTP status
+    REST_COND_OK = 0,           // 200, new body in response_buf, etag updated
+    REST_COND_NOT_MODIFIED = 1  // 304, response_buf and etag untouched
+} rest_cond_result_t;
+
+// Conditional GET: sends "If-None-Match: <etag>" when etag is non-empty.
+// On 200 the response ETag (or "" if none) is stored back into etag.
+rest_cond_result_t rest_client_get_conditional(
+    const char *url,
+    char *etag,              // In: last ETag, out: new ETag
+    size_t etag_size,
+    char *response_buf,
+    size_t response_buf_size
+);
+
+// Transport setup ahead of the first request: libcurl global init and a
+// pooled handle (HTTP), or the kept-alive connection (UDS). Optional, requests
+// set up what they need lazily; cleanup releases it all and may be followed by
+// another init.
+bool rest_client_init(void);
+void rest_client_cleanup(void);
+
+#ifdef REST_UDS_ENABLE
+// Unix domain socket transport only: override the socket path (default REST_UDS_PATH).
+// Any kept-alive connection is closed and re-opened on the next request.
+void rest_client_uds_set_path(const char *path);
+#endif
+
 
 #endif // REST_CLIENT_H
\ No newline at end of file
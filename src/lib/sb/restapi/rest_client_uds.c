@@ -0,0 +1,427 @@
+#define _GNU_SOURCE // strcasestr, SOCK_CLOEXEC
+#include "rest_client.h"
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/uio.h>
+#include <sys/time.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <errno.h>
+#include <string.h>
+#include <strings.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include "bcml_log.h"
+#include "bcml_probe.h"
+
+// Minimal persistent HTTP/1.1 client over a Unix domain socket.
+// Drop-in replacement for the libcurl transport (rest_client.c), selected with REST_UDS_ENABLE.
+
+#ifndef REST_UDS_PATH
+#define REST_UDS_PATH "/var/run/bcml/rest.sock"
+#endif
+
+#ifndef REST_UDS_TIMEOUT_MS
+#define REST_UDS_TIMEOUT_MS 5000
+#endif
+
+#define UDS_RX_BUF_SIZE   4096
+#define UDS_HDR_BUF_SIZE  512
+#define UDS_LINE_MAX      1024
+
+typedef struct {
+    int fd;
+    char rx[UDS_RX_BUF_SIZE];   // Connection-owned read buffer
+    size_t rx_pos;
+    size_t rx_len;
+} uds_conn_t;
+
+static char g_sock_path[sizeof(((struct sockaddr_un*)0)->sun_path)] = REST_UDS_PATH;
+static uds_conn_t g_conn = { .fd = -1 };
+static pthread_mutex_t g_conn_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void rest_client_uds_set_path(const char *path) {
+    if (!path)
+        return;
+    pthread_mutex_lock(&g_conn_lock);
+    snprintf(g_sock_path, sizeof(g_sock_path), "%s", path);
+    if (g_conn.fd >= 0) {
+        close(g_conn.fd);
+        g_conn.fd = -1;
+    }
+    pthread_mutex_unlock(&g_conn_lock);
+}
+
+static void uds_close(uds_conn_t *c) {
+    if (c->fd >= 0)
+        close(c->fd);
+    c->fd = -1;
+    c->rx_pos = c->rx_len = 0;
+}
+
+static bool uds_connect(uds_conn_t *c) {
+    struct sockaddr_un addr;
+    struct timeval tv = { REST_UDS_TIMEOUT_MS / 1000, (REST_UDS_TIMEOUT_MS % 1000) * 1000 };
+
+    c->fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (c->fd < 0) {
+        BCML_LOG_ERROR("rest_client_uds: socket() failed: %s\n", strerror(errno));
+        return false;
+    }
+    setsockopt(c->fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(c->fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    memcpy(addr.sun_path, g_sock_path, sizeof(addr.sun_path));
+    if (connect(c->fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        BCML_LOG_ERROR("rest_client_uds: connect(%s) failed: %s\n", g_sock_path, strerror(errno));
+        uds_close(c);
+        return false;
+    }
+    c->rx_pos = c->rx_len = 0;
+    BCML_LOG_DEBUG("rest_client_uds: connected to %s\n", g_sock_path);
+    return true;
+}
+
+// Connect ahead of the first request. A server that is not up yet is not an
+// error: the first request connects again.
+bool rest_client_init(void) {
+    pthread_mutex_lock(&g_conn_lock);
+    if (g_conn.fd < 0)
+        uds_connect(&g_conn);
+    pthread_mutex_unlock(&g_conn_lock);
+    return true;
+}
+
+void rest_client_cleanup(void) {
+    pthread_mutex_lock(&g_conn_lock);
+    uds_close(&g_conn);
+    pthread_mutex_unlock(&g_conn_lock);
+}
+
+// Refill the read buffer; returns false on EOF or error.
+static bool uds_fill(uds_conn_t *c) {
+    ssize_t n;
+    do {
+        n = recv(c->fd, c->rx, sizeof(c->rx), 0);
+    } while (n < 0 && errno == EINTR);
+    if (n <= 0)
+        return false;
+    c->rx_pos = 0;
+    c->rx_len = (size_t)n;
+    return true;
+}
+
+// Read one CRLF-terminated line (CRLF stripped).
+static bool uds_read_line(uds_conn_t *c, char *line, size_t line_size) {
+    size_t len = 0;
+    for (;;) {
+        if (c->rx_pos == c->rx_len && !uds_fill(c))
+            return false;
+        char ch = c->rx[c->rx_pos++];
+        if (ch == '\n')
+            break;
+        if (len + 1 >= line_size)
+            return false;
+        line[len++] = ch;
+    }
+    if (len > 0 && line[len - 1] == '\r')
+        len--;
+    line[len] = '\0';
+    return true;
+}
+
+// Consume n body bytes, copying as much as fits into the caller buffer.
+// *dst_len counts every body byte, so it exceeds dst_cap when the body did not fit.
+static bool uds_read_body(uds_conn_t *c, size_t n, char *dst, size_t dst_cap, size_t *dst_len) {
+    while (n > 0) {
+        if (c->rx_pos == c->rx_len && !uds_fill(c))
+            return false;
+        size_t avail = c->rx_len - c->rx_pos;
+        size_t take = avail < n ? avail : n;
+        if (dst && *dst_len < dst_cap) {
+            size_t room = dst_cap - *dst_len;
+            size_t copy = take < room ? take : room;
+            memcpy(dst + *dst_len, c->rx + c->rx_pos, copy);
+        }
+        *dst_len += take;
+        c->rx_pos += take;
+        n -= take;
+    }
+    return true;
+}
+
+// Decode a chunked body straight into the caller buffer, including trailers.
+static bool uds_read_chunked(uds_conn_t *c, char *dst, size_t dst_cap, size_t *dst_len) {
+    char line[UDS_LINE_MAX];
+    for (;;) {
+        if (!uds_read_line(c, line, sizeof(line)))
+            return false;
+        char *end = NULL;
+        unsigned long chunk = strtoul(line, &end, 16);
+        if (end == line)
+            return false;
+        if (chunk == 0)
+            break;
+        if (!uds_read_body(c, chunk, dst, dst_cap, dst_len))
+            return false;
+        if (!uds_read_line(c, line, sizeof(line)) || line[0] != '\0')
+            return false;
+    }
+    // Skip trailer headers until the terminating empty line
+    do {
+        if (!uds_read_line(c, line, sizeof(line)))
+            return false;
+    } while (line[0] != '\0');
+    return true;
+}
+
+static bool uds_send_all(uds_conn_t *c, struct iovec *iov, int iovcnt) {
+    while (iovcnt > 0) {
+        struct msghdr msg = { .msg_iov = iov, .msg_iovlen = (size_t)iovcnt };
+        ssize_t n = sendmsg(c->fd, &msg, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        while (iovcnt > 0 && (size_t)n >= iov->iov_len) {
+            n -= (ssize_t)iov->iov_len;
+            iov++;
+            iovcnt--;
+        }
+        if (iovcnt > 0) {
+            iov->iov_base = (char*)iov->iov_base + n;
+            iov->iov_len -= (size_t)n;
+        }
+    }
+    return true;
+}
+
+// Strip "scheme://host[:port]" so only the request target is sent over the socket.
+static const char* uds_request_target(const char *url) {
+    const char *p = strstr(url, "://");
+    if (!p)
+        return url[0] ? url : "/";
+    p = strchr(p + 3, '/');
+    return p ? p : "/";
+}
+
+typedef enum {
+    UDS_OK,
+    UDS_ERR_STALE,  // Nothing received on a reused connection, safe to retry
+    UDS_ERR
+} uds_result_t;
+
+static uds_result_t uds_transact(uds_conn_t *c, const char *method_str, const char *target,
+                                 const char *json_body, const char *if_none_match,
+                                 char *response_buf, size_t response_buf_size,
+                                 char *etag_out, size_t etag_out_size, long *http_code) {
+    char hdr[UDS_HDR_BUF_SIZE];
+    char line[UDS_LINE_MAX];
+    size_t body_len = json_body ? strlen(json_body) : 0;
+    int hlen;
+
+    hlen = snprintf(hdr, sizeof(hdr), "%s %s HTTP/1.1\r\nHost: localhost\r\n", method_str, target);
+    if (hlen > 0 && (size_t)hlen < sizeof(hdr) && if_none_match && if_none_match[0])
+        hlen += snprintf(hdr + hlen, sizeof(hdr) - (size_t)hlen, "If-None-Match: %s\r\n", if_none_match);
+    if (hlen > 0 && (size_t)hlen < sizeof(hdr) && json_body)
+        hlen += snprintf(hdr + hlen, sizeof(hdr) - (size_t)hlen,
+                         "Content-Type: application/json\r\nContent-Length: %zu\r\n", body_len);
+    if (hlen > 0 && (size_t)hlen < sizeof(hdr))
+        hlen += snprintf(hdr + hlen, sizeof(hdr) - (size_t)hlen, "\r\n");
+    if (hlen < 0 || (size_t)hlen >= sizeof(hdr)) {
+        BCML_LOG_ERROR("rest_client_uds: request header too long\n");
+        return UDS_ERR;
+    }
+
+    struct iovec iov[2] = {
+        { .iov_base = hdr, .iov_len = (size_t)hlen },
+        { .iov_base = (void*)json_body, .iov_len = body_len },
+    };
+    if (!uds_send_all(c, iov, json_body ? 2 : 1))
+        return UDS_ERR_STALE;
+
+    // Status line, skipping any interim 1xx responses
+    int status = 0;
+    bool first = true;
+    do {
+        if (!uds_read_line(c, line, sizeof(line)))
+            return first ? UDS_ERR_STALE : UDS_ERR;
+        first = false;
+        if (sscanf(line, "HTTP/1.%*d %d", &status) != 1) {
+            BCML_LOG_ERROR("rest_client_uds: malformed status line '%s'\n", line);
+            return UDS_ERR;
+        }
+        if (status >= 100 && status < 200) {
+            do {
+                if (!uds_read_line(c, line, sizeof(line)))
+                    return UDS_ERR;
+            } while (line[0] != '\0');
+        }
+    } while (status >= 100 && status < 200);
+    *http_code = status;
+
+    // Headers
+    bool chunked = false, conn_close = false, has_length = false;
+    size_t content_length = 0;
+    for (;;) {
+        if (!uds_read_line(c, line, sizeof(line)))
+            return UDS_ERR;
+        if (line[0] == '\0')
+            break;
+        char *colon = strchr(line, ':');
+        if (!colon)
+            continue;
+        *colon = '\0';
+        char *value = colon + 1;
+        while (*value == ' ' || *value == '\t')
+            value++;
+        if (strcasecmp(line, "Content-Length") == 0) {
+            content_length = (size_t)strtoull(value, NULL, 10);
+            has_length = true;
+        } else if (strcasecmp(line, "Transfer-Encoding") == 0) {
+            chunked = (strcasestr(value, "chunked") != NULL);
+        } else if (strcasecmp(line, "Connection") == 0) {
+            conn_close = (strcasecmp(value, "close") == 0);
+        } else if (etag_out && etag_out_size > 0 && strcasecmp(line, "ETag") == 0) {
+            snprintf(etag_out, etag_out_size, "%s", value);
+        }
+    }
+
+    // Body, parsed directly into the caller buffer (one byte reserved for NUL)
+    size_t dst_cap = (response_buf && response_buf_size > 0) ? response_buf_size - 1 : 0;
+    size_t dst_len = 0;
+    bool ok = true;
+    if (status == 204 || status == 304 || strcmp(method_str, "HEAD") == 0) {
+        // No body
+    } else if (chunked) {
+        ok = uds_read_chunked(c, response_buf, dst_cap, &dst_len);
+    } else if (has_length) {
+        ok = uds_read_body(c, content_length, response_buf, dst_cap, &dst_len);
+    } else {
+        // Body delimited by connection close
+        while (ok) {
+            if (c->rx_pos == c->rx_len && !uds_fill(c))
+                break;
+            ok = uds_read_body(c, c->rx_len - c->rx_pos, response_buf, dst_cap, &dst_len);
+        }
+        conn_close = true;
+    }
+    if (response_buf && response_buf_size > 0 && status != 304)
+        response_buf[dst_len < dst_cap ? dst_len : dst_cap] = '\0';
+    if (!ok)
+        return UDS_ERR;
+    // A cut body would decode as garbage or fail later; the body was consumed,
+    // but report it as the transport error it is
+    if (response_buf && response_buf_size > 0 && dst_len > dst_cap) {
+        BCML_LOG_ERROR("rest_client_uds: response of %zu bytes exceeds buffer (%zu)\n", dst_len, response_buf_size);
+        response_buf[0] = '\0';
+        return UDS_ERR;
+    }
+
+    if (conn_close)
+        uds_close(c);
+    return UDS_OK;
+}
+
+// Perform one request. Returns false on transport failure; *http_code holds the status otherwise.
+static bool uds_perform(
+    rest_method_t method,
+    const char *url,
+    const char *json_body,
+    const char *if_none_match,
+    char *response_buf,
+    size_t response_buf_size,
+    char *etag_out,
+    size_t etag_out_size,
+    long *http_code
+) {
+    BCML_LOG_DEBUG("rest_client_request(uds): called. method=%d, url=%s, json_body=%p, response_buf=%p, response_buf_size=%zu\n",
+        method, url ? url : "(null)", json_body, response_buf, response_buf_size);
+
+    if (!url) {
+        BCML_LOG_ERROR("rest_client_request(uds): url is NULL\n");
+        return false;
+    }
+
+    const char *method_str = NULL;
+    switch (method) {
+        case REST_GET:    method_str = "GET"; break;
+        case REST_POST:   method_str = "POST"; break;
+        case REST_PUT:    method_str = "PUT"; break;
+        case REST_PATCH:  method_str = "PATCH"; break;
+        case REST_DELETE: method_str = "DELETE"; break;
+        default:          method_str = "GET"; break;
+    }
+    if (!(method == REST_POST || method == REST_PUT || method == REST_PATCH))
+        json_body = NULL;
+    if (etag_out && etag_out_size > 0)
+        etag_out[0] = '\0';
+
+    const char *target = uds_request_target(url);
+    uds_result_t res = UDS_ERR;
+
+    BCML_PROBE3(rest__start, method_str, url, json_body && BCML_PROBE_ENABLED(rest__start) ? strlen(json_body) : 0);
+    pthread_mutex_lock(&g_conn_lock);
+    // A kept-alive connection may have been closed by the server; retry once on a fresh one.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        bool reused = (g_conn.fd >= 0);
+        if (!reused && !uds_connect(&g_conn))
+            break;
+        res = uds_transact(&g_conn, method_str, target, json_body, if_none_match,
+                           response_buf, response_buf_size, etag_out, etag_out_size, http_code);
+        if (res != UDS_OK)
+            uds_close(&g_conn);
+        if (res != UDS_ERR_STALE || !reused)
+            break;
+        BCML_LOG_DEBUG("rest_client_request(uds): stale keep-alive connection, reconnecting\n");
+    }
+    pthread_mutex_unlock(&g_conn_lock);
+    BCML_PROBE3(rest__done, method_str, res == UDS_OK ? *http_code : 0L,
+                res == UDS_OK && response_buf && response_buf_size > 0 && *http_code != 304 && BCML_PROBE_ENABLED(rest__done) ?
+                    strlen(response_buf) : 0);
+
+    if (res != UDS_OK) {
+        BCML_LOG_ERROR("rest_client_request(uds): %s %s failed\n", method_str, target);
+        return false;
+    }
+
+    BCML_LOG_DEBUG("rest_client_request(uds): done. HTTP code: %ld\n", *http_code);
+    return true;
+}
+
+bool rest_client_request(
+    rest_method_t method,
+    const char *url,
+    const char *json_body,
+    char *response_buf,
+    size_t response_buf_size
+) {
+    long http_code = 0;
+    if (!uds_perform(method, url, json_body, NULL, response_buf, response_buf_size, NULL, 0, &http_code))
+        return false;
+    return (http_code == 200);
+}
+
+rest_cond_result_t rest_client_get_conditional(
+    const char *url,
+    char *etag,
+    size_t etag_size,
+    char *response_buf,
+    size_t response_buf_size
+) {
+    char new_etag[REST_ETAG_MAX];
+    long http_code = 0;
+    if (!uds_perform(REST_GET, url, NULL, etag, response_buf, response_buf_size,
+                     new_etag, sizeof(new_etag), &http_code))
+        return REST_COND_ERROR;
+    if (http_code == 304)
+        return REST_COND_NOT_MODIFIED;
+    if (http_code != 200)
+        return REST_COND_ERROR;
+    if (etag && etag_size > 0)
+        snprintf(etag, etag_size, "%s", new_etag);
+    return REST_COND_OK;
+}
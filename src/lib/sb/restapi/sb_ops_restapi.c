@@ -1,53 +1,108 @@
-#include "sb_ops.h"
+#include "sb_ops_restapi.h"
 #include "bcml_types.h"
+#include "bcml_wireless.h"
+#include <pthread.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <cjson/cJSON.h>
 #include "rest_client.h"
+#include "wireless_codec.h"
 #include "bcml_log.h"
 
 #define REST_API_BASE_URL "http://127.0.0.1:5566/v1/wlan/setting"
-#define WIRELESS_JSON_BUF_SIZE 4096
+// Largest GET body for a config at the BCML_*_LIMIT caps: per-item bounds
+// with room for the device's formatting, strings assumed fully \u-escaped
+#define WIRELESS_JSON_RADIO_MAX 512
+#define WIRELESS_JSON_SSID_MAX  (256 + 6 * (BCML_SSID_MAX_LEN + BCML_PASSWORD_MAX_LEN))
+#define WIRELESS_JSON_BUF_SIZE  (1024 + BCML_RADIO_LIMIT * WIRELESS_JSON_RADIO_MAX + \
+                                 BCML_SSID_LIMIT * WIRELESS_JSON_SSID_MAX)
 
-// REST API PATCH for wireless config (multiple SSID)
-static bool rest_set_wireless_config(const bcml_wireless_cfg_t* cfg) {
+// Content hashes of the sections last known to be on the device (sent or read back).
+// A section whose hash is unchanged is left out of the next PATCH.
+// g_wireless_lock guards these and the last GET result below; never held across a request.
+typedef struct {
+    bool radio_valid;
+    bool ssid_valid;
+    uint64_t radio;
+    uint64_t ssid;
+} rest_wireless_hash_t;
+
+static rest_wireless_hash_t g_wireless_hash;
+static pthread_mutex_t g_wireless_lock = PTHREAD_MUTEX_INITIALIZER;
+
+// Last decoded GET result and its ETag, reused when the device answers 304
+static bcml_wireless_cfg_t g_wireless_last;
+static char g_wireless_etag[REST_ETAG_MAX];
+static bool g_wireless_last_valid;
+
+static sb_get_status_t rest_get_wireless_config(const sb_ops_t* self, bcml_wireless_cfg_t* cfg);
+
+// Call with g_wireless_lock held
+static void rest_wireless_hash_update(const bcml_wireless_cfg_t* cfg, unsigned sections) {
+    if (sections & WIRELESS_SECTION_RADIO) {
+        g_wireless_hash.radio = wireless_section_hash(cfg, WIRELESS_SECTION_RADIO);
+        g_wireless_hash.radio_valid = true;
+    }
+    if (sections & WIRELESS_SECTION_SSID) {
+        g_wireless_hash.ssid = wireless_section_hash(cfg, WIRELESS_SECTION_SSID);
+        g_wireless_hash.ssid_valid = true;
+    }
+}
+
+// Sections whose hash differs from what we believe the device holds
+static unsigned rest_wireless_changed(uint64_t radio_hash, uint64_t ssid_hash) {
+    unsigned sections = 0;
+    pthread_mutex_lock(&g_wireless_lock);
+    if (!g_wireless_hash.radio_valid || g_wireless_hash.radio != radio_hash)
+        sections |= WIRELESS_SECTION_RADIO;
+    if (!g_wireless_hash.ssid_valid || g_wireless_hash.ssid != ssid_hash)
+        sections |= WIRELESS_SECTION_SSID;
+    pthread_mutex_unlock(&g_wireless_lock);
+    return sections;
+}
+
+// REST API PATCH for wireless config (radio + multiple SSID in one request)
+static bool rest_set_wireless_config(const sb_ops_t* self, const bcml_wireless_cfg_t* cfg) {
+    (void)self;
     BCML_LOG_DEBUG("rest_set_wireless_config: called with cfg=%p\n", cfg);
     if (!cfg) {
         BCML_LOG_WARN("rest_set_wireless_config: cfg is NULL\n");
         return false;
     }
 
-    cJSON *body = cJSON_CreateObject();
-
-    // Build SSID array
-    cJSON *ssid_array = cJSON_CreateArray();
-    for (int i = 0; i < MAX_SSID_NUM; ++i) {
-        const bcml_wireless_ssid_t *ssid_cfg = &cfg->ssid[i];
-        // Skip empty SSID entries
-        if (ssid_cfg->ssid[0] == '\0') continue;
-
-        cJSON *ssid_obj = cJSON_CreateObject();
-        cJSON_AddStringToObject(ssid_obj, "ssid", ssid_cfg->ssid);
-        cJSON_AddBoolToObject(ssid_obj, "hide", ssid_cfg->hide);
-        cJSON_AddNumberToObject(ssid_obj, "security", ssid_cfg->security);
-        cJSON_AddStringToObject(ssid_obj, "password", ssid_cfg->password);
-        cJSON_AddBoolToObject(ssid_obj, "password-onscreen", ssid_cfg->password_onscreen);
-        cJSON_AddBoolToObject(ssid_obj, "enable2g", ssid_cfg->enable2g);
-        cJSON_AddBoolToObject(ssid_obj, "enable5g", ssid_cfg->enable5g);
-        cJSON_AddBoolToObject(ssid_obj, "isolation", ssid_cfg->isolation);
-        cJSON_AddBoolToObject(ssid_obj, "hopping", ssid_cfg->hopping);
-        cJSON_AddItemToArray(ssid_array, ssid_obj);
-        BCML_LOG_DEBUG("rest_set_wireless_config: ssid[%d] added: ssid='%s', hide=%d, security=%d, password='%s', password-onscreen=%d, enable2g=%d, enable5g=%d, isolation=%d, hopping=%d\n",
-            i, ssid_cfg->ssid, ssid_cfg->hide, ssid_cfg->security, ssid_cfg->password, ssid_cfg->password_onscreen,
-            ssid_cfg->enable2g, ssid_cfg->enable5g, ssid_cfg->isolation, ssid_cfg->hopping);
+    // Only send the sections that differ from what the device already has
+    uint64_t radio_hash = wireless_section_hash(cfg, WIRELESS_SECTION_RADIO);
+    uint64_t ssid_hash = wireless_section_hash(cfg, WIRELESS_SECTION_SSID);
+    unsigned sections = rest_wireless_changed(radio_hash, ssid_hash);
+    if (sections == 0) {
+        // Our hashes only say what we last sent or read; the device may have been changed
+        // since (web UI, another client, reset). Re-read it (a 304 when the ETag still holds)
+        // before skipping, and send everything if that fails.
+        bcml_wireless_cfg_t current;
+        bcml_wireless_cfg_init(&current);
+        sb_get_status_t st = rest_get_wireless_config(self, &current);
+        bcml_wireless_cfg_free(&current);
+        sections = (st == SB_GET_FAILED) ? WIRELESS_SECTION_ALL
+                                         : rest_wireless_changed(radio_hash, ssid_hash);
+    }
+    if (sections == 0) {
+        BCML_LOG_INFO("rest_set_wireless_config: device already has this config, PATCH skipped\n");
+        return true;
     }
-    cJSON_AddItemToObject(body, "ssid", ssid_array);
-
-    // If you need to PATCH radio settings, add similar code here.
 
+    cJSON *body = wireless_cfg_to_json(cfg, sections, WIRELESS_KEYS_REST);
+    if (!body) {
+        BCML_LOG_ERROR("rest_set_wireless_config: failed to build request body\n");
+        return false;
+    }
     char *json_str = cJSON_PrintUnformatted(body);
-    BCML_LOG_DEBUG("rest_set_wireless_config: sending json: %s\n", json_str);
+    cJSON_Delete(body);
+    if (!json_str) {
+        BCML_LOG_ERROR("rest_set_wireless_config: cJSON_PrintUnformatted failed\n");
+        return false;
+    }
+    BCML_LOG_DEBUG("rest_set_wireless_config: sending sections=0x%x json: %s\n", sections, json_str);
 
     bool ret = rest_client_request(
         REST_PATCH,
@@ -56,101 +111,164 @@ static bool rest_set_wireless_config(const bcml_wireless_cfg_t* cfg) {
         NULL, 0
     );
     BCML_LOG_DEBUG("rest_set_wireless_config: rest_client_request returned %d\n", ret);
-
-    cJSON_Delete(body);
     free(json_str);
 
+    pthread_mutex_lock(&g_wireless_lock);
+    if (ret) {
+        rest_wireless_hash_update(cfg, sections);
+    } else {
+        // Device state of the sent sections is unknown now
+        if (sections & WIRELESS_SECTION_RADIO)
+            g_wireless_hash.radio_valid = false;
+        if (sections & WIRELESS_SECTION_SSID)
+            g_wireless_hash.ssid_valid = false;
+    }
+    pthread_mutex_unlock(&g_wireless_lock);
     return ret;
 }
 
-// REST API GET for wireless config (multiple SSID)
-static bool rest_get_wireless_config(bcml_wireless_cfg_t* cfg) {
+bool rest_decode_wireless_json(const char* body, bcml_wireless_cfg_t* cfg) {
+    if (!body || !cfg)
+        return false;
+
+#ifdef BCML_JSON_SCAN
+    json_scan_t scan;
+    json_cur_t cur;
+    bool ok;
+
+    json_scan_init(&scan);
+    ok = json_scan(&scan, body, strlen(body), JSON_SCAN_AUTO);
+    if (ok) {
+        json_cur_init(&cur, &scan);
+        // Missing arrays clear the corresponding entries; a non-object body clears everything
+        if (json_cur_peek(&cur) == '{') {
+            ok = wireless_cfg_from_scan(&cur, cfg, WIRELESS_SECTION_ALL, WIRELESS_KEYS_REST, false);
+        } else {
+            ok = json_cur_skip(&cur) && bcml_wireless_cfg_resize(cfg, 0, 0);
+        }
+        ok = ok && json_cur_at_end(&cur);
+    }
+    json_scan_free(&scan);
+    if (!ok) {
+        BCML_LOG_ERROR("rest_decode_wireless_json: Failed to parse JSON response\n");
+        return false;
+    }
+#else
+    cJSON *json = cJSON_Parse(body);
+    if (!json) {
+        BCML_LOG_ERROR("rest_decode_wireless_json: Failed to parse JSON response\n");
+        return false;
+    }
+
+    // Missing arrays clear the corresponding entries
+    wireless_cfg_from_json(json, cfg, WIRELESS_SECTION_ALL, WIRELESS_KEYS_REST);
+    cJSON_Delete(json);
+#endif
+
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        const bcml_wireless_radio_t *radio = &cfg->radio[i];
+        BCML_LOG_DEBUG("rest_decode_wireless_json: radio[%d] parsed: power=%d, channel2g=%d, channel5g=%d, bandwidth2g=%d, bandwidth5g=%d, dfs=%d, atf=%d, bandsteering=%d, zerowait=%d\n",
+            i, radio->power, radio->channel2g, radio->channel5g, radio->bandwidth2g, radio->bandwidth5g,
+            radio->dfs, radio->atf, radio->bandsteering, radio->zerowait);
+    }
+    for (int i = 0; i < cfg->ssid_count; ++i) {
+        const bcml_wireless_ssid_t *ssid_cfg = &cfg->ssid[i];
+        BCML_LOG_DEBUG("rest_decode_wireless_json: ssid[%d] parsed: ssid='%s', hide=%d, security=%d, password='%s', password-onscreen=%d, enable2g=%d, enable5g=%d, isolation=%d, hopping=%d\n",
+            i, ssid_cfg->ssid, ssid_cfg->hide, ssid_cfg->security, ssid_cfg->password, ssid_cfg->password_onscreen,
+            ssid_cfg->enable2g, ssid_cfg->enable5g, ssid_cfg->isolation, ssid_cfg->hopping);
+    }
+    return true;
+}
+
+// REST API GET for wireless config (radio + multiple SSID in one request)
+static sb_get_status_t rest_get_wireless_config(const sb_ops_t* self, bcml_wireless_cfg_t* cfg) {
+    (void)self;
     BCML_LOG_DEBUG("rest_get_wireless_config: called with cfg=%p\n", cfg);
     if (!cfg) {
         BCML_LOG_WARN("rest_get_wireless_config: cfg is NULL\n");
-        return false;
+        return SB_GET_FAILED;
     }
 
-    char response_buf[WIRELESS_JSON_BUF_SIZE] = {0};
-    bool ok = rest_client_request(
-        REST_GET,
+    char etag[REST_ETAG_MAX] = {0};
+    pthread_mutex_lock(&g_wireless_lock);
+    if (g_wireless_last_valid)
+        memcpy(etag, g_wireless_etag, sizeof(etag));
+    pthread_mutex_unlock(&g_wireless_lock);
+
+    // ~40 KB: too much for the stack of a caller's thread
+    char *response_buf = malloc(WIRELESS_JSON_BUF_SIZE);
+    if (!response_buf)
+        return SB_GET_FAILED;
+    response_buf[0] = '\0';
+    rest_cond_result_t res = rest_client_get_conditional(
         REST_API_BASE_URL,
-        NULL,
+        etag,
+        sizeof(etag),
         response_buf,
-        sizeof(response_buf)
+        WIRELESS_JSON_BUF_SIZE
     );
-    BCML_LOG_DEBUG("rest_get_wireless_config: rest_client_request returned %d, response_buf='%s'\n", ok, response_buf);
-    if (!ok) {
-        BCML_LOG_ERROR("rest_get_wireless_config: rest_client_request failed\n");
-        return false;
+    BCML_LOG_DEBUG("rest_get_wireless_config: rest_client_get_conditional returned %d, etag='%s', response_buf='%s'\n", res, etag, response_buf);
+    if (res == REST_COND_NOT_MODIFIED) {
+        free(response_buf);
+        pthread_mutex_lock(&g_wireless_lock);
+        // Another thread may have dropped or replaced the cached copy since we took its ETag
+        bool reused = g_wireless_last_valid && strcmp(g_wireless_etag, etag) == 0 &&
+                      bcml_wireless_cfg_copy(cfg, &g_wireless_last);
+        if (reused)
+            rest_wireless_hash_update(cfg, WIRELESS_SECTION_ALL);
+        pthread_mutex_unlock(&g_wireless_lock);
+        if (reused) {
+            BCML_LOG_DEBUG("rest_get_wireless_config: not modified, reusing last decoded config\n");
+            return SB_GET_NOT_MODIFIED;
+        }
+        BCML_LOG_ERROR("rest_get_wireless_config: 304 without a cached config\n");
+        return SB_GET_FAILED;
     }
-
-    cJSON *json = cJSON_Parse(response_buf);
-    if (!json) {
-        BCML_LOG_ERROR("rest_get_wireless_config: Failed to parse JSON response\n");
-        return false;
+    if (res != REST_COND_OK) {
+        BCML_LOG_ERROR("rest_get_wireless_config: rest_client_get_conditional failed\n");
+        free(response_buf);
+        return SB_GET_FAILED;
     }
 
-    // Parse SSID array
-    cJSON *ssid_array = cJSON_GetObjectItem(json, "ssid");
-    if (ssid_array && cJSON_IsArray(ssid_array)) {
-        int count = cJSON_GetArraySize(ssid_array);
-        BCML_LOG_DEBUG("rest_get_wireless_config: Found ssid array with %d elements\n", count);
-        for (int i = 0; i < MAX_SSID_NUM; ++i) {
-            if (i >= count) {
-                memset(&cfg->ssid[i], 0, sizeof(cfg->ssid[i]));
-                continue;
-            }
-            cJSON *item = cJSON_GetArrayItem(ssid_array, i);
-            bcml_wireless_ssid_t *ssid_cfg = &cfg->ssid[i];
-
-            cJSON *ssid = cJSON_GetObjectItem(item, "ssid");
-            cJSON *hide = cJSON_GetObjectItem(item, "hide");
-            cJSON *security = cJSON_GetObjectItem(item, "security");
-            cJSON *password = cJSON_GetObjectItem(item, "password");
-            cJSON *password_onscreen = cJSON_GetObjectItem(item, "password-onscreen");
-            cJSON *enable2g = cJSON_GetObjectItem(item, "enable2g");
-            cJSON *enable5g = cJSON_GetObjectItem(item, "enable5g");
-            cJSON *isolation = cJSON_GetObjectItem(item, "isolation");
-            cJSON *hopping = cJSON_GetObjectItem(item, "hopping");
-
-            if (ssid && cJSON_IsString(ssid))
-                strncpy(ssid_cfg->ssid, ssid->valuestring, sizeof(ssid_cfg->ssid));
-            else
-                ssid_cfg->ssid[0] = '\0';
-
-            ssid_cfg->hide = (hide && cJSON_IsBool(hide)) ? cJSON_IsTrue(hide) : false;
-            ssid_cfg->security = (security && cJSON_IsNumber(security)) ? security->valueint : 0;
-            if (password && cJSON_IsString(password))
-                strncpy(ssid_cfg->password, password->valuestring, sizeof(ssid_cfg->password));
-            else
-                ssid_cfg->password[0] = '\0';
-
-            ssid_cfg->password_onscreen = (password_onscreen && cJSON_IsBool(password_onscreen)) ? cJSON_IsTrue(password_onscreen) : false;
-            ssid_cfg->enable2g = (enable2g && cJSON_IsBool(enable2g)) ? cJSON_IsTrue(enable2g) : false;
-            ssid_cfg->enable5g = (enable5g && cJSON_IsBool(enable5g)) ? cJSON_IsTrue(enable5g) : false;
-            ssid_cfg->isolation = (isolation && cJSON_IsBool(isolation)) ? cJSON_IsTrue(isolation) : false;
-            ssid_cfg->hopping = (hopping && cJSON_IsBool(hopping)) ? cJSON_IsTrue(hopping) : false;
-
-            BCML_LOG_DEBUG("rest_get_wireless_config: ssid[%d] parsed: ssid='%s', hide=%d, security=%d, password='%s', password-onscreen=%d, enable2g=%d, enable5g=%d, isolation=%d, hopping=%d\n",
-                i, ssid_cfg->ssid, ssid_cfg->hide, ssid_cfg->security, ssid_cfg->password, ssid_cfg->password_onscreen,
-                ssid_cfg->enable2g, ssid_cfg->enable5g, ssid_cfg->isolation, ssid_cfg->hopping);
-        }
-    } else {
-        BCML_LOG_DEBUG("rest_get_wireless_config: 'ssid' array not found, clearing entries\n");
-        // If no ssid array, clear all entries
-        for (int i = 0; i < MAX_SSID_NUM; ++i)
-            memset(&cfg->ssid[i], 0, sizeof(cfg->ssid[i]));
+    bool decoded = rest_decode_wireless_json(response_buf, cfg);
+    free(response_buf);
+    pthread_mutex_lock(&g_wireless_lock);
+    if (!decoded) {
+        g_wireless_last_valid = false;
+        pthread_mutex_unlock(&g_wireless_lock);
+        return SB_GET_FAILED;
     }
 
-    // If you want to parse radio settings, add similar code here.
+    // What we just read is what the device has
+    rest_wireless_hash_update(cfg, WIRELESS_SECTION_ALL);
+    g_wireless_last_valid = bcml_wireless_cfg_copy(&g_wireless_last, cfg);
+    memcpy(g_wireless_etag, etag, sizeof(g_wireless_etag));
+    pthread_mutex_unlock(&g_wireless_lock);
 
-    cJSON_Delete(json);
-    BCML_LOG_DEBUG("rest_get_wireless_config: parsing complete, returning true\n");
-    return true;
+    BCML_LOG_DEBUG("rest_get_wireless_config: parsing complete, returning SB_GET_OK\n");
+    return SB_GET_OK;
+}
+
+static bool rest_init(const sb_ops_t* self) {
+    (void)self;
+    return rest_client_init();
+}
+
+// The device may change while we are down: forget what we believe it holds
+static void rest_shutdown(const sb_ops_t* self) {
+    (void)self;
+    rest_client_cleanup();
+    pthread_mutex_lock(&g_wireless_lock);
+    memset(&g_wireless_hash, 0, sizeof(g_wireless_hash));
+    g_wireless_last_valid = false;
+    bcml_wireless_cfg_free(&g_wireless_last);
+    pthread_mutex_unlock(&g_wireless_lock);
 }
 
-sb_ops_t sb = {
+const sb_ops_t sb_ops_restapi = {
+    .name = "restapi",
     .set_wireless_config = rest_set_wireless_config,
     .get_wireless_config = rest_get_wireless_config,
+    .init = rest_init,
+    .shutdown = rest_shutdown,
 };
\ No newline at end of file
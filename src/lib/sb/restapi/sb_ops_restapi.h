@@ -3,7 +3,10 @@
 
 #include "sb_ops.h"
 
-extern sb_ops_t sb;
+// REST API backend, registered as "restapi"
+extern const sb_ops_t sb_ops_restapi;
+// Decode a REST wireless GET body into cfg (radio + ssid arrays). Exposed for fuzzing.
+bool rest_decode_wireless_json(const char* body, bcml_wireless_cfg_t* cfg);
 // You can declare additional REST API-specific initialization or helper functions here if needed.
 
 #endif // SB_OPS_RESTAPI_H
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "sb_ops.h"
+#include "bcml_wireless.h"
+#include "bcml_log.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+// Composite southbound backends built on top of registered ones.
+// Each composite is an sb_ops_t whose priv points back to its own state.
+
+#define SB_CHAIN_NAME_MAX 32
+
+// ---- Write-through: set on primary and secondary, get from primary ----
+
+typedef struct {
+    sb_ops_t ops;
+    const sb_ops_t* primary;
+    const sb_ops_t* secondary;
+    char name[SB_CHAIN_NAME_MAX];
+} sb_writethrough_t;
+
+static bool wt_set_wireless_config(const sb_ops_t* self, const bcml_wireless_cfg_t* cfg) {
+    const sb_writethrough_t* wt = (const sb_writethrough_t*)self->priv;
+    if (!wt->primary->set_wireless_config || !wt->primary->set_wireless_config(wt->primary, cfg)) {
+        BCML_LOG_ERROR("[SB] %s: set on primary '%s' failed\n", wt->name, wt->primary->name);
+        return false;
+    }
+    if (!wt->secondary->set_wireless_config || !wt->secondary->set_wireless_config(wt->secondary, cfg)) {
+        BCML_LOG_ERROR("[SB] %s: set on secondary '%s' failed\n", wt->name, wt->secondary->name);
+        return false;
+    }
+    return true;
+}
+
+static sb_get_status_t wt_get_wireless_config(const sb_ops_t* self, bcml_wireless_cfg_t* cfg) {
+    const sb_writethrough_t* wt = (const sb_writethrough_t*)self->priv;
+    if (!wt->primary->get_wireless_config)
+        return SB_GET_FAILED;
+    return wt->primary->get_wireless_config(wt->primary, cfg);
+}
+
+// Both backends must hold the config, so the tighter limit of the two wins
+static bool wt_get_wireless_limits(const sb_ops_t* self, int* max_radio, int* max_ssid) {
+    const sb_writethrough_t* wt = (const sb_writethrough_t*)self->priv;
+    const sb_ops_t* backends[] = { wt->primary, wt->secondary };
+    bool known = false;
+    for (size_t i = 0; i < sizeof(backends) / sizeof(backends[0]); ++i) {
+        int r, s;
+        const sb_ops_t* b = backends[i];
+        if (!b->get_wireless_limits || !b->get_wireless_limits(b, &r, &s))
+            continue;
+        if (!known || r < *max_radio)
+            *max_radio = r;
+        if (!known || s < *max_ssid)
+            *max_ssid = s;
+        known = true;
+    }
+    return known;
+}
+
+bool bcml_sb_register_writethrough(const char* name, const char* primary, const char* secondary) {
+    if (!name || strlen(name) >= SB_CHAIN_NAME_MAX) {
+        BCML_LOG_ERROR("bcml_sb_register_writethrough: invalid name\n");
+        return false;
+    }
+    const sb_ops_t* p = bcml_sb_lookup(primary);
+    const sb_ops_t* s = bcml_sb_lookup(secondary);
+    if (!p || !s) {
+        BCML_LOG_ERROR("bcml_sb_register_writethrough: unknown backend '%s'\n", !p ? primary : secondary);
+        return false;
+    }
+
+    sb_writethrough_t* wt = calloc(1, sizeof(*wt));
+    if (!wt)
+        return false;
+    snprintf(wt->name, sizeof(wt->name), "%s", name);
+    wt->primary = p;
+    wt->secondary = s;
+    wt->ops.name = wt->name;
+    wt->ops.set_wireless_config = wt_set_wireless_config;
+    wt->ops.get_wireless_config = wt_get_wireless_config;
+    wt->ops.get_wireless_limits = wt_get_wireless_limits;
+    wt->ops.priv = wt;
+
+    if (!bcml_sb_register(&wt->ops)) {
+        free(wt);
+        return false;
+    }
+    return true;
+}
+
+// ---- Cache: remember the last set/get result in front of a slow backend ----
+
+typedef struct {
+    sb_ops_t ops;
+    const sb_ops_t* backing;
+    unsigned int max_age_ms;
+    pthread_mutex_t lock;
+    bool wireless_valid;
+    struct timespec wireless_stamp;
+    bcml_wireless_cfg_t wireless;
+    char name[SB_CHAIN_NAME_MAX];
+} sb_cache_t;
+
+static bool cache_fresh(const sb_cache_t* c, const struct timespec* stamp) {
+    if (c->max_age_ms == 0)
+        return true;
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    long long age_ms = (long long)(now.tv_sec - stamp->tv_sec) * 1000 +
+                       (now.tv_nsec - stamp->tv_nsec) / 1000000;
+    return age_ms < (long long)c->max_age_ms;
+}
+
+static void cache_store_wireless(sb_cache_t* c, const bcml_wireless_cfg_t* cfg) {
+    c->wireless_valid = bcml_wireless_cfg_copy(&c->wireless, cfg);
+    clock_gettime(CLOCK_MONOTONIC, &c->wireless_stamp);
+}
+
+static bool cache_set_wireless_config(const sb_ops_t* self, const bcml_wireless_cfg_t* cfg) {
+    sb_cache_t* c = (sb_cache_t*)self->priv;
+    if (!c->backing->set_wireless_config)
+        return false;
+
+    pthread_mutex_lock(&c->lock);
+    bool ok = c->backing->set_wireless_config(c->backing, cfg);
+    if (ok)
+        cache_store_wireless(c, cfg);
+    else
+        c->wireless_valid = false;
+    pthread_mutex_unlock(&c->lock);
+    return ok;
+}
+
+static sb_get_status_t cache_get_wireless_config(const sb_ops_t* self, bcml_wireless_cfg_t* cfg) {
+    sb_cache_t* c = (sb_cache_t*)self->priv;
+    sb_get_status_t status;
+
+    pthread_mutex_lock(&c->lock);
+    if (c->wireless_valid && cache_fresh(c, &c->wireless_stamp)) {
+        status = bcml_wireless_cfg_copy(cfg, &c->wireless) ? SB_GET_NOT_MODIFIED : SB_GET_FAILED;
+    } else if (!c->backing->get_wireless_config) {
+        status = SB_GET_FAILED;
+    } else {
+        status = c->backing->get_wireless_config(c->backing, cfg);
+        if (status == SB_GET_FAILED)
+            c->wireless_valid = false;
+        else
+            cache_store_wireless(c, cfg);
+    }
+    pthread_mutex_unlock(&c->lock);
+    return status;
+}
+
+static bool cache_get_wireless_limits(const sb_ops_t* self, int* max_radio, int* max_ssid) {
+    const sb_cache_t* c = (const sb_cache_t*)self->priv;
+    return c->backing->get_wireless_limits &&
+           c->backing->get_wireless_limits(c->backing, max_radio, max_ssid);
+}
+
+bool bcml_sb_register_cache(const char* name, const char* backing, unsigned int max_age_ms) {
+    if (!name || strlen(name) >= SB_CHAIN_NAME_MAX) {
+        BCML_LOG_ERROR("bcml_sb_register_cache: invalid name\n");
+        return false;
+    }
+    const sb_ops_t* b = bcml_sb_lookup(backing);
+    if (!b) {
+        BCML_LOG_ERROR("bcml_sb_register_cache: unknown backend '%s'\n", backing ? backing : "(null)");
+        return false;
+    }
+
+    sb_cache_t* c = calloc(1, sizeof(*c));
+    if (!c)
+        return false;
+    snprintf(c->name, sizeof(c->name), "%s", name);
+    c->backing = b;
+    c->max_age_ms = max_age_ms;
+    pthread_mutex_init(&c->lock, NULL);
+    c->ops.name = c->name;
+    c->ops.set_wireless_config = cache_set_wireless_config;
+    c->ops.get_wireless_config = cache_get_wireless_config;
+    c->ops.get_wireless_limits = cache_get_wireless_limits;
+    c->ops.priv = c;
+
+    if (!bcml_sb_register(&c->ops)) {
+        pthread_mutex_destroy(&c->lock);
+        free(c);
+        return false;
+    }
+    return true;
+}
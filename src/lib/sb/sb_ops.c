@@ -1,47 +1,212 @@
 #include "sb_ops.h" // Include southbound interface
 #include "bcml_log.h" // Include logging interface
+#include "bcml_wireless.h"
+#ifdef REST_API_ENABLE
+#include "restapi/sb_ops_restapi.h"
+#endif
+#ifdef UCI_API_ENABLE
+#include "uci/sb_ops_uci.h"
+#endif
+#include <pthread.h>
 #include <string.h>
+#include <strings.h>
 #include <stdio.h>
 
-extern sb_ops_t sb;
-
 // Adapter for wireless set
-static bool sb_wireless_set(const void* cfg) {
+static bool sb_wireless_set(const sb_ops_t* ops, const void* cfg) {
     const bcml_wireless_cfg_t* wcfg = (const bcml_wireless_cfg_t*)cfg;
-    if (!sb.set_wireless_config) {
-        printf("[SB] set_wireless_config is NULL!\n");
+    if (!ops || !ops->set_wireless_config) {
+        BCML_LOG_ERROR("[SB] set_wireless_config is NULL (backend=%s)!\n", ops ? ops->name : "(none)");
         return false;
     }
-    return sb.set_wireless_config(wcfg);
+    return ops->set_wireless_config(ops, wcfg);
 }
 
 // Adapter for wireless get
-static bool sb_wireless_get(void* cfg) {
+static sb_get_status_t sb_wireless_get(const sb_ops_t* ops, void* cfg) {
     bcml_wireless_cfg_t* wcfg = (bcml_wireless_cfg_t*)cfg;
-    if (!sb.get_wireless_config) {
-        printf("[SB] get_wireless_config is NULL!\n");
-        return false;
+    if (!ops || !ops->get_wireless_config) {
+        BCML_LOG_ERROR("[SB] get_wireless_config is NULL (backend=%s)!\n", ops ? ops->name : "(none)");
+        return SB_GET_FAILED;
     }
-    return sb.get_wireless_config(wcfg);
+    sb_get_status_t status = ops->get_wireless_config(ops, wcfg);
+    // The schema wants at least one radio; a device reporting none gets a default one,
+    // as the fixed four-radio config always exported before
+    if (status != SB_GET_FAILED && wcfg->radio_count == 0 &&
+        !bcml_wireless_cfg_resize(wcfg, 1, wcfg->ssid_count))
+        return SB_GET_FAILED;
+    return status;
 }
 
-const sb_ops_entry_t sb_ops_table[] = {
-    { "wireless", sb_wireless_set, sb_wireless_get },
-    // { "network", sb_network_set, sb_network_get },
-    // { "display", sb_display_set, sb_display_get },
+static sb_ops_entry_t sb_ops_table[] = {
+    { "wireless", sb_wireless_set, sb_wireless_get, NULL },
+    // { "network", sb_network_set, sb_network_get, NULL },
+    // { "display", sb_display_set, sb_display_get, NULL },
+};
+
+static const size_t sb_ops_table_size = sizeof(sb_ops_table) / sizeof(sb_ops_table[0]);
+
+// Backends compiled into the library; the first one is the default for every type
+static const sb_ops_t* const sb_builtin_backends[] = {
+#ifdef UCI_API_ENABLE
+    &sb_ops_uci,
+#endif
+#ifdef REST_API_ENABLE
+    &sb_ops_restapi,
+#endif
+    NULL
 };
 
-const size_t sb_ops_table_size = sizeof(sb_ops_table) / sizeof(sb_ops_table[0]);
+static const sb_ops_t* sb_registry[BCML_SB_MAX_BACKENDS];
+static size_t sb_registry_count;
+static pthread_mutex_t sb_registry_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t sb_registry_once = PTHREAD_ONCE_INIT;
+static bool sb_registry_inited[BCML_SB_MAX_BACKENDS];  // init hook ran, shutdown due
+
+static const sb_ops_t* sb_registry_lookup_locked(const char* name) {
+    for (size_t i = 0; i < sb_registry_count; ++i) {
+        if (strcmp(sb_registry[i]->name, name) == 0)
+            return sb_registry[i];
+    }
+    return NULL;
+}
+
+static bool sb_registry_add_locked(const sb_ops_t* ops) {
+    if (sb_registry_lookup_locked(ops->name)) {
+        BCML_LOG_ERROR("bcml_sb_register: backend '%s' already registered\n", ops->name);
+        return false;
+    }
+    if (sb_registry_count >= BCML_SB_MAX_BACKENDS) {
+        BCML_LOG_ERROR("bcml_sb_register: registry full, cannot add '%s'\n", ops->name);
+        return false;
+    }
+    sb_registry[sb_registry_count++] = ops;
+    BCML_LOG_DEBUG("bcml_sb_register: backend '%s' registered\n", ops->name);
+    return true;
+}
+
+static void sb_registry_init(void) {
+    pthread_mutex_lock(&sb_registry_lock);
+    for (size_t i = 0; sb_builtin_backends[i]; ++i)
+        sb_registry_add_locked(sb_builtin_backends[i]);
+    for (size_t i = 0; i < sb_ops_table_size; ++i)
+        __atomic_store_n(&sb_ops_table[i].ops, sb_builtin_backends[0], __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&sb_registry_lock);
+}
+
+bool bcml_sb_register(const sb_ops_t* ops) {
+    if (!ops || !ops->name) {
+        BCML_LOG_WARN("bcml_sb_register: invalid ops\n");
+        return false;
+    }
+    pthread_once(&sb_registry_once, sb_registry_init);
+
+    pthread_mutex_lock(&sb_registry_lock);
+    bool ok = sb_registry_add_locked(ops);
+    pthread_mutex_unlock(&sb_registry_lock);
+    return ok;
+}
+
+const sb_ops_t* bcml_sb_lookup(const char* name) {
+    if (!name)
+        return NULL;
+    pthread_once(&sb_registry_once, sb_registry_init);
 
-const sb_ops_entry_t* sb_ops_find(const char* type) {
+    pthread_mutex_lock(&sb_registry_lock);
+    const sb_ops_t* ops = sb_registry_lookup_locked(name);
+    pthread_mutex_unlock(&sb_registry_lock);
+    return ops;
+}
+
+// Device limits come from the selected backend; without them the schema limits apply
+static void sb_apply_wireless_limits(const sb_ops_t* ops) {
+    bcml_wireless_limits_t limits;
+    if (ops->get_wireless_limits && ops->get_wireless_limits(ops, &limits.max_radio, &limits.max_ssid)) {
+        if (bcml_wireless_set_limits(&limits))
+            return;
+        BCML_LOG_WARN("bcml_sb_select: backend '%s' reported unusable limits %d/%d\n",
+                      ops->name, limits.max_radio, limits.max_ssid);
+    }
+    bcml_wireless_set_limits(NULL);
+}
+
+bool bcml_sb_select(const char* type, const char* backend) {
+    const sb_ops_t* ops = bcml_sb_lookup(backend);
+    if (!ops) {
+        BCML_LOG_ERROR("bcml_sb_select: backend '%s' not registered\n", backend ? backend : "(null)");
+        return false;
+    }
+
+    bool found = false;
+    bool wireless = false;
+    pthread_mutex_lock(&sb_registry_lock);
+    for (size_t i = 0; i < sb_ops_table_size; ++i) {
+        if (!type || strcasecmp(type, sb_ops_table[i].type) == 0) {
+            // Lookups read it without the lock
+            __atomic_store_n(&sb_ops_table[i].ops, ops, __ATOMIC_RELEASE);
+            found = true;
+            wireless |= strcmp(sb_ops_table[i].type, "wireless") == 0;
+            BCML_LOG_INFO("bcml_sb_select: type '%s' -> backend '%s'\n", sb_ops_table[i].type, ops->name);
+        }
+    }
+    pthread_mutex_unlock(&sb_registry_lock);
+
+    if (wireless)
+        sb_apply_wireless_limits(ops);
+    if (!found)
+        BCML_LOG_ERROR("bcml_sb_select: unknown config type '%s'\n", type);
+    return found;
+}
+
+bool sb_ops_init(void) {
+    pthread_once(&sb_registry_once, sb_registry_init);
+
+    bool ok = true;
+    pthread_mutex_lock(&sb_registry_lock);
+    for (size_t i = 0; i < sb_registry_count; ++i) {
+        const sb_ops_t* ops = sb_registry[i];
+        if (!ops->init || sb_registry_inited[i])
+            continue;
+        if (!ops->init(ops)) {
+            BCML_LOG_ERROR("sb_ops_init: backend '%s' failed to initialize\n", ops->name);
+            ok = false;
+            continue;
+        }
+        sb_registry_inited[i] = true;
+    }
+    pthread_mutex_unlock(&sb_registry_lock);
+    return ok;
+}
+
+void sb_ops_shutdown(void) {
+    pthread_mutex_lock(&sb_registry_lock);
+    // Reverse registration order: composites registered later may sit on top of earlier backends
+    for (size_t i = sb_registry_count; i-- > 0;) {
+        if (!sb_registry_inited[i])
+            continue;
+        if (sb_registry[i]->shutdown)
+            sb_registry[i]->shutdown(sb_registry[i]);
+        sb_registry_inited[i] = false;
+    }
+    pthread_mutex_unlock(&sb_registry_lock);
+}
+
+bool sb_ops_find(const char* type, sb_ops_entry_t* entry) {
 
     BCML_LOG_DEBUG("sb_ops_find: searching for type='%s' in %zu entries\n", type ? type : "(null)", sb_ops_table_size);
-   
+    pthread_once(&sb_registry_once, sb_registry_init);
+
     for (size_t i = 0; i < sb_ops_table_size; ++i) {
-        if (strcasecmp(type, sb_ops_table[i].type) == 0)
-            return &sb_ops_table[i];
+        if (strcasecmp(type, sb_ops_table[i].type) == 0) {
+            // type/set/get never change; ops is swapped by bcml_sb_select()
+            entry->type = sb_ops_table[i].type;
+            entry->set = sb_ops_table[i].set;
+            entry->get = sb_ops_table[i].get;
+            entry->ops = __atomic_load_n(&sb_ops_table[i].ops, __ATOMIC_ACQUIRE);
+            return true;
+        }
     }
 
     BCML_LOG_WARN("sb_ops_find: No entry found for type '%s' \n", type ? type : "(null)");
-    return NULL;
-}
\ No newline at end of file
+    return false;
+}
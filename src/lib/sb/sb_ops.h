@@ -2,28 +2,35 @@
 #define SB_OPS_H
 
 #include "bcml_types.h"
+#include "bcml_sb.h"
 #include <stdbool.h>
 
-// sb_ops_t: Function pointers for all config types
-typedef struct {
-    bool (*set_wireless_config)(const bcml_wireless_cfg_t* cfg);
-    bool (*get_wireless_config)(bcml_wireless_cfg_t* cfg);
-    // Extend here for more config types
-    // bool (*set_network_config)(const bcml_network_cfg_t* cfg);
-    // bool (*get_network_config)(bcml_network_cfg_t* cfg);
-} sb_ops_t;
-
 // sb_ops_entry_t: Used for dispatching set/get by config type
 typedef struct {
     const char* type;
-    bool (*set)(const void* cfg);
-    bool (*get)(void* cfg);
+    bool (*set)(const sb_ops_t* ops, const void* cfg);
+    sb_get_status_t (*get)(const sb_ops_t* ops, void* cfg);
+    const sb_ops_t* ops;  // Backend currently selected for this type
 } sb_ops_entry_t;
 
-// Global sb, implemented by backend (extern, decided by linker)
-extern sb_ops_t sb;
+// Lookup function: copies the set/get entry for the specified config type into
+// entry, with the backend selected at this moment. Callers dispatch through
+// the copy, so a concurrent bcml_sb_select() only affects later lookups.
+bool sb_ops_find(const char* type, sb_ops_entry_t* entry);
+
+// Run the init hook of every registered backend not initialized yet; false if any fails
+bool sb_ops_init(void);
+
+// Run the shutdown hook of every backend sb_ops_init() initialized
+void sb_ops_shutdown(void);
+
+// Dispatch helpers
+static inline bool sb_entry_set(const sb_ops_entry_t* entry, const void* cfg) {
+    return entry->set(entry->ops, cfg);
+}
 
-// Lookup function, returns the set/get entry for the specified config type
-const sb_ops_entry_t* sb_ops_find(const char* type);
+static inline sb_get_status_t sb_entry_get(const sb_ops_entry_t* entry, void* cfg) {
+    return entry->get(entry->ops, cfg);
+}
 
-#endif // SB_OPS_H
\ No newline at end of file
+#endif // SB_OPS_H
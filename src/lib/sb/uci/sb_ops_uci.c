@@ -1,19 +1,71 @@
-#include "sb_ops.h"
+#include "sb_ops_uci.h"
+#include "bcml_wireless.h"
 #include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
 
-static bool uci_set_wireless_config(const bcml_wireless_cfg_t* cfg) {
-    printf("[UCI] set_wireless_config, ssid0=%s\n", cfg->ssid[0].ssid);
+#ifndef UCI_WIRELESS_CONFIG_PATH
+#define UCI_WIRELESS_CONFIG_PATH "/etc/config/wireless"
+#endif
+
+// Identity of the config file at the last successful read; unchanged identity => reuse last result
+typedef struct {
+    bool valid;
+    dev_t dev;
+    ino_t ino;
+    off_t size;
+    struct timespec mtime;
+    bcml_wireless_cfg_t cfg;
+} uci_file_cache_t;
+
+static uci_file_cache_t g_wireless_cache;
+
+static bool uci_file_unchanged(const uci_file_cache_t* cache, const struct stat* st) {
+    return cache->valid &&
+           cache->dev == st->st_dev &&
+           cache->ino == st->st_ino &&
+           cache->size == st->st_size &&
+           cache->mtime.tv_sec == st->st_mtim.tv_sec &&
+           cache->mtime.tv_nsec == st->st_mtim.tv_nsec;
+}
+
+static bool uci_set_wireless_config(const sb_ops_t* self, const bcml_wireless_cfg_t* cfg) {
+    (void)self;
+    printf("[UCI] set_wireless_config, ssid0=%s\n", cfg->ssid_count ? cfg->ssid[0].ssid : "");
     // real backend logic here
+    // The file is rewritten by a commit, but drop the cache in case mtime granularity hides it
+    g_wireless_cache.valid = false;
     return true;
 }
 
-static bool uci_get_wireless_config(bcml_wireless_cfg_t* cfg) {
+static sb_get_status_t uci_get_wireless_config(const sb_ops_t* self, bcml_wireless_cfg_t* cfg) {
+    (void)self;
+    struct stat st;
+    bool have_stat = (stat(UCI_WIRELESS_CONFIG_PATH, &st) == 0);
+
+    if (have_stat && uci_file_unchanged(&g_wireless_cache, &st)) {
+        return bcml_wireless_cfg_copy(cfg, &g_wireless_cache.cfg) ? SB_GET_NOT_MODIFIED : SB_GET_FAILED;
+    }
+
+    // Placeholder device: at least one radio and one SSID
+    if ((cfg->radio_count < 1 || cfg->ssid_count < 1) &&
+        !bcml_wireless_cfg_resize(cfg, cfg->radio_count ? cfg->radio_count : 1, cfg->ssid_count ? cfg->ssid_count : 1))
+        return SB_GET_FAILED;
     snprintf(cfg->ssid[0].ssid, sizeof(cfg->ssid[0].ssid), "uci_ssid");
-    return true;
+
+    g_wireless_cache.valid = have_stat && bcml_wireless_cfg_copy(&g_wireless_cache.cfg, cfg);
+    if (g_wireless_cache.valid) {
+        g_wireless_cache.dev = st.st_dev;
+        g_wireless_cache.ino = st.st_ino;
+        g_wireless_cache.size = st.st_size;
+        g_wireless_cache.mtime = st.st_mtim;
+    }
+    return SB_GET_OK;
 }
 
-// Global sb_ops_t instance, linker will resolve "sb"
-sb_ops_t sb = {
+// UCI backend instance, registered as "uci"
+const sb_ops_t sb_ops_uci = {
+    .name = "uci",
     .set_wireless_config = uci_set_wireless_config,
     .get_wireless_config = uci_get_wireless_config,
-};
\ No newline at end of file
+};
@@ -0,0 +1,9 @@
+#ifndef SB_OPS_UCI_H
+#define SB_OPS_UCI_H
+
+#include "sb_ops.h"
+
+// UCI backend, registered as "uci"
+extern const sb_ops_t sb_ops_uci;
+
+#endif // SB_OPS_UCI_H
\ No newline at end of file
@@ -1,6 +1,11 @@
 #include "validator_wireless.h"
+#include "bcml_types.h"
+#include "bcml_wireless.h"
 #include "bcml_log.h"
+#include "json_scan.h"
+#include "wireless_codec.h"
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <cjson/cJSON.h>
 
@@ -69,13 +74,13 @@ static int validate_ssid(const cJSON *ssid_item) {
 
     // Validate string fields
     const cJSON *ssid = cJSON_GetObjectItemCaseSensitive(ssid_item, "ssid");
-    if (!cJSON_IsString(ssid) || strlen(ssid->valuestring) == 0 || strlen(ssid->valuestring) > 64) {
+    if (!cJSON_IsString(ssid) || strlen(ssid->valuestring) == 0 || strlen(ssid->valuestring) > BCML_SSID_MAX_LEN) {
         BCML_LOG_WARN("validate_ssid: invalid ssid string\n");
         return 0;
     }
 
     const cJSON *password = cJSON_GetObjectItemCaseSensitive(ssid_item, "password");
-    if (!cJSON_IsString(password) || strlen(password->valuestring) > 64) {
+    if (!cJSON_IsString(password) || strlen(password->valuestring) > BCML_PASSWORD_MAX_LEN) {
         BCML_LOG_WARN("validate_ssid: invalid password string\n");
         return 0;
     }
@@ -109,10 +114,9 @@ static int validate_ssid(const cJSON *ssid_item) {
     return 1;
 }
 
-bool validate_wireless_json(const char* json, const char* schema_path) {
+bool validate_wireless_json_cjson(const char* json, const char* schema_path) {
     (void)schema_path; // Not used, as validation is hardcoded for now
 
-    BCML_LOG_DEBUG("validate_wireless_json: called. json=%p, schema_path=%s\n", json, schema_path ? schema_path : "(null)\n");
     if (!json) {
         BCML_LOG_ERROR("validate_wireless_json: json is NULL\n");
         return false;
@@ -139,8 +143,10 @@ bool validate_wireless_json(const char* json, const char* schema_path) {
         cJSON_Delete(root);
         return false;
     }
+    bcml_wireless_limits_t limits;
+    bcml_wireless_get_limits(&limits);
     int radio_count = cJSON_GetArraySize(radio);
-    if (radio_count < 1 || radio_count > 4) {
+    if (radio_count < 1 || radio_count > limits.max_radio) {
         BCML_LOG_ERROR("validate_wireless_json: 'radio' array size out of bounds: %d\n", radio_count);
         cJSON_Delete(root);
         return false;
@@ -161,7 +167,7 @@ bool validate_wireless_json(const char* json, const char* schema_path) {
         return false;
     }
     int ssid_count = cJSON_GetArraySize(ssid);
-    if (ssid_count < 1 || ssid_count > 4) {
+    if (ssid_count < 1 || ssid_count > limits.max_ssid) {
         BCML_LOG_ERROR("validate_wireless_json: 'ssid' array size out of bounds: %d\n", ssid_count);
         cJSON_Delete(root);
         return false;
@@ -194,3 +200,116 @@ bool validate_wireless_json(const char* json, const char* schema_path) {
     BCML_LOG_INFO("validate_wireless_json: validation successful\n");
     return true;
 }
+
+bool validate_wireless_json_scan(const char* json, const char* schema_path) {
+    (void)schema_path; // Not used, the schema lives in the wireless codec field tables
+
+    if (!json) {
+        BCML_LOG_ERROR("validate_wireless_json: json is NULL\n");
+        return false;
+    }
+
+    // Decode target, kept per thread so its block is reused across calls
+    static __thread bcml_wireless_cfg_t scratch;
+    json_scan_t scan;
+    json_cur_t cur;
+    char key[16];
+    size_t key_len;
+    bool first = true;
+    bool found = false;
+    bool ok = false;
+    int r;
+
+    json_scan_init(&scan);
+    if (!json_scan(&scan, json, strlen(json), JSON_SCAN_AUTO)) {
+        BCML_LOG_ERROR("validate_wireless_json: JSON parse error (malformed string or invalid UTF-8)\n");
+        goto out;
+    }
+
+    // Top-level: exactly one member, "wireless"
+    json_cur_init(&cur, &scan);
+    if (!json_cur_object_begin(&cur)) {
+        BCML_LOG_ERROR("validate_wireless_json: Root is not an object\n");
+        goto out;
+    }
+    while ((r = json_cur_member(&cur, &first, key, sizeof(key), &key_len)) == 1) {
+        if (found || key_len >= sizeof(key) || strcmp(key, "wireless") != 0) {
+            BCML_LOG_WARN("validate_wireless_json: Root object has unknown fields\n");
+            goto out;
+        }
+        found = true;
+        if (!wireless_cfg_from_scan(&cur, &scratch, WIRELESS_SECTION_ALL, WIRELESS_KEYS_NB, true)) {
+            BCML_LOG_ERROR("validate_wireless_json: Missing or invalid 'wireless' object\n");
+            goto out;
+        }
+    }
+    if (r < 0 || !json_cur_at_end(&cur)) {
+        BCML_LOG_ERROR("validate_wireless_json: JSON parse error\n");
+        goto out;
+    }
+    if (!found) {
+        BCML_LOG_ERROR("validate_wireless_json: Missing or invalid 'wireless' object\n");
+        goto out;
+    }
+
+    ok = true;
+    BCML_LOG_INFO("validate_wireless_json: validation successful\n");
+out:
+    json_scan_free(&scan);
+    return ok;
+}
+
+// maxItems of properties.wireless.properties.<name>, 0 if absent
+static int schema_max_items(const cJSON* wireless, const char* name) {
+    const cJSON* props = cJSON_GetObjectItemCaseSensitive(wireless, "properties");
+    const cJSON* array = cJSON_GetObjectItemCaseSensitive(props, name);
+    const cJSON* max = cJSON_GetObjectItemCaseSensitive(array, "maxItems");
+    return cJSON_IsNumber(max) ? max->valueint : 0;
+}
+
+bool bcml_wireless_limits_from_schema(const char* schema_path) {
+    if (!schema_path)
+        return false;
+    FILE* fp = fopen(schema_path, "rb");
+    if (!fp) {
+        BCML_LOG_DEBUG("bcml_wireless_limits_from_schema: cannot open %s\n", schema_path);
+        return false;
+    }
+    char* text = NULL;
+    long size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0 && (size = ftell(fp)) >= 0 && fseek(fp, 0, SEEK_SET) == 0 &&
+        (text = malloc((size_t)size + 1)) != NULL) {
+        size = (long)fread(text, 1, (size_t)size, fp);
+        text[size] = '\0';
+    }
+    fclose(fp);
+    if (!text)
+        return false;
+
+    cJSON* root = cJSON_Parse(text);
+    free(text);
+    const cJSON* props = cJSON_GetObjectItemCaseSensitive(root, "properties");
+    const cJSON* wireless = cJSON_GetObjectItemCaseSensitive(props, "wireless");
+    int max_radio = schema_max_items(wireless, "radio");
+    int max_ssid = schema_max_items(wireless, "ssid");
+    cJSON_Delete(root);
+    if (max_radio <= 0 && max_ssid <= 0) {
+        BCML_LOG_WARN("bcml_wireless_limits_from_schema: no maxItems in %s\n", schema_path);
+        return false;
+    }
+    // An array without maxItems keeps the default
+    bcml_wireless_limits_t limits = {
+        max_radio > 0 ? max_radio : MAX_RADIO_NUM,
+        max_ssid > 0 ? max_ssid : MAX_SSID_NUM
+    };
+    return bcml_wireless_set_schema_limits(&limits);
+}
+
+bool validate_wireless_json(const char* json, const char* schema_path) {
+    BCML_LOG_DEBUG("validate_wireless_json: called. json=%p, schema_path=%s\n", json, schema_path ? schema_path : "(null)\n");
+#ifdef BCML_JSON_SCAN
+    return validate_wireless_json_scan(json, schema_path);
+#else
+    return validate_wireless_json_cjson(json, schema_path);
+#endif
+}
@@ -6,4 +6,9 @@
 // Validate wireless JSON data, return true if valid, false otherwise
 bool validate_wireless_json(const char* json, const char* schema_path);
 
+// Implementations behind validate_wireless_json(), selected by BCML_JSON_SCAN.
+// The cJSON one is kept as the reference for differential fuzzing.
+bool validate_wireless_json_cjson(const char* json, const char* schema_path);
+bool validate_wireless_json_scan(const char* json, const char* schema_path);
+
 #endif // VALIDATOR_H
\ No newline at end of file
@@ -0,0 +1,225 @@
+#include "bcml_wireless.h"
+#include "bcml_types.h"
+#include "bcml_log.h"
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <strings.h>
+
+// Regulatory domains: which channels a radio may use, at which bandwidths, and
+// which of them need DFS. Rules follow wireless-regdb, reduced to what the
+// wireless data model can express (no power limits, no 6 GHz, channel 14 left out).
+// The rule tables are compiled once into per-country bitsets, indexed by
+// band/bandwidth/channel, so a check is a few bit tests.
+
+#define REGDOM_CHANNELS     192     // 5 GHz channel numbers end at 177
+#define REGDOM_WORDS        (REGDOM_CHANNELS / 64)
+#define REGDOM_MAX_RULES    6
+
+enum { BAND_2G, BAND_5G, BAND_COUNT };
+enum { BW_20, BW_40, BW_80, BW_160, BW_COUNT };
+
+static const int bw_mhz[BW_COUNT] = { 20, 40, 80, 160 };
+
+// Channels first..last (step 4 on 5 GHz, 1 on 2.4 GHz), usable up to max_bw MHz
+typedef struct {
+    uint8_t first;
+    uint8_t last;
+    uint8_t max_bw;
+    bool dfs;
+} regdom_rule_t;
+
+typedef struct {
+    const char* alpha2;
+    regdom_rule_t rules[BAND_COUNT][REGDOM_MAX_RULES];   // Terminated by last == 0
+} regdom_country_t;
+
+static const regdom_country_t regdom_countries[] = {
+    // World: the intersection of the domains below, so what it accepts is legal
+    // in all of them (CN has no 100-144, JP no 149-165, TW/KR stop at 80 MHz)
+    { "00", { { { 1, 11, 40, false } },
+              { { 36, 48, 80, false }, { 52, 64, 80, true } } } },
+    { "US", { { { 1, 11, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 144, 160, true }, { 149, 165, 80, false } } } },
+    { "CA", { { { 1, 11, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 144, 160, true }, { 149, 165, 80, false } } } },
+    { "TW", { { { 1, 11, 40, false } },
+              { { 36, 48, 80, false }, { 52, 64, 80, true }, { 100, 144, 160, true }, { 149, 165, 80, false } } } },
+    { "JP", { { { 1, 13, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 144, 160, true } } } },
+    { "CN", { { { 1, 13, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 149, 165, 80, false } } } },
+    { "KR", { { { 1, 13, 40, false } },
+              { { 36, 48, 80, false }, { 52, 64, 80, true }, { 100, 144, 160, true }, { 149, 165, 80, false } } } },
+    { "AU", { { { 1, 13, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 144, 160, true }, { 149, 165, 80, false } } } },
+    // ETSI
+    { "EU", { { { 1, 13, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 140, 160, true } } } },
+    { "DE", { { { 1, 13, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 140, 160, true } } } },
+    { "FR", { { { 1, 13, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 140, 160, true } } } },
+    { "GB", { { { 1, 13, 40, false } },
+              { { 36, 48, 160, false }, { 52, 64, 160, true }, { 100, 140, 160, true } } } },
+};
+
+#define REGDOM_COUNTRY_COUNT (sizeof(regdom_countries) / sizeof(regdom_countries[0]))
+
+typedef struct {
+    uint64_t valid[BAND_COUNT][BW_COUNT][REGDOM_WORDS];  // Primary channels usable at the width
+    uint64_t dfs[BW_COUNT][REGDOM_WORDS];                // 5 GHz: the channels spanned need DFS
+    uint8_t bw_mask[BAND_COUNT];                         // Widths usable on some channel
+} regdom_compiled_t;
+
+static regdom_compiled_t g_compiled[REGDOM_COUNTRY_COUNT];
+static pthread_once_t g_compiled_once = PTHREAD_ONCE_INIT;
+#define REGDOM_OFF SIZE_MAX
+static size_t g_country = REGDOM_OFF;   // Index into regdom_countries[]; no check until set
+
+static inline bool bit_test(const uint64_t* set, int ch) {
+    return (set[ch >> 6] >> (ch & 63)) & 1;
+}
+
+static inline void bit_set(uint64_t* set, int ch) {
+    set[ch >> 6] |= (uint64_t)1 << (ch & 63);
+}
+
+// Rule covering a channel, NULL if the channel is not allowed
+static const regdom_rule_t* rule_for(const regdom_rule_t* rules, int band, int ch) {
+    for (int i = 0; i < REGDOM_MAX_RULES && rules[i].last; ++i) {
+        if (ch >= rules[i].first && ch <= rules[i].last && (band == BAND_2G || (ch - rules[i].first) % 4 == 0))
+            return &rules[i];
+    }
+    return NULL;
+}
+
+// Channels spanned by a 5 GHz block: 20 MHz channel numbers are 4 apart and
+// blocks are aligned to channel 36 (lower bands) or 149 (upper band)
+static bool span_5g(const regdom_rule_t* rules, int ch, int bw, bool* dfs) {
+    int base = ch >= 149 ? 149 : 36;
+    int n = bw_mhz[bw] / 20;
+    if (ch < 36 || (ch - base) % 4 != 0)
+        return false;
+    int first = base + ((ch - base) / (4 * n)) * (4 * n);
+    *dfs = false;
+    for (int k = 0; k < n; ++k) {
+        const regdom_rule_t* r = rule_for(rules, BAND_5G, first + 4 * k);
+        if (!r || r->max_bw < bw_mhz[bw])
+            return false;
+        *dfs |= r->dfs;
+    }
+    return true;
+}
+
+// 2.4 GHz: 40 MHz takes the channel 4 above or below as secondary
+static bool span_2g(const regdom_rule_t* rules, int ch, int bw) {
+    const regdom_rule_t* r = rule_for(rules, BAND_2G, ch);
+    if (!r || r->max_bw < bw_mhz[bw])
+        return false;
+    if (bw == BW_20)
+        return true;
+    if (bw != BW_40)
+        return false;
+    const regdom_rule_t* up = ch + 4 < REGDOM_CHANNELS ? rule_for(rules, BAND_2G, ch + 4) : NULL;
+    const regdom_rule_t* down = ch > 4 ? rule_for(rules, BAND_2G, ch - 4) : NULL;
+    return (up && up->max_bw >= 40) || (down && down->max_bw >= 40);
+}
+
+static void compile_all(void) {
+    for (size_t c = 0; c < REGDOM_COUNTRY_COUNT; ++c) {
+        const regdom_country_t* country = &regdom_countries[c];
+        regdom_compiled_t* out = &g_compiled[c];
+        for (int bw = 0; bw < BW_COUNT; ++bw) {
+            for (int ch = 1; ch < REGDOM_CHANNELS; ++ch) {
+                bool dfs = false;
+                if (span_2g(country->rules[BAND_2G], ch, bw)) {
+                    bit_set(out->valid[BAND_2G][bw], ch);
+                    out->bw_mask[BAND_2G] |= 1u << bw;
+                }
+                if (span_5g(country->rules[BAND_5G], ch, bw, &dfs)) {
+                    bit_set(out->valid[BAND_5G][bw], ch);
+                    out->bw_mask[BAND_5G] |= 1u << bw;
+                    if (dfs)
+                        bit_set(out->dfs[bw], ch);
+                }
+            }
+        }
+    }
+}
+
+bool bcml_wireless_set_country(const char* alpha2) {
+    pthread_once(&g_compiled_once, compile_all);
+    if (!alpha2 || !*alpha2) {
+        g_country = REGDOM_OFF;
+        BCML_LOG_INFO("bcml_wireless_set_country: regulatory domain check off\n");
+        return true;
+    }
+    for (size_t c = 0; c < REGDOM_COUNTRY_COUNT; ++c) {
+        if (strcasecmp(alpha2, regdom_countries[c].alpha2) == 0) {
+            g_country = c;
+            BCML_LOG_INFO("bcml_wireless_set_country: regulatory domain %s\n", regdom_countries[c].alpha2);
+            return true;
+        }
+    }
+    BCML_LOG_ERROR("bcml_wireless_set_country: unknown country '%s'\n", alpha2);
+    return false;
+}
+
+const char* bcml_wireless_get_country(void) {
+    size_t c = g_country;
+    return c == REGDOM_OFF ? NULL : regdom_countries[c].alpha2;
+}
+
+// Width index of a bandwidth in MHz; 0 (auto) gives BW_COUNT, -1 if not a width
+static int bw_index(int mhz) {
+    if (mhz == 0)
+        return BW_COUNT;
+    for (int bw = 0; bw < BW_COUNT; ++bw) {
+        if (bw_mhz[bw] == mhz)
+            return bw;
+    }
+    return -1;
+}
+
+// One band of a radio; channel 0 and bandwidth 0 leave the choice to the driver
+static bool check_band(const regdom_compiled_t* rd, int band, int channel, int bandwidth, bool dfs, int index) {
+    const char* name = band == BAND_2G ? "2g" : "5g";
+    int bw = bw_index(bandwidth);
+    if (bw < 0 || (bw < BW_COUNT && !(rd->bw_mask[band] & (1u << bw)))) {
+        BCML_LOG_WARN("regdom: radio[%d] bandwidth%s %d not allowed in %s\n", index, name, bandwidth,
+                      bcml_wireless_get_country());
+        return false;
+    }
+    if (channel == 0)
+        return true;
+    // With automatic bandwidth the channel has to work at 20 MHz
+    int at = bw == BW_COUNT ? BW_20 : bw;
+    if (channel < 0 || channel >= REGDOM_CHANNELS || !bit_test(rd->valid[band][at], channel)) {
+        BCML_LOG_WARN("regdom: radio[%d] channel%s %d at %d MHz not allowed in %s\n", index, name, channel,
+                      bw_mhz[at], bcml_wireless_get_country());
+        return false;
+    }
+    if (band == BAND_5G && !dfs && bit_test(rd->dfs[at], channel)) {
+        BCML_LOG_WARN("regdom: radio[%d] channel5g %d at %d MHz needs dfs\n", index, channel, bw_mhz[at]);
+        return false;
+    }
+    return true;
+}
+
+bool bcml_wireless_regdom_check(const bcml_wireless_cfg_t* cfg) {
+    if (!cfg)
+        return false;
+    size_t c = g_country;
+    if (c == REGDOM_OFF)
+        return true;
+    pthread_once(&g_compiled_once, compile_all);
+    const regdom_compiled_t* rd = &g_compiled[c];
+    for (int i = 0; i < cfg->radio_count; ++i) {
+        const bcml_wireless_radio_t* r = &cfg->radio[i];
+        if (!check_band(rd, BAND_2G, r->channel2g, r->bandwidth2g, r->dfs, i) ||
+            !check_band(rd, BAND_5G, r->channel5g, r->bandwidth5g, r->dfs, i))
+            return false;
+    }
+    return true;
+}